@@ -40,6 +40,8 @@ public LeetClientPlugin(TargetInfo Target)
 				new string[]
 				{
 					// ... add private dependencies that you statically link with here ...
+					"Sockets",
+					"Networking"
 				}
 				);
 
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetApiDecoder.h"
+
+FThreadSafeCounter FLeetApiDecoder::NumPendingDecodes;
+
+TSharedPtr<FJsonObject> FLeetApiDecoder::ParseContent(const TArray<uint8>& Content)
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	if (Content.Num() == 0)
+	{
+		return JsonObject;
+	}
+
+	FUTF8ToTCHAR ContentTCHAR((const ANSICHAR*)Content.GetData(), Content.Num());
+	const FString JsonRaw(ContentTCHAR.Length(), ContentTCHAR.Get());
+	TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonRaw);
+	if (!FJsonSerializer::Deserialize(JsonReader, JsonObject))
+	{
+		JsonObject.Reset();
+	}
+	return JsonObject;
+}
+
+bool FLeetApiDecoder::WaitForPendingDecodes(double TimeoutSeconds)
+{
+	const double GiveUpTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (NumPendingDecodes.GetValue() > 0)
+	{
+		if (FPlatformTime::Seconds() >= GiveUpTime)
+		{
+			UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetApiDecoder] %d decodes still running after %.1fs"), NumPendingDecodes.GetValue(), TimeoutSeconds);
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	return true;
+}
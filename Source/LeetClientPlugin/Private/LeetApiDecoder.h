@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Http.h"
+#include "Json.h"
+#include "Async/Async.h"
+#include "LeetCompletionDispatcher.h"
+#include "LeetStats.h"
+#include "LeetTrace.h"
+
+/** Fields every Leet API answer carries, typed results derive from it */
+struct FLeetApiResult
+{
+	/** Body was a JSON object */
+	bool bParsed;
+	/** The API accepted the server's credentials */
+	bool bAuthorized;
+
+	FLeetApiResult()
+		: bParsed(false)
+		, bAuthorized(false)
+	{
+	}
+};
+
+/**
+ * Turns Leet API responses into typed results without touching the game thread.
+ *
+ * The body is copied out of the response on the calling thread, then converted, parsed and decoded on the task
+ * graph's worker threads.  Only the finished result travels back to the game thread, through the completion
+ * dispatcher's frame budget, so a large payload costs the frame a copy instead of a full JSON parse.
+ *
+ * A result type is made decodable by declaring, next to it:
+ *
+ *		void LeetDecodeApiResult(const FJsonObject& JsonObject, FMyResult& OutResult);
+ *
+ * It runs on a worker thread, so it must only fill in the result.
+ */
+class LEETCLIENTPLUGIN_API FLeetApiDecoder
+{
+public:
+
+	/**
+	 * Decodes a response in the background
+	 *
+	 * @param HttpResponse response to decode, must be valid
+	 * @param OnDecoded called on the game thread by FLeetCompletionDispatcher with the result, also when the body could not be parsed
+	 */
+	template <typename ResultType>
+	static void DecodeAsync(const FHttpResponsePtr& HttpResponse, TFunction<void(const ResultType&)> OnDecoded)
+	{
+		// The response isn't safe to share across threads, its bytes are
+		TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Content = MakeShareable(new TArray<uint8>(HttpResponse->GetContent()));
+		INC_MEMORY_STAT_BY(STAT_LeetDecodeMemory, Content->GetAllocatedSize());
+		NumPendingDecodes.Increment();
+		AsyncTask(ENamedThreads::AnyThread, [Content, OnDecoded]()
+		{
+			{
+				SCOPE_CYCLE_COUNTER(STAT_LeetJsonDecode);
+				FLeetTraceScope TraceScope(TEXT("JsonDecode"));
+				TSharedRef<ResultType, ESPMode::ThreadSafe> Result = MakeShareable(new ResultType());
+				TSharedPtr<FJsonObject> JsonObject = ParseContent(*Content);
+				if (JsonObject.IsValid())
+				{
+					Result->bParsed = true;
+					LeetDecodeApiResult(*JsonObject, *Result);
+				}
+				DEC_MEMORY_STAT_BY(STAT_LeetDecodeMemory, Content->GetAllocatedSize());
+				FLeetCompletionDispatcher::Get().Enqueue([Result, OnDecoded]()
+				{
+					OnDecoded(*Result);
+				});
+			}
+			// Outside the scope above, so the trace slice is closed too.  Module shutdown waits for this
+			NumPendingDecodes.Decrement();
+		});
+	}
+
+	/**
+	 * Decodes a response in the background and hands the result to a member of a UObject, unless the object
+	 * was destroyed in the meantime
+	 */
+	template <typename ResultType, typename OwnerType>
+	static void DecodeAsync(const FHttpResponsePtr& HttpResponse, OwnerType* Owner, void (OwnerType::*OnDecoded)(const ResultType&))
+	{
+		TWeakObjectPtr<OwnerType> WeakOwner(Owner);
+		DecodeAsync<ResultType>(HttpResponse, [WeakOwner, OnDecoded](const ResultType& Result)
+		{
+			if (OwnerType* LiveOwner = WeakOwner.Get())
+			{
+				(LiveOwner->*OnDecoded)(Result);
+			}
+		});
+	}
+
+	/** @return the body parsed as a JSON object, invalid if it isn't one */
+	static TSharedPtr<FJsonObject> ParseContent(const TArray<uint8>& Content);
+
+	/**
+	 * Waits for the decode tasks still running on worker threads.  Called on module shutdown before the singletons
+	 * they use are destroyed
+	 *
+	 * @param TimeoutSeconds longest time to wait
+	 * @return true if every task finished, false if some are still running after the timeout
+	 */
+	static bool WaitForPendingDecodes(double TimeoutSeconds);
+
+private:
+
+	/** Decode tasks started and not finished yet */
+	static FThreadSafeCounter NumPendingDecodes;
+};
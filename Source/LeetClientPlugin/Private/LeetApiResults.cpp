@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetApiResults.h"
+
+namespace
+{
+	bool GetOptionalBool(const FJsonObject& JsonObject, const TCHAR* Field)
+	{
+		bool Value = false;
+		JsonObject.TryGetBoolField(Field, Value);
+		return Value;
+	}
+
+	int32 GetOptionalInt(const FJsonObject& JsonObject, const TCHAR* Field)
+	{
+		int32 Value = 0;
+		JsonObject.TryGetNumberField(Field, Value);
+		return Value;
+	}
+
+	float GetOptionalFloat(const FJsonObject& JsonObject, const TCHAR* Field)
+	{
+		double Value = 0.0;
+		JsonObject.TryGetNumberField(Field, Value);
+		return (float)Value;
+	}
+
+	FString GetOptionalString(const FJsonObject& JsonObject, const TCHAR* Field)
+	{
+		FString Value;
+		JsonObject.TryGetStringField(Field, Value);
+		return Value;
+	}
+}
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetServerInfoResult& OutResult)
+{
+	OutResult.bAuthorized = GetOptionalBool(JsonObject, TEXT("authorization"));
+	OutResult.IncrementBTC = GetOptionalInt(JsonObject, TEXT("incrementBTC"));
+	OutResult.MinimumBTCHold = GetOptionalInt(JsonObject, TEXT("minimumBTCHold"));
+	OutResult.ServerRakeBTCPercentage = GetOptionalFloat(JsonObject, TEXT("serverRakeBTCPercentage"));
+	OutResult.LeetRakePercentage = GetOptionalFloat(JsonObject, TEXT("leetcoinRakePercentage"));
+}
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetServerLinksResult& OutResult)
+{
+	OutResult.bAuthorized = GetOptionalBool(JsonObject, TEXT("authorization"));
+	if (OutResult.bAuthorized)
+	{
+		// Reflection data is read only once the module is up, safe to walk from here
+		OutResult.bLinksConverted = FJsonObjectConverter::JsonAttributesToUStruct(JsonObject.Values, FLeetServerLinks::StaticStruct(), &OutResult.Links, 0, 0);
+	}
+}
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetPlayerActivationResult& OutResult)
+{
+	OutResult.bAuthorized = GetOptionalBool(JsonObject, TEXT("authorization"));
+	OutResult.bPlayerAuthorized = GetOptionalBool(JsonObject, TEXT("player_authorized"));
+	OutResult.PlatformID = GetOptionalString(JsonObject, TEXT("player_platformid"));
+	OutResult.PlayerName = GetOptionalString(JsonObject, TEXT("player_name"));
+	OutResult.PlayerKey = GetOptionalString(JsonObject, TEXT("player_key"));
+	OutResult.BTCHold = GetOptionalInt(JsonObject, TEXT("player_btchold"));
+	OutResult.Rank = GetOptionalInt(JsonObject, TEXT("player_rank"));
+	OutResult.GamePlayerKey = GetOptionalString(JsonObject, TEXT("game_player_member_key"));
+}
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetActivationBatchResult& OutResult)
+{
+	OutResult.bAuthorized = GetOptionalBool(JsonObject, TEXT("authorization"));
+
+	// Same per player fields as the single endpoint, one entry per activated player
+	const TArray<TSharedPtr<FJsonValue>>* PlayersJson = nullptr;
+	if (OutResult.bAuthorized && JsonObject.TryGetArrayField(TEXT("players"), PlayersJson))
+	{
+		OutResult.Players.Reserve(PlayersJson->Num());
+		for (int32 PlayerIdx = 0; PlayerIdx < PlayersJson->Num(); PlayerIdx++)
+		{
+			TSharedPtr<FJsonObject> PlayerJson = (*PlayersJson)[PlayerIdx]->AsObject();
+			if (PlayerJson.IsValid())
+			{
+				FLeetPlayerActivationResult& Player = OutResult.Players[OutResult.Players.AddDefaulted()];
+				LeetDecodeApiResult(*PlayerJson, Player);
+				Player.bParsed = true;
+				Player.bAuthorized = true;
+			}
+		}
+	}
+}
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetGamePlayerResult& OutResult)
+{
+	OutResult.bAuthorized = GetOptionalBool(JsonObject, TEXT("authorization"));
+	OutResult.PlatformID = GetOptionalString(JsonObject, TEXT("platformId"));
+	OutResult.PlayerKey = GetOptionalString(JsonObject, TEXT("playerKey"));
+}
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetApiStatusResult& OutResult)
+{
+	OutResult.bAuthorized = GetOptionalBool(JsonObject, TEXT("authorization"));
+}
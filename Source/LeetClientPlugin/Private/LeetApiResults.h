@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "LeetApiDecoder.h"
+
+/** /api/v2/server/info, economy values are 0 when the API left them out */
+struct FLeetServerInfoResult : public FLeetApiResult
+{
+	int32 IncrementBTC;
+	int32 MinimumBTCHold;
+	float ServerRakeBTCPercentage;
+	float LeetRakePercentage;
+
+	FLeetServerInfoResult()
+		: IncrementBTC(0)
+		, MinimumBTCHold(0)
+		, ServerRakeBTCPercentage(0.0f)
+		, LeetRakePercentage(0.0f)
+	{
+	}
+};
+
+/** /api/v2/server/links */
+struct FLeetServerLinksResult : public FLeetApiResult
+{
+	/** The links could be converted to the USTRUCT */
+	bool bLinksConverted;
+	FLeetServerLinks Links;
+
+	FLeetServerLinksResult()
+		: bLinksConverted(false)
+	{
+	}
+};
+
+/** Outcome of activating one player, standalone from /api/v2/player/<id>/activate or one entry of a batch */
+struct FLeetPlayerActivationResult : public FLeetApiResult
+{
+	bool bPlayerAuthorized;
+	FString PlatformID;
+	FString PlayerName;
+	FString PlayerKey;
+	int32 BTCHold;
+	int32 Rank;
+	FString GamePlayerKey;
+
+	FLeetPlayerActivationResult()
+		: bPlayerAuthorized(false)
+		, BTCHold(0)
+		, Rank(0)
+	{
+	}
+};
+
+/** /api/v2/players/activate */
+struct FLeetActivationBatchResult : public FLeetApiResult
+{
+	TArray<FLeetPlayerActivationResult> Players;
+};
+
+/** /api/v2/game/player/<key> */
+struct FLeetGamePlayerResult : public FLeetApiResult
+{
+	FString PlatformID;
+	FString PlayerKey;
+};
+
+/** Calls where only the status matters (deactivate, chat, match results) */
+struct FLeetApiStatusResult : public FLeetApiResult
+{
+};
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetServerInfoResult& OutResult);
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetServerLinksResult& OutResult);
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetPlayerActivationResult& OutResult);
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetActivationBatchResult& OutResult);
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetGamePlayerResult& OutResult);
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetApiStatusResult& OutResult);
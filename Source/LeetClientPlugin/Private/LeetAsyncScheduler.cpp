@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetAsyncScheduler.h"
+
+ILeetAsyncScheduler* ILeetAsyncScheduler::Registered = nullptr;
+
+void ILeetAsyncScheduler::Register(ILeetAsyncScheduler* Scheduler)
+{
+	check(IsInGameThread());
+	Registered = Scheduler;
+}
+
+void ILeetAsyncScheduler::Unregister(ILeetAsyncScheduler* Scheduler)
+{
+	check(IsInGameThread());
+	if (Registered == Scheduler)
+	{
+		Registered = nullptr;
+	}
+}
+
+bool ILeetAsyncScheduler::Schedule(const TSharedRef<IHttpRequest>& Request, const FHttpRequestCompleteDelegate& OnComplete, ELeetTaskPriority::Type Priority)
+{
+	check(IsInGameThread());
+	if (Registered)
+	{
+		return Registered->QueueHttpRequest(Request, OnComplete, Priority);
+	}
+	return FLeetHttpTransport::Get().ProcessRequest(Request, OnComplete);
+}
+
+int32 ILeetAsyncScheduler::GetNumPending()
+{
+	check(IsInGameThread());
+	return Registered ? Registered->GetNumUnfinishedHttpRequests() : 0;
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Http.h"
+
+/** Order in which queued Leet API calls are started */
+namespace ELeetTaskPriority
+{
+	enum Type
+	{
+		/** State changing calls the backend must see (match results, deactivations) */
+		High,
+		Normal,
+		/** Calls nothing waits on (chat relay) */
+		Low,
+
+		Num
+	};
+}
+
+/**
+ * Single scheduling point for Leet API calls.
+ *
+ * The online subsystem registers its async task manager here, so calls made by the plugin run as online async
+ * tasks without the plugin depending on the subsystem.  Until something is registered calls go straight to the
+ * transport.  Game thread only.
+ */
+class LEETCLIENTPLUGIN_API ILeetAsyncScheduler
+{
+public:
+
+	virtual ~ILeetAsyncScheduler() {}
+
+	/** Routes calls through the scheduler, replacing any previously registered one */
+	static void Register(ILeetAsyncScheduler* Scheduler);
+
+	/** Stops routing calls through the scheduler if it is the registered one */
+	static void Unregister(ILeetAsyncScheduler* Scheduler);
+
+	/**
+	 * Schedules a request built with FLeetHttpTransport::CreateRequest
+	 *
+	 * @param Request request to send
+	 * @param OnComplete called on the game thread once the request finished, with a null response if it never went out
+	 * @param Priority calls of higher priority are started first when more are queued than may run at once
+	 *
+	 * @return false if the request was rejected right away, OnComplete is not called then
+	 */
+	static bool Schedule(const TSharedRef<IHttpRequest>& Request, const FHttpRequestCompleteDelegate& OnComplete, ELeetTaskPriority::Type Priority = ELeetTaskPriority::Normal);
+
+	/** @return number of calls the registered scheduler has queued or out and not finished, 0 without one */
+	static int32 GetNumPending();
+
+protected:
+
+	/** Queues a request, see Schedule */
+	virtual bool QueueHttpRequest(const TSharedRef<IHttpRequest>& Request, const FHttpRequestCompleteDelegate& OnComplete, ELeetTaskPriority::Type Priority) = 0;
+
+	/** @return number of calls queued or out and not finished, see GetNumPending */
+	virtual int32 GetNumUnfinishedHttpRequests() const = 0;
+
+private:
+
+	/** Currently registered scheduler */
+	static ILeetAsyncScheduler* Registered;
+};
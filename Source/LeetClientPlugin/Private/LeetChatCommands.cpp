@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetChatCommands.h"
+
+namespace
+{
+	const TCHAR* NOT_ACTIVATED_REPLY = TEXT("Your Leet account isn't active on this server yet");
+
+	/** Longest command name looked up, well past any registered one and well short of NAME_SIZE */
+	const int32 MAX_COMMAND_NAME_LENGTH = 32;
+
+	/** @return number of distinct players the given player killed this round */
+	int32 CountVictims(const FLeetActivePlayer& Player)
+	{
+		int32 NumVictims = 0;
+		for (TConstSetBitIterator<> It(Player.KilledHandles); It; ++It)
+		{
+			NumVictims++;
+		}
+		return NumVictims;
+	}
+}
+
+FLeetChatCommands& FLeetChatCommands::Get()
+{
+	static FLeetChatCommands Instance;
+	return Instance;
+}
+
+FLeetChatCommands::FLeetChatCommands()
+{
+	RegisterBuiltInCommands();
+}
+
+void FLeetChatCommands::Register(const FString& Name, const FString& Help, const FLeetChatCommandHandler& Handler)
+{
+	FCommand& Command = Commands.Add(FName(*Name));
+	Command.Help = Help;
+	Command.Handler = Handler;
+}
+
+bool FLeetChatCommands::Execute(const FString& Line, FLeetChatCommandContext& Context, FString& OutReply) const
+{
+	FString Name = Line.Mid(1);
+	Context.Args.Empty();
+	int32 SpaceIdx = INDEX_NONE;
+	if (Name.FindChar(TEXT(' '), SpaceIdx))
+	{
+		Context.Args = Name.Mid(SpaceIdx + 1).Trim().TrimTrailing();
+		Name = Name.Left(SpaceIdx);
+	}
+
+	// Players can type anything, a name past NAME_SIZE would fail the FName check, so long names are never looked up
+	// (nor echoed back)
+	if (Name.Len() > MAX_COMMAND_NAME_LENGTH)
+	{
+		OutReply = TEXT("Unknown command, type /help for the list");
+		return false;
+	}
+
+	// Only names of registered commands can be found, don't add junk typed by players to the name table
+	const FName CommandName(*Name, FNAME_Find);
+	const FCommand* Command = CommandName != NAME_None ? Commands.Find(CommandName) : nullptr;
+	if (Command == nullptr)
+	{
+		OutReply = FString::Printf(TEXT("Unknown command /%s, type /help for the list"), *Name);
+		return false;
+	}
+
+	OutReply = Command->Handler(Context);
+	return true;
+}
+
+void FLeetChatCommands::RegisterBuiltInCommands()
+{
+	Register(TEXT("balance"), TEXT("your current balance"), [](const FLeetChatCommandContext& Context)
+	{
+		return Context.Player ? FString::Printf(TEXT("Balance: %d"), Context.Player->BTCHold) : FString(NOT_ACTIVATED_REPLY);
+	});
+
+	Register(TEXT("rank"), TEXT("your rank"), [](const FLeetChatCommandContext& Context)
+	{
+		return Context.Player ? FString::Printf(TEXT("Rank: %d"), Context.Player->Rank) : FString(NOT_ACTIVATED_REPLY);
+	});
+
+	Register(TEXT("kills"), TEXT("your kills this round"), [](const FLeetChatCommandContext& Context)
+	{
+		return Context.Player ? FString::Printf(TEXT("Kills: %d (%d different players)"), Context.Player->roundKills, CountVictims(*Context.Player)) : FString(NOT_ACTIVATED_REPLY);
+	});
+
+	Register(TEXT("stats"), TEXT("your round summary"), [](const FLeetChatCommandContext& Context)
+	{
+		if (Context.Player == nullptr)
+		{
+			return FString(NOT_ACTIVATED_REPLY);
+		}
+		const FLeetActivePlayer& Player = *Context.Player;
+		return FString::Printf(TEXT("%s - Kills: %d Deaths: %d Balance: %d Rank: %d"), *Player.playerTitle, Player.roundKills, Player.roundDeaths, Player.BTCHold, Player.Rank);
+	});
+
+	Register(TEXT("links"), TEXT("servers you can travel to from here"), [](const FLeetChatCommandContext& Context)
+	{
+		const TArray<FLeetServerLink>& Links = Context.ServerLinks.links;
+		if (Links.Num() == 0)
+		{
+			return FString(TEXT("No linked servers"));
+		}
+		FString Reply = TEXT("Links:");
+		for (int32 b = 0; b < Links.Num(); b++)
+		{
+			const FLeetServerLink& Link = Links[b];
+			const TCHAR* Status = !Link.targetStatusOnline ? TEXT("offline") : (Link.targetStatusFull ? TEXT("full") : TEXT("online"));
+			Reply += FString::Printf(TEXT(" %s (%s, %d to travel)%s"), *Link.targetServerTitle, Status, Link.btcCostToTravel, b + 1 < Links.Num() ? TEXT(",") : TEXT(""));
+		}
+		return Reply;
+	});
+
+	Register(TEXT("help"), TEXT("this list"), [this](const FLeetChatCommandContext& Context)
+	{
+		TArray<FString> Lines;
+		for (TMap<FName, FCommand>::TConstIterator It(Commands); It; ++It)
+		{
+			Lines.Add(FString::Printf(TEXT("/%s %s"), *It.Key().ToString(), *It.Value().Help));
+		}
+		Lines.Sort();
+		return FString::Join(Lines, TEXT(", "));
+	});
+}
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+struct FLeetActivePlayer;
+struct FLeetServerLinks;
+
+/** What a chat command gets to answer from, all of it already in memory on the server */
+struct FLeetChatCommandContext
+{
+	/** Registry record of the player who typed the command, null if the player isn't activated yet */
+	const FLeetActivePlayer* Player;
+	/** Last server links answered by the API */
+	const FLeetServerLinks& ServerLinks;
+	/** Whatever followed the command name, trimmed */
+	FString Args;
+
+	FLeetChatCommandContext(const FLeetActivePlayer* InPlayer, const FLeetServerLinks& InServerLinks)
+		: Player(InPlayer)
+		, ServerLinks(InServerLinks)
+	{
+	}
+};
+
+/** Builds the reply to a chat command */
+typedef TFunction<FString(const FLeetChatCommandContext&)> FLeetChatCommandHandler;
+
+/**
+ * Table of the slash commands players can type in chat.
+ *
+ * Commands are looked up by name in a hash map, so dispatch costs the same however many are registered.
+ * Handlers only read the context they are given and never call the API, the reply goes back to the player
+ * who asked and nobody else.
+ */
+class LEETCLIENTPLUGIN_API FLeetChatCommands
+{
+public:
+
+	/** @return the shared table, with the built in commands registered */
+	static FLeetChatCommands& Get();
+
+	/**
+	 * Adds or replaces a command
+	 *
+	 * @param Name command name without the slash, ie "balance"
+	 * @param Help one line description listed by /help
+	 * @param Handler builds the reply
+	 */
+	void Register(const FString& Name, const FString& Help, const FLeetChatCommandHandler& Handler);
+
+	/** @return true if the line looks like a command, the check is cheap enough to run on every line */
+	static bool IsCommand(const FString& Line) { return Line.StartsWith(TEXT("/")); }
+
+	/**
+	 * Runs the command typed on a chat line
+	 *
+	 * @param Line the whole chat line, starting with the slash
+	 * @param Context data the handler answers from, Args is filled in here
+	 * @param OutReply the reply for the player
+	 *
+	 * @return false if no such command is registered, OutReply says so
+	 */
+	bool Execute(const FString& Line, FLeetChatCommandContext& Context, FString& OutReply) const;
+
+private:
+
+	/** Hidden on purpose, use Get() */
+	FLeetChatCommands();
+
+	/** Registers /balance, /rank, /kills, /stats, /links and /help */
+	void RegisterBuiltInCommands();
+
+	struct FCommand
+	{
+		FString Help;
+		FLeetChatCommandHandler Handler;
+	};
+
+	/** Commands keyed by name, FName compares without case */
+	TMap<FName, FCommand> Commands;
+};
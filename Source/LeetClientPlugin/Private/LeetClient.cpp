@@ -8,9 +8,9 @@ ULeetClient * ULeetClient::_instance = nullptr;
 ULeetClient::ULeetClient(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Client CONSTRUCT"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Client CONSTRUCT"));
 	if (_instance == NULL) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Client CONSTRUCT _instance == NULL"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] Client CONSTRUCT _instance == NULL"));
 		_instance = this;
 		//_instance->AddToRoot();
 	}
@@ -38,7 +38,7 @@ void ULeetClient::initialize(FString api_url,
 	const FString& server_secret,
 	const FString& server_key)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Client INIT"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Client INIT"));
 	apiUrl = api_url;
 	serverSecret = server_secret;
 	serverKey = server_key;
@@ -46,9 +46,9 @@ void ULeetClient::initialize(FString api_url,
 
 ULeetClient * ULeetClient::getInstance()
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Client getInstance"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Client getInstance"));
 	if (_instance == NULL) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Client getInstance _instance == NULL"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] Client getInstance _instance == NULL"));
 	}
 	return _instance;
 }
@@ -1,7 +1,9 @@
 // Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
 
 #include "LeetClientPluginPrivatePCH.h"
+#include "LeetConsoleCommands.h"
 
+DEFINE_LOG_CATEGORY(LogLeet);
 
 class FLeetClientPlugin : public ILeetClientPlugin
 {
@@ -12,12 +14,21 @@ class FLeetClientPlugin : public ILeetClientPlugin
 
 IMPLEMENT_MODULE( FLeetClientPlugin, LeetClientPlugin )
 
+namespace
+{
+	/** Longest module shutdown waits for decode tasks still running */
+	const double DECODE_DRAIN_TIMEOUT_SECONDS = 5.0;
+}
+
 
 
 void FLeetClientPlugin::StartupModule()
 {
 	// This code will execute after your module is loaded into memory (but after global variables are initialized, of course.)
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Client Startup"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Client Startup"));
+	FLeetTrace::Startup();
+	FLeetMetrics::Startup();
+	FLeetCompletionDispatcher::Startup();
 }
 
 
@@ -25,6 +36,17 @@ void FLeetClientPlugin::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Client Shutdown"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Client Shutdown"));
+	FLeetConsoleCommands::Shutdown();
+	FLeetHttpTransport::Shutdown();
+
+	// Decode tasks on the workers still use the dispatcher and the trace, those are only destroyed once they are done.
+	// Should some be stuck, both are left behind rather than freed under them
+	if (FLeetApiDecoder::WaitForPendingDecodes(DECODE_DRAIN_TIMEOUT_SECONDS))
+	{
+		FLeetCompletionDispatcher::Shutdown();
+		FLeetTrace::Shutdown();
+	}
+	FLeetMetrics::Shutdown();
 }
 
@@ -3,15 +3,27 @@
 #include "Engine.h"
 #include "Core.h"
 #include "ILeetClientPlugin.h"
+#include "LeetLog.h"
+#include "LeetStats.h"
 //#include "ModuleManager.h"
 #include "Internationalization.h"
 //#include "LeetGameInstance.h"
 #include "Online.h"
+#include "LeetHttpTransport.h"
+#include "LeetJournal.h"
+#include "LeetCompletionDispatcher.h"
+#include "LeetMetrics.h"
+#include "LeetTrace.h"
+#include "LeetApiDecoder.h"
+#include "LeetAsyncScheduler.h"
 #include "LeetOnlineGameSettings.h"
 #include "LeetGameSession.h"
 #include "LeetGameInstance.h"
+#include "LeetApiResults.h"
 #include "LeetGameMode.h"
 #include "LeetPlayerState.h"
+#include "LeetGameState.h"
+#include "LeetChatCommands.h"
 
 // You should place include statements to your module's private header files here.  You only need to
 // add includes for headers that are used in most of your module's source files though.
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetCompletionDispatcher.h"
+
+FLeetCompletionDispatcher* FLeetCompletionDispatcher::Instance = nullptr;
+
+const float FLeetCompletionDispatcher::DEFAULT_FRAME_BUDGET_MS = 2.0f;
+
+void FLeetCompletionDispatcher::Startup()
+{
+	check(IsInGameThread());
+	if (Instance == nullptr)
+	{
+		Instance = new FLeetCompletionDispatcher();
+	}
+}
+
+FLeetCompletionDispatcher& FLeetCompletionDispatcher::Get()
+{
+	// Decoders call this from worker threads, so the dispatcher is never created here
+	check(Instance != nullptr);
+	return *Instance;
+}
+
+void FLeetCompletionDispatcher::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FLeetCompletionDispatcher::FLeetCompletionDispatcher()
+	: FrameBudgetSeconds(DEFAULT_FRAME_BUDGET_MS / 1000.0)
+	, PeakQueued(0)
+	, LastFrameMs(0.0f)
+	, LastFrameNumRun(0)
+	, NumOverBudgetFrames(0)
+	, TotalNumRun(0)
+	, TotalSeconds(0.0)
+{
+}
+
+bool FLeetCompletionDispatcher::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetCompletionDispatch);
+	LastFrameMs = 0.0f;
+	LastFrameNumRun = 0;
+
+	const int32 NumWaiting = NumQueued.GetValue();
+	SET_DWORD_STAT(STAT_LeetCompletionQueueDepth, NumWaiting);
+	if (NumWaiting == 0)
+	{
+		return true;
+	}
+	PeakQueued = FMath::Max(PeakQueued, NumWaiting);
+	FLeetTraceScope TraceScope(TEXT("CompletionDispatch"));
+
+	// Only what was queued before this tick runs, work queued by the work itself waits for the next frame
+	const double StartTime = FPlatformTime::Seconds();
+	double Elapsed = 0.0;
+	TFunction<void()> Work;
+	while (LastFrameNumRun < NumWaiting && (LastFrameNumRun == 0 || Elapsed < FrameBudgetSeconds) && Queue.Dequeue(Work))
+	{
+		NumQueued.Decrement();
+		Work();
+		LastFrameNumRun++;
+		Elapsed = FPlatformTime::Seconds() - StartTime;
+	}
+
+	LastFrameMs = Elapsed * 1000.0;
+	TotalNumRun += LastFrameNumRun;
+	TotalSeconds += Elapsed;
+
+	if (LastFrameNumRun < NumWaiting)
+	{
+		NumOverBudgetFrames++;
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [FLeetCompletionDispatcher] Ran %d in %.2fms, %d roll over to the next frame"), LastFrameNumRun, LastFrameMs, NumQueued.GetValue());
+	}
+
+	return true;
+}
+
+void FLeetCompletionDispatcher::SetFrameBudget(float InFrameBudgetMs)
+{
+	FrameBudgetSeconds = FMath::Max(0.0f, InFrameBudgetMs) / 1000.0;
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetCompletionDispatcher] SetFrameBudget %.2fms"), InFrameBudgetMs);
+}
+
+void FLeetCompletionDispatcher::Enqueue(TFunction<void()> Work)
+{
+	// Counted first, the game thread may dequeue the item before this call returns
+	NumQueued.Increment();
+	Queue.Enqueue(Work);
+}
+
+void FLeetCompletionDispatcher::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet completions: %d queued (peak %d), budget %.2fms, last frame %d in %.2fms, %d frames over budget, %d run in %.1fms total"),
+		NumQueued.GetValue(), PeakQueued, FrameBudgetSeconds * 1000.0, LastFrameNumRun, LastFrameMs, NumOverBudgetFrames, TotalNumRun, TotalSeconds * 1000.0);
+}
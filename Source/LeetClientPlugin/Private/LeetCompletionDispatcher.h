@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Ticker.h"
+#include "Containers/Queue.h"
+
+/**
+ * Runs the game thread side of Leet API completions under a per-frame time budget.
+ *
+ * Decoded results are queued here instead of being applied as soon as they arrive.  Every tick the queue is
+ * drained in order until the frame's budget is spent, whatever is left rolls over to the next frame, so a burst
+ * of answers (activations after a travel) is spread over a few frames instead of spiking a single one.
+ * At least one item runs per tick so the queue always drains.
+ */
+class LEETCLIENTPLUGIN_API FLeetCompletionDispatcher : public FTickerObjectBase
+{
+public:
+
+	/** Default time completion work may take per frame, in milliseconds */
+	static const float DEFAULT_FRAME_BUDGET_MS;
+
+	/** Creates the shared dispatcher.  Its ticker registers on the game thread, so this is called from module startup */
+	static void Startup();
+
+	/** @return the dispatcher shared by every Leet module, safe to call from any thread between Startup and Shutdown */
+	static FLeetCompletionDispatcher& Get();
+
+	/** Destroys the shared dispatcher, dropping anything still queued.  Called on module shutdown */
+	static void Shutdown();
+
+	// FTickerObjectBase
+
+	virtual bool Tick(float DeltaTime) override;
+
+	// FLeetCompletionDispatcher
+
+	/** Sets the time completion work may take per frame, in milliseconds */
+	void SetFrameBudget(float InFrameBudgetMs);
+
+	/**
+	 * Queues work to run on the game thread, safe to call from any thread
+	 *
+	 * @param Work function to run, must check itself whether what it touches is still alive
+	 */
+	void Enqueue(TFunction<void()> Work);
+
+	/** @return number of items waiting to run */
+	int32 GetNumQueued() const { return NumQueued.GetValue(); }
+
+	/** @return most items that were waiting at the start of a tick */
+	int32 GetPeakQueued() const { return PeakQueued; }
+
+	/** @return time spent running work on the last tick, in milliseconds */
+	float GetLastFrameMs() const { return LastFrameMs; }
+
+	/** @return number of items run on the last tick */
+	int32 GetLastFrameNumRun() const { return LastFrameNumRun; }
+
+	/** @return number of ticks that ran out of budget with work left */
+	int32 GetNumOverBudgetFrames() const { return NumOverBudgetFrames; }
+
+	/** Writes the queue depth and time spent to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+
+	/** Hidden on purpose, use Get() */
+	FLeetCompletionDispatcher();
+
+	/** Work waiting for the game thread, filled from the decoder's worker threads */
+	TQueue<TFunction<void()>, EQueueMode::Mpsc> Queue;
+
+	/** Items in Queue */
+	FThreadSafeCounter NumQueued;
+
+	/** Time work may take per frame, in seconds */
+	double FrameBudgetSeconds;
+
+	/** Stats, game thread only */
+	int32 PeakQueued;
+	float LastFrameMs;
+	int32 LastFrameNumRun;
+	int32 NumOverBudgetFrames;
+	int32 TotalNumRun;
+	double TotalSeconds;
+
+	/** The shared instance */
+	static FLeetCompletionDispatcher* Instance;
+};
@@ -0,0 +1,286 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetConsoleCommands.h"
+#include "LeetMockApiServer.h"
+#include "LeetLoadTest.h"
+
+namespace
+{
+#if !UE_BUILD_SHIPPING
+	/** Running mock API, if any */
+	TUniquePtr<FLeetMockApiServer> MockApiServer;
+
+	/** API address the game instance used before it was pointed at the mock */
+	FString APIURLBeforeMock;
+
+	/** Address of the running mock API, empty when none is running */
+	FString MockApiURL;
+
+	/** Current or last load test */
+	TUniquePtr<FLeetLoadTest> LoadTest;
+#endif
+
+	/** @return the Leet game instance of the world, logging why there is none */
+	ULeetGameInstance* GetLeetGameInstance(UWorld* InWorld, FOutputDevice& Ar)
+	{
+		ULeetGameInstance* GameInstance = InWorld ? Cast<ULeetGameInstance>(InWorld->GetGameInstance()) : nullptr;
+		if (GameInstance == nullptr)
+		{
+			Ar.Logf(TEXT("No Leet game instance in this world"));
+		}
+		return GameInstance;
+	}
+
+	void ExecTrace(const TCHAR* Cmd, FOutputDevice& Ar)
+	{
+		FLeetTrace& Trace = FLeetTrace::Get();
+		if (FParse::Command(&Cmd, TEXT("START")))
+		{
+			const FString SizeToken = FParse::Token(Cmd, false);
+			const int32 Capacity = SizeToken.IsNumeric() ? FCString::Atoi(*SizeToken) : FLeetTrace::DEFAULT_CAPACITY;
+			Trace.SetEnabled(true, Capacity);
+			Ar.Logf(TEXT("Leet trace capture started, %d events"), Capacity);
+		}
+		else if (FParse::Command(&Cmd, TEXT("STOP")))
+		{
+			Trace.SetEnabled(false);
+			Ar.Logf(TEXT("Leet trace capture stopped, %d events buffered"), Trace.GetNumEvents());
+		}
+		else if (FParse::Command(&Cmd, TEXT("DUMP")))
+		{
+			const FString Filename = Trace.DumpToFile(FParse::Token(Cmd, false));
+			Ar.Logf(TEXT("Leet trace written to %s"), *Filename);
+		}
+		else
+		{
+			Ar.Logf(TEXT("Leet trace: %s, %d events buffered, %d overwritten"), Trace.IsEnabled() ? TEXT("capturing") : TEXT("off"), Trace.GetNumEvents(), Trace.GetNumOverwritten());
+		}
+	}
+
+#if !UE_BUILD_SHIPPING
+	void StopMockApi(ULeetGameInstance* GameInstance)
+	{
+		if (MockApiServer.IsValid())
+		{
+			// Synthetic players must not outlive the mock, the configured API would get the rest of the test
+			if (LoadTest.IsValid())
+			{
+				LoadTest->Finish();
+				LoadTest.Reset();
+			}
+
+			MockApiServer->Shutdown();
+			MockApiServer.Reset();
+			MockApiURL.Empty();
+			if (GameInstance)
+			{
+				GameInstance->APIURL = APIURLBeforeMock;
+			}
+		}
+	}
+
+	void ExecMockApi(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar)
+	{
+		if (FParse::Command(&Cmd, TEXT("START")))
+		{
+			ULeetGameInstance* GameInstance = GetLeetGameInstance(InWorld, Ar);
+			if (GameInstance == nullptr)
+			{
+				return;
+			}
+			StopMockApi(GameInstance);
+
+			FLeetMockApiSettings Settings;
+			FParse::Value(Cmd, TEXT("Port="), Settings.Port);
+			FParse::Value(Cmd, TEXT("Latency="), Settings.LatencyMs);
+			FParse::Value(Cmd, TEXT("Jitter="), Settings.JitterMs);
+			FParse::Value(Cmd, TEXT("ErrorRate="), Settings.ErrorRate);
+			FParse::Value(Cmd, TEXT("PayloadBytes="), Settings.PayloadBytes);
+			FParse::Value(Cmd, TEXT("Servers="), Settings.NumServers);
+
+			MockApiServer = MakeUnique<FLeetMockApiServer>(Settings);
+			if (!MockApiServer->Start())
+			{
+				MockApiServer.Reset();
+				Ar.Logf(TEXT("Leet mock API could not listen on port %d"), Settings.Port);
+				return;
+			}
+
+			// The game instance builds every URL from APIURL, point it at the mock until it stops.  The subsystem
+			// keeps its own APIURL and picks the mock up through GetAPIURLOverride
+			MockApiURL = FString::Printf(TEXT("127.0.0.1:%d"), Settings.Port);
+			APIURLBeforeMock = GameInstance->APIURL;
+			GameInstance->APIURL = MockApiURL;
+			MockApiServer->Dump(Ar);
+		}
+		else if (FParse::Command(&Cmd, TEXT("STOP")))
+		{
+			StopMockApi(InWorld ? Cast<ULeetGameInstance>(InWorld->GetGameInstance()) : nullptr);
+			Ar.Logf(TEXT("Leet mock API stopped"));
+		}
+		else if (MockApiServer.IsValid())
+		{
+			MockApiServer->Dump(Ar);
+		}
+		else
+		{
+			Ar.Logf(TEXT("Leet mock API: off"));
+		}
+	}
+
+	void ExecLoadTest(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar)
+	{
+		if (FParse::Command(&Cmd, TEXT("START")))
+		{
+			ULeetGameInstance* GameInstance = GetLeetGameInstance(InWorld, Ar);
+			if (GameInstance == nullptr)
+			{
+				return;
+			}
+			if (LoadTest.IsValid() && !LoadTest->IsDone())
+			{
+				Ar.Logf(TEXT("A Leet load test is already running, LEET LOADTEST STOP ends it"));
+				return;
+			}
+			// Thousands of synthetic players are only ever sent to the mock, never to a real API
+			if (!MockApiServer.IsValid() || MockApiURL.IsEmpty() || GameInstance->APIURL != MockApiURL)
+			{
+				Ar.Logf(TEXT("The Leet load test only runs against the mock API, start it with LEET MOCKAPI START first"));
+				return;
+			}
+
+			FLeetLoadTestSettings Settings;
+			FParse::Value(Cmd, TEXT("Players="), Settings.NumPlayers);
+			FParse::Value(Cmd, TEXT("Rate="), Settings.JoinsPerSecond);
+			FParse::Value(Cmd, TEXT("Duration="), Settings.Duration);
+			FParse::Value(Cmd, TEXT("Chat="), Settings.ChatPerPlayerPerSecond);
+			FParse::Value(Cmd, TEXT("Kills="), Settings.KillsPerSecond);
+
+			LoadTest = MakeUnique<FLeetLoadTest>(GameInstance, Settings);
+			LoadTest->Start();
+			LoadTest->Dump(Ar);
+		}
+		else if (FParse::Command(&Cmd, TEXT("STOP")))
+		{
+			if (LoadTest.IsValid())
+			{
+				LoadTest->Finish();
+				LoadTest->Dump(Ar);
+			}
+		}
+		else if (LoadTest.IsValid())
+		{
+			LoadTest->Dump(Ar);
+		}
+		else
+		{
+			Ar.Logf(TEXT("Leet load test: none run yet"));
+		}
+	}
+#endif
+}
+
+bool FLeetConsoleCommands::Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar)
+{
+	if (FParse::Command(&Cmd, TEXT("PLAYERS")))
+	{
+		if (ULeetGameInstance* GameInstance = GetLeetGameInstance(InWorld, Ar))
+		{
+			GameInstance->PlayerRegistry.Dump(Ar);
+			GameInstance->DumpPendingActivations(Ar);
+		}
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("REQUESTS")))
+	{
+		FLeetHttpTransport::Get().Dump(Ar);
+		FLeetCompletionDispatcher::Get().Dump(Ar);
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("METRICS")))
+	{
+		FLeetMetrics::Get().Dump(Ar);
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("LINKS")))
+	{
+		if (ULeetGameInstance* GameInstance = GetLeetGameInstance(InWorld, Ar))
+		{
+			GameInstance->DumpServerLinks(Ar);
+		}
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("CHAT")))
+	{
+		ALeetGameState* GameState = InWorld ? Cast<ALeetGameState>(InWorld->GameState) : nullptr;
+		if (GameState)
+		{
+			GameState->DumpChatStats(Ar);
+		}
+		if (ULeetGameInstance* GameInstance = GetLeetGameInstance(InWorld, Ar))
+		{
+			GameInstance->DumpChatRelay(Ar);
+		}
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("TRACE")))
+	{
+		ExecTrace(Cmd, Ar);
+		return true;
+	}
+#if !UE_BUILD_SHIPPING
+	if (FParse::Command(&Cmd, TEXT("MOCKAPI")))
+	{
+		ExecMockApi(InWorld, Cmd, Ar);
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("LOADTEST")))
+	{
+		ExecLoadTest(InWorld, Cmd, Ar);
+		return true;
+	}
+#endif
+	if (FParse::Command(&Cmd, TEXT("HELP")))
+	{
+		PrintHelp(Ar);
+		return true;
+	}
+	return false;
+}
+
+void FLeetConsoleCommands::PrintHelp(FOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("LEET PLAYERS - player registry and pending activations"));
+	Ar.Logf(TEXT("LEET REQUESTS - in flight and queued requests, retries, circuit breakers, completions"));
+	Ar.Logf(TEXT("LEET METRICS - per endpoint counters and latency percentiles"));
+	Ar.Logf(TEXT("LEET LINKS - cached server links"));
+	Ar.Logf(TEXT("LEET CHAT - chat fan out and upstream relay"));
+	Ar.Logf(TEXT("LEET TRACE [START [Size] | STOP | DUMP [File]] - request lifecycle trace capture"));
+#if !UE_BUILD_SHIPPING
+	Ar.Logf(TEXT("LEET MOCKAPI [START [Port=] [Latency=] [Jitter=] [ErrorRate=] [PayloadBytes=] [Servers=] | STOP] - local stand-in for the Leet API"));
+	Ar.Logf(TEXT("LEET LOADTEST [START [Players=] [Rate=] [Duration=] [Chat=] [Kills=] | STOP] - synthetic players against the mock API, which must be running"));
+#endif
+}
+
+void FLeetConsoleCommands::Shutdown()
+{
+#if !UE_BUILD_SHIPPING
+	LoadTest.Reset();
+	if (MockApiServer.IsValid())
+	{
+		MockApiServer->Shutdown();
+		MockApiServer.Reset();
+	}
+	MockApiURL.Empty();
+#endif
+}
+
+FString FLeetConsoleCommands::GetAPIURLOverride()
+{
+#if !UE_BUILD_SHIPPING
+	return MockApiURL;
+#else
+	return FString();
+#endif
+}
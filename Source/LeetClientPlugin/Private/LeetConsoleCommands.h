@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Diagnostics console commands of the Leet plugin, reached through FOnlineSubsystemLeet::Exec:
+ *
+ *   ONLINE [SUB=Leet] LEET PLAYERS              player registry and activations waiting for their batch
+ *   ONLINE [SUB=Leet] LEET REQUESTS             transport queues, retries, circuit breakers and completions
+ *   ONLINE [SUB=Leet] LEET METRICS              per endpoint counters and latency percentiles
+ *   ONLINE [SUB=Leet] LEET LINKS                cached server links
+ *   ONLINE [SUB=Leet] LEET SERVERS              session search results (handled by the subsystem)
+ *   ONLINE [SUB=Leet] LEET CHAT                 chat fan out and upstream relay
+ *   ONLINE [SUB=Leet] LEET TRACE START [Size]   starts trace capture, STOP / DUMP [File] / no argument for status
+ *
+ * Everything above only reads state that is already in memory, safe to run on a live server.  Outside shipping
+ * builds there is also:
+ *
+ *   ONLINE [SUB=Leet] LEET MOCKAPI START [...]  runs FLeetMockApiServer and points the game instance and subsystem at it
+ *   ONLINE [SUB=Leet] LEET LOADTEST START [...] drives the game instance with synthetic players against the running mock
+ *                                               API, see FLeetLoadTest
+ */
+class LEETCLIENTPLUGIN_API FLeetConsoleCommands
+{
+public:
+
+	/**
+	 * Runs a LEET command
+	 *
+	 * @param InWorld world the command was typed in, may be null
+	 * @param Cmd the command with the LEET prefix already parsed off
+	 * @param Ar device the output goes to
+	 *
+	 * @return true if the command was one of ours
+	 */
+	static bool Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar);
+
+	/** Lists the commands on the given output device */
+	static void PrintHelp(FOutputDevice& Ar);
+
+	/** Stops the mock API and load test started from the console.  Called on module shutdown */
+	static void Shutdown();
+
+	/** @return address of the mock API while one runs, which replaces the configured APIURL, empty otherwise */
+	static FString GetAPIURLOverride();
+};
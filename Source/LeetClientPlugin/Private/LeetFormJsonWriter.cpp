@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetFormJsonWriter.h"
+
+namespace
+{
+	const ANSICHAR HexDigits[] = "0123456789ABCDEF";
+
+	/** Characters left as is in a form value, everything else is percent encoded */
+	FORCEINLINE bool IsUnreserved(ANSICHAR Char)
+	{
+		return (Char >= 'A' && Char <= 'Z') || (Char >= 'a' && Char <= 'z') || (Char >= '0' && Char <= '9') ||
+			Char == '-' || Char == '_' || Char == '.' || Char == '~';
+	}
+}
+
+FLeetFormJsonWriter::FLeetFormJsonWriter(int32 ReserveBytes)
+	: bAfterKey(false)
+{
+	Buffer.Reserve(ReserveBytes);
+}
+
+void FLeetFormJsonWriter::BeginArray()
+{
+	BeginValue();
+	AppendEncoded('[');
+	NeedsComma.Add(false);
+}
+
+void FLeetFormJsonWriter::EndArray()
+{
+	NeedsComma.Pop(false);
+	AppendEncoded(']');
+}
+
+void FLeetFormJsonWriter::BeginObject()
+{
+	BeginValue();
+	AppendEncoded('{');
+	NeedsComma.Add(false);
+}
+
+void FLeetFormJsonWriter::EndObject()
+{
+	NeedsComma.Pop(false);
+	AppendEncoded('}');
+}
+
+void FLeetFormJsonWriter::WriteKey(const TCHAR* Key)
+{
+	BeginValue();
+	AppendEncoded('"');
+	AppendEscaped(Key);
+	AppendEncoded('"');
+	AppendEncoded(':');
+	bAfterKey = true;
+}
+
+void FLeetFormJsonWriter::WriteString(const FString& Value)
+{
+	BeginValue();
+	AppendEncoded('"');
+	AppendEscaped(Value);
+	AppendEncoded('"');
+}
+
+void FLeetFormJsonWriter::WriteInt(int32 Value)
+{
+	BeginValue();
+
+	ANSICHAR Digits[16];
+	int32 NumDigits = 0;
+	uint32 Magnitude = Value < 0 ? 0u - (uint32)Value : (uint32)Value;
+	do
+	{
+		Digits[NumDigits++] = '0' + (Magnitude % 10);
+		Magnitude /= 10;
+	} while (Magnitude > 0);
+
+	if (Value < 0)
+	{
+		Buffer.Add('-');
+	}
+	while (NumDigits > 0)
+	{
+		Buffer.Add(Digits[--NumDigits]);
+	}
+}
+
+FString FLeetFormJsonWriter::ToString() const
+{
+	// Plain ASCII, widening is all the conversion there is
+	return FString(Buffer.Num(), Buffer.GetData());
+}
+
+void FLeetFormJsonWriter::BeginValue()
+{
+	if (bAfterKey)
+	{
+		// The key already took care of the separator
+		bAfterKey = false;
+		return;
+	}
+	if (NeedsComma.Num() > 0)
+	{
+		if (NeedsComma.Last())
+		{
+			AppendEncoded(',');
+		}
+		NeedsComma.Last() = true;
+	}
+}
+
+void FLeetFormJsonWriter::AppendEncoded(ANSICHAR Char)
+{
+	if (IsUnreserved(Char))
+	{
+		Buffer.Add(Char);
+	}
+	else
+	{
+		const uint8 Byte = (uint8)Char;
+		Buffer.Add('%');
+		Buffer.Add(HexDigits[Byte >> 4]);
+		Buffer.Add(HexDigits[Byte & 0xF]);
+	}
+}
+
+void FLeetFormJsonWriter::AppendEscaped(const FString& Value)
+{
+	FTCHARToUTF8 ValueUTF8(*Value);
+	const ANSICHAR* Chars = ValueUTF8.Get();
+	const int32 Length = ValueUTF8.Length();
+	for (int32 CharIdx = 0; CharIdx < Length; CharIdx++)
+	{
+		const ANSICHAR Char = Chars[CharIdx];
+		if (Char == '"' || Char == '\\')
+		{
+			AppendEncoded('\\');
+			AppendEncoded(Char);
+		}
+		else if ((uint8)Char < 0x20)
+		{
+			// Control characters are only valid in JSON strings as \u escapes
+			AppendEncoded('\\');
+			AppendEncoded('u');
+			AppendEncoded('0');
+			AppendEncoded('0');
+			AppendEncoded(HexDigits[(uint8)Char >> 4]);
+			AppendEncoded(HexDigits[(uint8)Char & 0xF]);
+		}
+		else
+		{
+			AppendEncoded(Char);
+		}
+	}
+}
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Streams JSON straight into a form (application/x-www-form-urlencoded) value.
+ *
+ * Output is written once into a preallocated UTF-8 buffer: strings are JSON escaped and the result percent
+ * encoded in the same pass, so no intermediate JSON document or string is ever built.  Because everything
+ * outside [A-Za-z0-9-_.~] is percent encoded the buffer is plain ASCII.
+ */
+class FLeetFormJsonWriter
+{
+public:
+
+	/** @param ReserveBytes expected size of the encoded output, the buffer only reallocates if it is exceeded */
+	explicit FLeetFormJsonWriter(int32 ReserveBytes);
+
+	void BeginArray();
+	void EndArray();
+	void BeginObject();
+	void EndObject();
+
+	/** Writes an object key, the next value written belongs to it */
+	void WriteKey(const TCHAR* Key);
+
+	void WriteString(const FString& Value);
+	void WriteInt(int32 Value);
+
+	/** @return number of bytes written so far */
+	int32 Num() const { return Buffer.Num(); }
+
+	/** @return the encoded output */
+	FString ToString() const;
+
+private:
+
+	/** Writes the separator needed before a new value at the current nesting level */
+	void BeginValue();
+
+	/** Appends a character of the JSON text, percent encoding it if needed */
+	void AppendEncoded(ANSICHAR Char);
+
+	/** Appends the UTF-8 bytes of a string as JSON string contents */
+	void AppendEscaped(const FString& Value);
+
+	/** Encoded output */
+	TArray<ANSICHAR> Buffer;
+
+	/** One entry per open array or object, true once it holds a value and the next one needs a comma */
+	TArray<bool, TInlineAllocator<8>> NeedsComma;
+
+	/** Set between WriteKey and the value that follows it */
+	bool bAfterKey;
+};
@@ -2,6 +2,7 @@
 
 #include "LeetClientPluginPrivatePCH.h"
 //#include "LeetGameInstance.h"
+#include "LeetFormJsonWriter.h"
 
 namespace LeetGameInstanceState
 {
@@ -13,31 +14,93 @@ namespace LeetGameInstanceState
 	const FName Playing = FName(TEXT("Playing"));
 }
 
+namespace
+{
+	/** Default time joining players are collected before their activations are sent, in seconds */
+	const float DEFAULT_ACTIVATION_BATCH_WINDOW = 0.05f;
+	/** Default number of activations sent in a single batch */
+	const int32 DEFAULT_MAX_ACTIVATION_BATCH_SIZE = 32;
+	/** Default number of chat lines a player may send back to back */
+	const int32 DEFAULT_CHAT_BURST = 5;
+	/** Default number of chat lines a player earns back per second */
+	const float DEFAULT_CHAT_REFILL_PER_SECOND = 1.0f;
+	/** Default time chat lines are collected before being relayed to the API, in seconds */
+	const float DEFAULT_CHAT_RELAY_INTERVAL = 2.0f;
+	/** Default number of queued chat lines that triggers an early relay */
+	const int32 DEFAULT_CHAT_RELAY_BATCH_SIZE = 50;
+	/** Default number of chat lines kept queued before the oldest are dropped */
+	const int32 DEFAULT_MAX_PENDING_CHAT_LINES = 200;
+	/** Encoded size reserved per relayed chat line */
+	const int32 CHAT_LINE_RESERVE_BYTES = 128;
+	/** Encoded size reserved per player when submitting match results, without the killed list */
+	const int32 PLAYER_RESULT_RESERVE_BYTES = 256;
+	/** Encoded size reserved per entry of a player's killed list, the victim's playerKey quoted, escaped and comma separated */
+	const int32 KILL_RESULT_RESERVE_BYTES = 96;
+
+	/** Publishes the depth and string memory of the chat relay queue */
+	void SetChatRelayStats(const TArray<FLeetPendingChatLine>& PendingChatLines)
+	{
+#if STATS
+		SIZE_T Memory = PendingChatLines.GetAllocatedSize();
+		for (int32 b = 0; b < PendingChatLines.Num(); b++)
+		{
+			Memory += PendingChatLines[b].PlatformID.GetAllocatedSize() + PendingChatLines[b].Message.GetAllocatedSize();
+		}
+		SET_DWORD_STAT(STAT_LeetChatRelayQueueDepth, PendingChatLines.Num());
+		SET_MEMORY_STAT(STAT_LeetChatRelayMemory, Memory);
+#endif
+	}
+
+	/** Reads an optional integer from the Leet.Client config section */
+	int32 GetOptionalConfigInt(FConfigSection* Configs, const TCHAR* Key, int32 DefaultValue)
+	{
+		const FString* Value = Configs->Find(Key);
+		return Value ? FCString::Atoi(**Value) : DefaultValue;
+	}
+
+	/** Reads an optional float from the Leet.Client config section */
+	float GetOptionalConfigFloat(FConfigSection* Configs, const TCHAR* Key, float DefaultValue)
+	{
+		const FString* Value = Configs->Find(Key);
+		return Value ? FCString::Atof(**Value) : DefaultValue;
+	}
+}
+
 ULeetGameInstance::ULeetGameInstance(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bIsOnline(true) // Default to online
 	, bIsLicensed(true) // Default to licensed (should have been checked by OS on boot)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE CONSTRUCTOR"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE CONSTRUCTOR"));
 	CurrentState = LeetGameInstanceState::None;
 
 	ServerSessionHostAddress = NULL;
 	ServerSessionID = NULL;
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE INIT"));
+	ActivationBatchWindow = DEFAULT_ACTIVATION_BATCH_WINDOW;
+	MaxActivationBatchSize = DEFAULT_MAX_ACTIVATION_BATCH_SIZE;
+	ChatBurst = DEFAULT_CHAT_BURST;
+	ChatRefillPerSecond = DEFAULT_CHAT_REFILL_PER_SECOND;
+	ChatRelayInterval = DEFAULT_CHAT_RELAY_INTERVAL;
+	ChatRelayBatchSize = DEFAULT_CHAT_RELAY_BATCH_SIZE;
+	MaxPendingChatLines = DEFAULT_MAX_PENDING_CHAT_LINES;
+	bChatRelayInFlight = false;
+	NumChatLinesDropped = 0;
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE INIT"));
 
 	_configPath = FPaths::SourceConfigDir();
 	_configPath += TEXT("LeetConfig.ini");
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] set up path"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] set up path"));
 
 	if (FPaths::FileExists(_configPath))
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET]File Exists"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET]File Exists"));
 		FConfigSection* Configs = GConfig->GetSectionPrivate(TEXT("Leet.Client"), false, true, _configPath);
 		if (Configs)
 		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] Configs Exist"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] Configs Exist"));
 			FString test = *Configs->Find(TEXT("APIURL"));
 
 			APIURL = *Configs->Find(TEXT("APIURL"));
@@ -45,27 +108,78 @@ ULeetGameInstance::ULeetGameInstance(const FObjectInitializer& ObjectInitializer
 			ServerAPIKey = *Configs->Find(TEXT("ServerAPIKey"));
 			GameKey = *Configs->Find(TEXT("GameKey"));
 
+			// Optional transport tuning
+			FLeetHttpTransport::Get().Configure(
+				GetOptionalConfigInt(Configs, TEXT("MaxInFlightRequests"), FLeetHttpTransport::DEFAULT_MAX_IN_FLIGHT),
+				GetOptionalConfigInt(Configs, TEXT("MaxConnectionsPerHost"), FLeetHttpTransport::DEFAULT_MAX_CONNECTIONS_PER_HOST));
+
+			FLeetHttpTransport::Get().ConfigureCircuitBreaker(
+				GetOptionalConfigInt(Configs, TEXT("CircuitFailureThreshold"), FLeetHttpTransport::DEFAULT_CIRCUIT_FAILURE_THRESHOLD),
+				GetOptionalConfigFloat(Configs, TEXT("CircuitOpenSeconds"), FLeetHttpTransport::DEFAULT_CIRCUIT_OPEN_SECONDS));
+
+			// Optional activation batching
+			ActivationBatchWindow = FMath::Max(0.0f, GetOptionalConfigFloat(Configs, TEXT("ActivationBatchWindow"), ActivationBatchWindow));
+			MaxActivationBatchSize = FMath::Max(1, GetOptionalConfigInt(Configs, TEXT("MaxActivationBatchSize"), MaxActivationBatchSize));
+
+			// Optional chat rate limit
+			ChatBurst = FMath::Max(1, GetOptionalConfigInt(Configs, TEXT("ChatBurst"), ChatBurst));
+			ChatRefillPerSecond = FMath::Max(0.0f, GetOptionalConfigFloat(Configs, TEXT("ChatRefillPerSecond"), ChatRefillPerSecond));
+
+			// Optional upstream chat relay tuning
+			ChatRelayInterval = FMath::Max(0.0f, GetOptionalConfigFloat(Configs, TEXT("ChatRelayInterval"), ChatRelayInterval));
+			ChatRelayBatchSize = FMath::Max(1, GetOptionalConfigInt(Configs, TEXT("ChatRelayBatchSize"), ChatRelayBatchSize));
+			MaxPendingChatLines = FMath::Max(ChatRelayBatchSize, GetOptionalConfigInt(Configs, TEXT("MaxPendingChatLines"), MaxPendingChatLines));
+
+			// Optional per-frame budget for applying API results
+			FLeetCompletionDispatcher::Get().SetFrameBudget(
+				GetOptionalConfigFloat(Configs, TEXT("CompletionFrameBudgetMs"), FLeetCompletionDispatcher::DEFAULT_FRAME_BUDGET_MS));
+
+			// Optional metrics snapshot, relative paths land in Saved/Leet
+			const FString* MetricsExportFile = Configs->Find(TEXT("MetricsExportFile"));
+			if (MetricsExportFile && !MetricsExportFile->IsEmpty())
+			{
+				const FString MetricsExportPath = FPaths::IsRelative(*MetricsExportFile) ? FPaths::Combine(*FPaths::GameSavedDir(), TEXT("Leet"), **MetricsExportFile) : *MetricsExportFile;
+				FLeetMetrics::Get().SetExport(MetricsExportPath,
+					GetOptionalConfigFloat(Configs, TEXT("MetricsExportInterval"), FLeetMetrics::DEFAULT_EXPORT_INTERVAL));
+			}
+
+			// Optional request lifecycle trace capture from startup
+			const FString* TraceCapture = Configs->Find(TEXT("TraceCapture"));
+			if (TraceCapture && TraceCapture->ToBool())
+			{
+				FLeetTrace::Get().SetEnabled(true, GetOptionalConfigInt(Configs, TEXT("TraceBufferSize"), FLeetTrace::DEFAULT_CAPACITY));
+			}
+
 		}
 		else
 		{
-			UE_LOG(LogTemp, Log, TEXT("Could not find Leet.Client in LeetConfig.ini"));
+			UE_LOG(LogLeet, Log, TEXT("Could not find Leet.Client in LeetConfig.ini"));
 		}
 	}
 	else
 	{
-		UE_LOG(LogTemp, Log, TEXT("Could not find LeetConfig.ini, must Initialize manually!"));
+		UE_LOG(LogLeet, Log, TEXT("Could not find LeetConfig.ini, must Initialize manually!"));
 	}
 
+	// Match results carry money so they get the largest retry budget, chat is worthless once stale
+	FLeetHttpTransport& Transport = FLeetHttpTransport::Get();
+	Transport.SetRetryPolicy(TEXT("/api/v2/match/results*"), FLeetRetryPolicy(6, 1.0f, 30.0f));
+	Transport.SetRetryPolicy(TEXT("/api/v2/player/*"), FLeetRetryPolicy(4, 0.5f, 8.0f));
+	Transport.SetRetryPolicy(TEXT("/api/v2/players/activate*"), FLeetRetryPolicy(4, 0.5f, 8.0f));
+	Transport.SetRetryPolicy(TEXT("/api/v2/player/*/chat*"), FLeetRetryPolicy(1, 0.0f, 0.0f));
+	Transport.SetRetryPolicy(TEXT("/api/v2/players/chat*"), FLeetRetryPolicy(1, 0.0f, 0.0f));
+	Transport.SetRetryPolicy(TEXT("/api/v2/game/player/*"), FLeetRetryPolicy(3, 0.5f, 4.0f));
+
 	// I don't think we want this here.
 	//GetServerInfo();
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE CONSTRUCTOR - DONE"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE CONSTRUCTOR - DONE"));
 }
 
 void ULeetGameInstance::Init()
 {
 	Super::Init();
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE INIT"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE INIT"));
 
 	//IgnorePairingChangeForControllerId = -1;
 	CurrentConnectionStatus = EOnlineServerConnectionStatus::Connected;
@@ -88,21 +202,61 @@ void ULeetGameInstance::Init()
 	SessionInterface->AddOnSessionFailureDelegate_Handle(FOnSessionFailureDelegate::CreateUObject(this, &ULeetGameInstance::HandleSessionFailure));
 
 	OnEndSessionCompleteDelegate = FOnEndSessionCompleteDelegate::CreateUObject(this, &ULeetGameInstance::OnEndSessionComplete);
+
+	// Replay whatever the last run recorded but never got an answer for
+	TArray<FLeetJournalEntry> PendingEntries;
+	Journal = MakeShareable(new FLeetJournal(FPaths::GameSavedDir() / TEXT("Leet") / TEXT("Journal.log")));
+	Journal->Open(PendingEntries);
+	for (int32 b = 0; b < PendingEntries.Num(); b++)
+	{
+		UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE INIT - replaying %s %s"), *PendingEntries[b].Id, *PendingEntries[b].APIURI);
+		PerformHttpRequest(FHttpRequestCompleteDelegate::CreateUObject(this, &ULeetGameInstance::JournaledRequestComplete, PendingEntries[b].Id, FHttpRequestCompleteDelegate()),
+			PendingEntries[b].APIURI, PendingEntries[b].Arguments, PendingEntries[b].Id, ELeetTaskPriority::High);
+	}
 	//OnCreateSessionCompleteDelegate = FOnCreateSessionCompleteDelegate::CreateUObject(this, &ULeetGameInstance::OnCreateSessionComplete);
 
 }
 
+void ULeetGameInstance::Shutdown()
+{
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE SHUTDOWN"));
+
+	if (ActivationFlushTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ActivationFlushTickerHandle);
+		ActivationFlushTickerHandle.Reset();
+	}
+	PendingActivations.Empty();
+
+	if (ChatRelayTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ChatRelayTickerHandle);
+		ChatRelayTickerHandle.Reset();
+	}
+	PendingChatLines.Empty();
+	InFlightChatLines.Empty();
+	SetChatRelayStats(PendingChatLines);
+
+	if (Journal.IsValid())
+	{
+		Journal->Close();
+		Journal.Reset();
+	}
+
+	Super::Shutdown();
+}
+
 ALeetGameSession* ULeetGameInstance::GetGameSession() const
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::GetGameSession"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::GetGameSession"));
 	UWorld* const World = GetWorld();
 	if (World)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] World Found"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] World Found"));
 		AGameMode* const Game = World->GetAuthGameMode();
 		if (Game)
 		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] Game Found"));
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] Game Found"));
 			return Cast<ALeetGameSession>(Game->GameSession);
 		}
 	}
@@ -111,44 +265,76 @@ ALeetGameSession* ULeetGameInstance::GetGameSession() const
 }
 
 // prototype http function
-bool ULeetGameInstance::PerformHttpRequest(void(ULeetGameInstance::*delegateCallback)(FHttpRequestPtr, FHttpResponsePtr, bool), FString APIURI, FString ArgumentString)
+bool ULeetGameInstance::PerformHttpRequest(void(ULeetGameInstance::*delegateCallback)(FHttpRequestPtr, FHttpResponsePtr, bool), FString APIURI, FString ArgumentString, ELeetTaskPriority::Type Priority)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] PerformHttpRequest"));
+	return PerformHttpRequest(FHttpRequestCompleteDelegate::CreateUObject(this, delegateCallback), APIURI, ArgumentString, FString(), Priority);
+}
 
-	FHttpModule* Http = &FHttpModule::Get();
-	if (!Http) { return false; }
-	if (!Http->IsHttpEnabled()) { return false; }
+bool ULeetGameInstance::PerformHttpRequest(const FHttpRequestCompleteDelegate& CompleteDelegate, FString APIURI, FString ArgumentString, const FString& IdempotencyKey, ELeetTaskPriority::Type Priority)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetBuildRequest);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] PerformHttpRequest"));
 
 	FString TargetHost = "http://" + APIURL + APIURI;
 
-	UE_LOG(LogTemp, Log, TEXT("TargetHost: %s"), *TargetHost);
-	UE_LOG(LogTemp, Log, TEXT("ServerAPIKey: %s"), *ServerAPIKey);
-	UE_LOG(LogTemp, Log, TEXT("ServerAPISecret: %s"), *ServerAPISecret);
+	// Never log the key or the secret, only enough of the key to tell servers apart
+	UE_LOG(LogLeet, Verbose, TEXT("TargetHost: %s"), *TargetHost);
+	UE_LOG(LogLeet, Verbose, TEXT("ServerAPIKey: %s..."), *ServerAPIKey.Left(4));
 
-	TSharedRef < IHttpRequest > Request = Http->CreateRequest();
-	Request->SetVerb("POST");
-	Request->SetURL(TargetHost);
-	Request->SetHeader("User-Agent", "LEET_UE4_API_CLIENT/1.0");
+	// All API calls share the transport's keep-alive connection pool
+	FLeetHttpTransport& Transport = FLeetHttpTransport::Get();
+	TSharedRef < IHttpRequest > Request = Transport.CreateRequest(TEXT("POST"), TargetHost);
 	Request->SetHeader("Content-Type", "application/x-www-form-urlencoded");
 	Request->SetHeader("Key", ServerAPIKey);
 	Request->SetHeader("Sign", "RealSignatureComingIn411");
 	Request->SetContentAsString(ArgumentString);
+	if (!IdempotencyKey.IsEmpty())
+	{
+		Request->SetHeader("Idempotency-Key", IdempotencyKey);
+	}
 
-	Request->OnProcessRequestComplete().BindUObject(this, delegateCallback);
-	if (!Request->ProcessRequest()) { return false; }
+	return ILeetAsyncScheduler::Schedule(Request, CompleteDelegate, Priority);
+}
 
-	return true;
+bool ULeetGameInstance::PerformJournaledHttpRequest(void(ULeetGameInstance::*delegateCallback)(FHttpRequestPtr, FHttpResponsePtr, bool), FString APIURI, FString ArgumentString)
+{
+	if (!Journal.IsValid())
+	{
+		return PerformHttpRequest(delegateCallback, APIURI, ArgumentString, ELeetTaskPriority::High);
+	}
+
+	// Recorded before it is sent, the entry id doubles as the idempotency key so a replay can't be applied twice
+	const FString EntryId = Journal->AppendPending(APIURI, ArgumentString);
+	FHttpRequestCompleteDelegate CallerDelegate = FHttpRequestCompleteDelegate::CreateUObject(this, delegateCallback);
+	return PerformHttpRequest(FHttpRequestCompleteDelegate::CreateUObject(this, &ULeetGameInstance::JournaledRequestComplete, EntryId, CallerDelegate), APIURI, ArgumentString, EntryId, ELeetTaskPriority::High);
+}
+
+void ULeetGameInstance::JournaledRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, FString EntryId, FHttpRequestCompleteDelegate CallerDelegate)
+{
+	// Success or a definitive rejection is final, sending it again would not change it.  With no answer, a server
+	// error, a timeout or throttling the entry stays pending and is replayed on the next startup.
+	const int32 ResponseCode = HttpResponse.IsValid() ? HttpResponse->GetResponseCode() : 0;
+	if (Journal.IsValid() && !FLeetHttpTransport::IsTransientResponseCode(ResponseCode))
+	{
+		Journal->MarkComplete(EntryId);
+	}
+	else
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] JournaledRequestComplete - %s left pending"), *EntryId);
+	}
+
+	CallerDelegate.ExecuteIfBound(HttpRequest, HttpResponse, bSucceeded);
 }
 
 bool ULeetGameInstance::GetServerInfo()
 {
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] GetServerInfo"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] GetServerInfo"));
 	FString nonceString = "10951350917635";
 	FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
 	FString OutputString = "nonce=" + nonceString + "&encryption=" + encryption;
-	UE_LOG(LogTemp, Log, TEXT("ServerSessionHostAddress: %s"), *ServerSessionHostAddress);
-	UE_LOG(LogTemp, Log, TEXT("ServerSessionID: %s"), *ServerSessionID);
+	UE_LOG(LogLeet, Verbose, TEXT("ServerSessionHostAddress: %s"), *ServerSessionHostAddress);
+	UE_LOG(LogLeet, Verbose, TEXT("ServerSessionID: %s"), *ServerSessionID);
 	if (ServerSessionHostAddress.Len() > 1) {
 		OutputString = OutputString + "&session_host_address=" + ServerSessionHostAddress + "&session_id=" + ServerSessionID;
 	}
@@ -161,57 +347,54 @@ void ULeetGameInstance::GetServerInfoComplete(FHttpRequestPtr HttpRequest, FHttp
 {
 	if (!HttpResponse.IsValid())
 	{
-		UE_LOG(LogTemp, Log, TEXT("Test failed. NULL response"));
+		UE_LOG(LogLeet, Verbose, TEXT("Test failed. NULL response"));
+		return;
 	}
-	else
-	{
-		UE_LOG(LogTemp, Log, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%s]"),
-			*HttpRequest->GetVerb(),
-			*HttpRequest->GetURL(),
-			HttpResponse->GetResponseCode(),
-			*HttpResponse->GetContentAsString());
 
-		FString JsonRaw = *HttpResponse->GetContentAsString();
-		TSharedPtr<FJsonObject> JsonParsed;
-		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonRaw);
-		if (FJsonSerializer::Deserialize(JsonReader, JsonParsed))
-		{
-			bool Authorization = JsonParsed->GetBoolField("authorization");
-			UE_LOG(LogTemp, Log, TEXT("Authorization"));
-			if (Authorization)
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization True"));
-				// Set up our instance variables
-				if (JsonParsed->GetIntegerField("incrementBTC")) {
-					incrementBTC = JsonParsed->GetIntegerField("incrementBTC");
-				}
-				if (JsonParsed->GetIntegerField("minimumBTCHold")) {
-					minimumBTCHold = JsonParsed->GetIntegerField("minimumBTCHold");
-				}
-				if (JsonParsed->GetNumberField("serverRakeBTCPercentage")) {
-					serverRakeBTCPercentage = JsonParsed->GetNumberField("serverRakeBTCPercentage");
-				}
-				if (JsonParsed->GetNumberField("leetcoinRakePercentage")) {
-					leetRakePercentage = JsonParsed->GetNumberField("leetcoinRakePercentage");
-				}
-				if (incrementBTC && serverRakeBTCPercentage && leetRakePercentage) {
-					killRewardBTC = incrementBTC - ((incrementBTC * serverRakeBTCPercentage) + (incrementBTC * leetRakePercentage));
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization False"));
-			}
+	UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
+		*HttpRequest->GetVerb(),
+		*HttpRequest->GetURL(),
+		HttpResponse->GetResponseCode(),
+		HttpResponse->GetContent().Num());
+
+	FLeetApiDecoder::DecodeAsync(HttpResponse, this, &ULeetGameInstance::ApplyServerInfo);
+}
+
+void ULeetGameInstance::ApplyServerInfo(const FLeetServerInfoResult& Result)
+{
+	UE_LOG(LogLeet, Verbose, TEXT("Authorization"));
+	if (Result.bAuthorized)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization True"));
+		// Set up our instance variables
+		if (Result.IncrementBTC) {
+			incrementBTC = Result.IncrementBTC;
+		}
+		if (Result.MinimumBTCHold) {
+			minimumBTCHold = Result.MinimumBTCHold;
+		}
+		if (Result.ServerRakeBTCPercentage) {
+			serverRakeBTCPercentage = Result.ServerRakeBTCPercentage;
+		}
+		if (Result.LeetRakePercentage) {
+			leetRakePercentage = Result.LeetRakePercentage;
 		}
+		if (incrementBTC && serverRakeBTCPercentage && leetRakePercentage) {
+			killRewardBTC = incrementBTC - ((incrementBTC * serverRakeBTCPercentage) + (incrementBTC * leetRakePercentage));
+		}
+	}
+	else
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization False"));
 	}
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [GetServerInfoComplete] Done!"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [GetServerInfoComplete] Done!"));
 }
 
 
 bool ULeetGameInstance::GetServerLinks()
 {
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] GetServerLinks"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] GetServerLinks"));
 	FString nonceString = "10951350917635";
 	FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
 	FString OutputString = "nonce=" + nonceString + "&encryption=" + encryption;
@@ -224,292 +407,375 @@ void ULeetGameInstance::GetServerLinksComplete(FHttpRequestPtr HttpRequest, FHtt
 {
 	if (!HttpResponse.IsValid())
 	{
-		UE_LOG(LogTemp, Log, TEXT("Test failed. NULL response"));
+		UE_LOG(LogLeet, Verbose, TEXT("Test failed. NULL response"));
+		return;
 	}
-	else
-	{
-		UE_LOG(LogTemp, Log, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%s]"),
-			*HttpRequest->GetVerb(),
-			*HttpRequest->GetURL(),
-			HttpResponse->GetResponseCode(),
-			*HttpResponse->GetContentAsString());
 
-		const FString JsonRaw = *HttpResponse->GetContentAsString();
+	UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
+		*HttpRequest->GetVerb(),
+		*HttpRequest->GetURL(),
+		HttpResponse->GetResponseCode(),
+		HttpResponse->GetContent().Num());
 
-		TSharedPtr<FJsonObject> JsonParsed;
-		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonRaw);
-		if (FJsonSerializer::Deserialize(JsonReader, JsonParsed))
+	FLeetApiDecoder::DecodeAsync(HttpResponse, this, &ULeetGameInstance::ApplyServerLinks);
+}
+
+void ULeetGameInstance::ApplyServerLinks(const FLeetServerLinksResult& Result)
+{
+	UE_LOG(LogLeet, Verbose, TEXT("Authorization"));
+	if (Result.bAuthorized)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization True"));
+		if (Result.bLinksConverted) {
+			UE_LOG(LogLeet, Verbose, TEXT("jsonConvertSuccess"));
+			ServerLinks = Result.Links;
+		}
+		else {
+			UE_LOG(LogLeet, Verbose, TEXT("jsonConvertFAIL"));
+		}
+		UE_LOG(LogLeet, Verbose, TEXT("Found %d Server Links"), ServerLinks.links.Num());
+		for (int32 b = 0; b < ServerLinks.links.Num(); b++)
 		{
-			bool Authorization = JsonParsed->GetBoolField("authorization");
-			UE_LOG(LogTemp, Log, TEXT("Authorization"));
-			if (Authorization)
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization True"));
-				// parse JSON
-				bool jsonConvertSuccess = FJsonObjectConverter::JsonObjectStringToUStruct<FLeetServerLinks>(*JsonRaw, &ServerLinks, 0, 0);
-				if (jsonConvertSuccess) {
-					UE_LOG(LogTemp, Log, TEXT("jsonConvertSuccess"));
-				}
-				else {
-					UE_LOG(LogTemp, Log, TEXT("jsonConvertFAIL"));
-				}
-				UE_LOG(LogTemp, Log, TEXT("Found %d Server Links"), ServerLinks.links.Num());
-				for (int32 b = 0; b < ServerLinks.links.Num(); b++)
-				{
-					UE_LOG(LogTemp, Log, TEXT("targetServerTitle: %s"), *ServerLinks.links[b].targetServerTitle);
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization False"));
-			}
+			UE_LOG(LogLeet, Verbose, TEXT("targetServerTitle: %s"), *ServerLinks.links[b].targetServerTitle);
 		}
 	}
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [GetServerLinksComplete] Done!"));
+	else
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization False"));
+	}
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [GetServerLinksComplete] Done!"));
 }
 
 bool ULeetGameInstance::ActivatePlayer(FString PlatformID, int32 playerID)
 {
+	FLeetTraceScope TraceScope(TEXT("ActivatePlayer"), PlatformID);
+	FLeetTrace::Get().Flow(FLeetTrace::JOIN_FLOW, PlatformID, TEXT('t'));
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] ActivatePlayer"));
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] DEBUG TEST"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] ActivatePlayer"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] DEBUG TEST"));
 
 	// check to see if this player is in the active list already
-	bool platformIDFound = false;
-	int32 ActivePlayerIndex = 0;
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] check to see if this player is in the active list already"));
+	if (PlayerRegistry.FindByPlatformId(PlatformID) == nullptr) {
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] AuthorizePlayer - No existing platformID found"));
 
-	// this is just a test to make sure the get by playerid is working.
-	//  TODO refactor the below to use this.
-	FLeetActivePlayer* CurrentActivePlayer = getPlayerByPlayerId(playerID);
+		// add the player to the registry as authorized=false
+		FLeetActivePlayer activeplayer;
+		activeplayer.playerID = playerID;
+		activeplayer.platformID = PlatformID;
+		activeplayer.authorized = false;
+		activeplayer.roundDeaths = 0;
+		activeplayer.roundKills = 0;
+
+		if (PlayerRegistry.Add(activeplayer) == nullptr) {
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] AuthorizePlayer - playerID %d already registered"), playerID);
+			return false;
+		}
+
+		UE_LOG(LogLeet, Verbose, TEXT("PlatformID: %s"), *PlatformID);
+		UE_LOG(LogLeet, Verbose, TEXT("Object is: %s"), *GetName());
+
+		// Joins tend to arrive in bursts after travel, so collect them and send one request per window
+		PendingActivations.AddUnique(PlatformID);
+
+		bool requestSuccess = true;
+		if (PendingActivations.Num() >= MaxActivationBatchSize)
+		{
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] ActivatePlayer - batch full, flushing"));
+			requestSuccess = FlushPendingActivations();
+		}
+		else if (!ActivationFlushTickerHandle.IsValid())
+		{
+			ActivationFlushTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeetGameInstance::HandleActivationFlushTicker), ActivationBatchWindow);
+		}
+
+		return requestSuccess;
+		}
+	else {
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] AuthorizePlayer - TODO update record"));
+		return true;
+	}
+
+}
+
+void ULeetGameInstance::ActivateRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded)
+{
+	FLeetTraceScope TraceScope(TEXT("ActivateRequestComplete"), HttpRequest);
+	if (!HttpResponse.IsValid())
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Test failed. NULL response"));
+		return;
+	}
+
+	UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
+		*HttpRequest->GetVerb(),
+		*HttpRequest->GetURL(),
+		HttpResponse->GetResponseCode(),
+		HttpResponse->GetContent().Num());
+
+	FLeetApiDecoder::DecodeAsync(HttpResponse, this, &ULeetGameInstance::ApplyActivation);
+}
+
+void ULeetGameInstance::ApplyActivation(const FLeetPlayerActivationResult& Result)
+{
+	UE_LOG(LogLeet, Verbose, TEXT("Authorization"));
+	if (Result.bAuthorized)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization True"));
+		HandlePlayerActivationResult(Result);
+	}
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] Done!"));
+}
+
+bool ULeetGameInstance::HandleActivationFlushTicker(float DeltaTime)
+{
+	ActivationFlushTickerHandle.Reset();
+	FlushPendingActivations();
+	// One shot, the next ActivatePlayer opens a new window
+	return false;
+}
+
+bool ULeetGameInstance::FlushPendingActivations()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetBuildRequest);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] FlushPendingActivations: %d pending"), PendingActivations.Num());
+
+	if (ActivationFlushTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ActivationFlushTickerHandle);
+		ActivationFlushTickerHandle.Reset();
+	}
+
+	if (PendingActivations.Num() == 0)
+	{
+		return true;
+	}
+
+	TArray<FString> BatchPlatformIDs = PendingActivations;
+	PendingActivations.Empty();
+
+	FLeetTraceScope TraceScope(TEXT("FlushPendingActivations"));
+	for (int32 b = 0; b < BatchPlatformIDs.Num(); b++)
+	{
+		FLeetTrace::Get().Flow(FLeetTrace::JOIN_FLOW, BatchPlatformIDs[b], TEXT('t'));
+	}
+
+	FString nonceString = "10951350917635";
+	FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
+
+	FString OutputString = "nonce=" + nonceString + "&encryption=" + encryption;
+
+	if (ServerSessionHostAddress.Len() > 1) {
+		OutputString = OutputString + "&session_host_address=" + ServerSessionHostAddress + "&session_id=" + ServerSessionID;
+	}
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] ActivePlayers.Num() > 0"));
+	// A lone join goes through the single player endpoint
+	if (BatchPlatformIDs.Num() == 1)
+	{
+		FString APIURI = "/api/v2/player/" + BatchPlatformIDs[0] + "/activate";
+		return PerformHttpRequest(&ULeetGameInstance::ActivateRequestComplete, APIURI, OutputString);
+	}
 
-	for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
+	FString PlatformIDList;
+	for (int32 b = 0; b < BatchPlatformIDs.Num(); b++)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [AuthorizePlayer] platformID: %s"), *PlayerRecord.ActivePlayers[b].platformID);
-		if (PlayerRecord.ActivePlayers[b].platformID == PlatformID) {
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] AuthorizePlayer - FOUND MATCHING platformID"));
-			platformIDFound = true;
-			ActivePlayerIndex = b;
+		if (b > 0)
+		{
+			PlatformIDList += TEXT(",");
 		}
+		PlatformIDList += FPlatformHttp::UrlEncode(BatchPlatformIDs[b]);
 	}
+	OutputString = OutputString + "&platform_ids=" + PlatformIDList;
 
-	if (platformIDFound == false) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] AuthorizePlayer - No existing platformID found"));
+	FString APIURI = "/api/v2/players/activate";
 
-		// add the player to the TArray as authorized=false
-		FLeetActivePlayer activeplayer;
-		activeplayer.playerID = playerID;
-		activeplayer.platformID = PlatformID;
-		activeplayer.authorized = false;
-		activeplayer.roundDeaths = 0;
-		activeplayer.roundKills = 0;
+	return PerformHttpRequest(FHttpRequestCompleteDelegate::CreateUObject(this, &ULeetGameInstance::ActivateBatchRequestComplete, BatchPlatformIDs), APIURI, OutputString);
+}
 
-		PlayerRecord.ActivePlayers.Add(activeplayer);
+void ULeetGameInstance::ActivateBatchRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, TArray<FString> BatchPlatformIDs)
+{
+	FLeetTraceScope TraceScope(TEXT("ActivateBatchRequestComplete"), HttpRequest);
+	for (int32 b = 0; b < BatchPlatformIDs.Num(); b++)
+	{
+		FLeetTrace::Get().Flow(FLeetTrace::JOIN_FLOW, BatchPlatformIDs[b], TEXT('t'));
+	}
+
+	if (!HttpResponse.IsValid())
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [ActivateBatchRequestComplete] NULL response for %d players"), BatchPlatformIDs.Num());
+		return;
+	}
 
-		UE_LOG(LogTemp, Log, TEXT("PlatformID: %s"), *PlatformID);
-		UE_LOG(LogTemp, Log, TEXT("Object is: %s"), *GetName());
+	UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
+		*HttpRequest->GetVerb(),
+		*HttpRequest->GetURL(),
+		HttpResponse->GetResponseCode(),
+		HttpResponse->GetContent().Num());
 
+	// API without the batch endpoint, fall back to one request per player
+	if (HttpResponse->GetResponseCode() == EHttpResponseCodes::NotFound)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [ActivateBatchRequestComplete] Batch endpoint unavailable, activating one by one"));
 
 		FString nonceString = "10951350917635";
 		FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
 
 		FString OutputString = "nonce=" + nonceString + "&encryption=" + encryption;
 
-		UE_LOG(LogTemp, Log, TEXT("ServerSessionHostAddress: %s"), *ServerSessionHostAddress);
-		UE_LOG(LogTemp, Log, TEXT("ServerSessionID: %s"), *ServerSessionID);
-
 		if (ServerSessionHostAddress.Len() > 1) {
 			OutputString = OutputString + "&session_host_address=" + ServerSessionHostAddress + "&session_id=" + ServerSessionID;
 		}
 
-		FString APIURI = "/api/v2/player/" + PlatformID + "/activate";;
-
-		bool requestSuccess = PerformHttpRequest(&ULeetGameInstance::ActivateRequestComplete, APIURI, OutputString);
-
-		return requestSuccess;
+		for (int32 b = 0; b < BatchPlatformIDs.Num(); b++)
+		{
+			FString APIURI = "/api/v2/player/" + BatchPlatformIDs[b] + "/activate";
+			PerformHttpRequest(&ULeetGameInstance::ActivateRequestComplete, APIURI, OutputString);
 		}
-	else {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] AuthorizePlayer - TODO update record"));
-		return true;
+		return;
 	}
 
+	FLeetApiDecoder::DecodeAsync(HttpResponse, this, &ULeetGameInstance::ApplyActivationBatch);
 }
 
-void ULeetGameInstance::ActivateRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded)
+void ULeetGameInstance::ApplyActivationBatch(const FLeetActivationBatchResult& Result)
 {
-	if (!HttpResponse.IsValid())
+	if (Result.bAuthorized)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Test failed. NULL response"));
+		// Each player walks the controllers and may kick, queued one by one so a full batch is spread over frames
+		TWeakObjectPtr<ULeetGameInstance> WeakThis(this);
+		for (int32 b = 0; b < Result.Players.Num(); b++)
+		{
+			const FLeetPlayerActivationResult PlayerResult = Result.Players[b];
+			FLeetCompletionDispatcher::Get().Enqueue([WeakThis, PlayerResult]()
+			{
+				if (ULeetGameInstance* GameInstance = WeakThis.Get())
+				{
+					GameInstance->HandlePlayerActivationResult(PlayerResult);
+				}
+			});
+		}
 	}
 	else
 	{
-		UE_LOG(LogTemp, Log, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%s]"),
-			*HttpRequest->GetVerb(),
-			*HttpRequest->GetURL(),
-			HttpResponse->GetResponseCode(),
-			*HttpResponse->GetContentAsString());
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization False"));
+	}
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [ActivateBatchRequestComplete] Done!"));
+}
 
-		APlayerController* pc = NULL;
-		int32 playerstateID;
+void ULeetGameInstance::HandlePlayerActivationResult(const FLeetPlayerActivationResult& PlayerResult)
+{
+	FLeetTraceScope TraceScope(TEXT("HandlePlayerActivationResult"), PlayerResult.PlatformID);
+	FLeetTrace::Get().Flow(FLeetTrace::JOIN_FLOW, PlayerResult.PlatformID, PlayerResult.bPlayerAuthorized ? TEXT('t') : TEXT('f'));
+
+	APlayerController* pc = NULL;
+	int32 playerstateID;
+
+	if (PlayerResult.bPlayerAuthorized) {
+		UE_LOG(LogLeet, Verbose, TEXT("Player Authorized"));
+
+		FLeetActivePlayer* ActivatedPlayer = PlayerRegistry.FindByPlatformId(PlayerResult.PlatformID);
+		if (ActivatedPlayer) {
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [HandlePlayerActivationResult] - FOUND MATCHING platformID"));
+			ActivatedPlayer->authorized = true;
+			ActivatedPlayer->playerTitle = PlayerResult.PlayerName;
+			PlayerRegistry.SetPlayerKey(*ActivatedPlayer, PlayerResult.PlayerKey);
+			ActivatedPlayer->BTCHold = PlayerResult.BTCHold;
+			ActivatedPlayer->Rank = PlayerResult.Rank;
+			PlayerRegistry.SetGamePlayerKey(*ActivatedPlayer, PlayerResult.GamePlayerKey);
+
+			// Since we have a match, we also want to get all of the game player data associated with this player.
+			GetGamePlayer(PlayerResult.GamePlayerKey, true);
+		}
 
-		FString JsonRaw = *HttpResponse->GetContentAsString();
-		TSharedPtr<FJsonObject> JsonParsed;
-		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonRaw);
-		if (FJsonSerializer::Deserialize(JsonReader, JsonParsed))
+		// ALso set this player state playerName
+
+		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
 		{
-			bool Authorization = JsonParsed->GetBoolField("authorization");
-			UE_LOG(LogTemp, Log, TEXT("Authorization"));
-			if (Authorization)
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization True"));
-				bool PlayerAuthorized = JsonParsed->GetBoolField("player_authorized");
-				if (PlayerAuthorized) {
-					UE_LOG(LogTemp, Log, TEXT("Player Authorized"));
-
-					int32 activeAuthorizedPlayers = 0;
-					int32 activePlayerIndex;
-
-					// TODO refactor this using our get_by_id function
-
-					UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] ActivePlayers.Num() > 0"));
-					for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
-					{
-						UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] platformID: %s"), *PlayerRecord.ActivePlayers[b].platformID);
-						if (PlayerRecord.ActivePlayers[b].platformID == JsonParsed->GetStringField("player_platformid")) {
-							UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] - FOUND MATCHING platformID"));
-							activePlayerIndex = b;
-							PlayerRecord.ActivePlayers[b].authorized = true;
-							PlayerRecord.ActivePlayers[b].playerTitle = JsonParsed->GetStringField("player_name");
-							PlayerRecord.ActivePlayers[b].playerKey = JsonParsed->GetStringField("player_key");
-							PlayerRecord.ActivePlayers[b].BTCHold = JsonParsed->GetIntegerField("player_btchold");
-							PlayerRecord.ActivePlayers[b].Rank = JsonParsed->GetIntegerField("player_rank");
-							PlayerRecord.ActivePlayers[b].gamePlayerKey = JsonParsed->GetStringField("game_player_member_key");
-
-							// Since we have a match, we also want to get all of the game player data associated with this player.
-							
-
-							
-							GetGamePlayer(JsonParsed->GetStringField("game_player_member_key"), true);
-
-						}
-						if (PlayerRecord.ActivePlayers[b].authorized) {
-							activeAuthorizedPlayers++;
-						}
-
-					}
-
-					// ALso set this player state playerName
-
-					for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
-					{
-						UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] - Looking for player to set name"));
-						pc = Iterator->Get();
-						/*
-						
-						AMyPlayerController* thisPlayerController = Cast<AMyPlayerController>(pc);
-						if (thisPlayerController) {
-							UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [ActivateRequestComplete] - Cast Controller success"));
-
-							if (matchStarted) {
-								UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [ActivateRequestComplete] - Match in progress - setting spectator"));
-								thisPlayerController->PlayerState->bIsSpectator = true;
-								thisPlayerController->ChangeState(NAME_Spectating);
-								thisPlayerController->ClientGotoState(NAME_Spectating);
-							}
-							playerstateID = thisPlayerController->PlayerState->PlayerId;
-							if (ActivePlayers[activePlayerIndex].playerID == playerstateID)
-							{
-								UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [ActivateRequestComplete] - playerID match - setting name"));
-								thisPlayerController->PlayerState->SetPlayerName(JsonParsed->GetStringField("player_name"));
-							}
-						}
-						*/
-					}
-
-					/*
-					if (activeAuthorizedPlayers >= MinimumPlayersNeededToStart)
-					{
-						matchStarted = true;
-						// travel to the third person map
-						FString UrlString = TEXT("/Game/ThirdPersonCPP/Maps/ThirdPersonExampleMap?listen");
-						GetWorld()->GetAuthGameMode()->bUseSeamlessTravel = true;
-						GetWorld()->ServerTravel(UrlString);
-					}
-					*/
-
-					
+			pc = Iterator->Get();
+			/*
+			
+			AMyPlayerController* thisPlayerController = Cast<AMyPlayerController>(pc);
+			if (thisPlayerController) {
+				UE_LOG(LogLeet, Verbose, TEXT("[LEET] [UMyGameInstance] [HandlePlayerActivationResult] - Cast Controller success"));
 
+				if (matchStarted) {
+					UE_LOG(LogLeet, Verbose, TEXT("[LEET] [UMyGameInstance] [HandlePlayerActivationResult] - Match in progress - setting spectator"));
+					thisPlayerController->PlayerState->bIsSpectator = true;
+					thisPlayerController->ChangeState(NAME_Spectating);
+					thisPlayerController->ClientGotoState(NAME_Spectating);
 				}
-				else
+				playerstateID = thisPlayerController->PlayerState->PlayerId;
+				if (ActivePlayers[activePlayerIndex].playerID == playerstateID)
+				{
+					UE_LOG(LogLeet, Verbose, TEXT("[LEET] [UMyGameInstance] [HandlePlayerActivationResult] - playerID match - setting name"));
+					thisPlayerController->PlayerState->SetPlayerName(PlayerJson->GetStringField("player_name"));
+				}
+			}
+			*/
+		}
+
+		/*
+		if (activeAuthorizedPlayers >= MinimumPlayersNeededToStart)
+		{
+			matchStarted = true;
+			// travel to the third person map
+			FString UrlString = TEXT("/Game/ThirdPersonCPP/Maps/ThirdPersonExampleMap?listen");
+			GetWorld()->GetAuthGameMode()->bUseSeamlessTravel = true;
+			GetWorld()->ServerTravel(UrlString);
+		}
+		*/
+
+		
+
+	}
+	else
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Player NOT Authorized"));
+
+		// First grab the active player data from our registry
+		FString jsonPlatformID = PlayerResult.PlatformID;
+		FLeetActivePlayer* RejectedPlayer = PlayerRegistry.FindByPlatformId(jsonPlatformID);
+
+		if (RejectedPlayer)
+		{
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [HandlePlayerActivationResult] - PlatformID is found - moving to kick"));
+			for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+			{
+				pc = Iterator->Get();
+
+				playerstateID = pc->PlayerState->PlayerId;
+				if (RejectedPlayer->playerID == playerstateID)
 				{
-					UE_LOG(LogTemp, Log, TEXT("Player NOT Authorized"));
-
-					// First grab the active player data from our struct
-					int32 activePlayerIndex;
-					bool platformIDFound = false;
-					FString jsonPlatformID = JsonParsed->GetStringField("player_platformid");
-
-					for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
-					{
-						UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] platformID: %s"), *PlayerRecord.ActivePlayers[b].platformID);
-						UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] jsonPlatformID: %s"), *jsonPlatformID);
-						if (PlayerRecord.ActivePlayers[b].platformID == jsonPlatformID) {
-							UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] - Found active player record"));
-							platformIDFound = true;
-							activePlayerIndex = b;
-						}
-					}
-
-
-
-
-					if (platformIDFound)
-					{
-						UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] - PlatformID is found - moving to kick"));
-						for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
-						{
-							UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] - Looking for player to kick"));
-							pc = Iterator->Get();
-
-							playerstateID = pc->PlayerState->PlayerId;
-							if (PlayerRecord.ActivePlayers[activePlayerIndex].playerID == playerstateID)
-							{
-								UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] - playerID match - kicking back to connect"));
-								//FString UrlString = TEXT("/Game/MyConnectLevel");
-								//ETravelType seamlesstravel = TRAVEL_Absolute;
-								//thisPlayerController->ClientTravel(UrlString, seamlesstravel);
-								// trying a session kick instead.
-								// Get the Online Subsystem to work with
-								IOnlineSubsystem* const OnlineSub = IOnlineSubsystem::Get();
-								const FString kickReason = TEXT("Not Authorized");
-								const FText kickReasonText = FText::FromString(kickReason);
-								//ALeetGameSession::KickPlayer(pc, kickReasonText);
-								this->GetGameSession()->KickPlayer(pc, kickReasonText);
-
-							}
-							
-						}
-					}
+					UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [HandlePlayerActivationResult] - playerID match - kicking back to connect"));
+					//FString UrlString = TEXT("/Game/MyConnectLevel");
+					//ETravelType seamlesstravel = TRAVEL_Absolute;
+					//thisPlayerController->ClientTravel(UrlString, seamlesstravel);
+					// trying a session kick instead.
+					// Get the Online Subsystem to work with
+					IOnlineSubsystem* const OnlineSub = IOnlineSubsystem::Get();
+					const FString kickReason = TEXT("Not Authorized");
+					const FText kickReasonText = FText::FromString(kickReason);
+					//ALeetGameSession::KickPlayer(pc, kickReasonText);
+					this->GetGameSession()->KickPlayer(pc, kickReasonText);
+
 				}
+				
 			}
 		}
 	}
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [ActivateRequestComplete] Done!"));
 }
 
 bool ULeetGameInstance::GetGamePlayer(FString PlayerKey, bool bAttemptLock)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] GetGamePlayer"));
+	FLeetTraceScope TraceScope(TEXT("GetGamePlayer"), PlayerKey);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] GetGamePlayer"));
 
 	FString nonceString = "10951350917635";
 	FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
 
 	FString OutputString = "nonce=" + nonceString + "&encryption=" + encryption;
 
-	UE_LOG(LogTemp, Log, TEXT("ServerSessionHostAddress: %s"), *ServerSessionHostAddress);
-	UE_LOG(LogTemp, Log, TEXT("ServerSessionID: %s"), *ServerSessionID);
+	UE_LOG(LogLeet, Verbose, TEXT("ServerSessionHostAddress: %s"), *ServerSessionHostAddress);
+	UE_LOG(LogLeet, Verbose, TEXT("ServerSessionID: %s"), *ServerSessionID);
 
 	if (ServerSessionHostAddress.Len() > 1) {
 		OutputString = OutputString + "&session_host_address=" + ServerSessionHostAddress + "&session_id=" + ServerSessionID;
@@ -529,95 +795,93 @@ bool ULeetGameInstance::GetGamePlayer(FString PlayerKey, bool bAttemptLock)
 
 void ULeetGameInstance::GetGamePlayerRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded)
 {
+	FLeetTraceScope TraceScope(TEXT("GetGamePlayerRequestComplete"), HttpRequest);
 	if (!HttpResponse.IsValid())
 	{
-		UE_LOG(LogTemp, Log, TEXT("Test failed. NULL response"));
+		UE_LOG(LogLeet, Verbose, TEXT("Test failed. NULL response"));
+		return;
 	}
-	else
+
+	UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
+		*HttpRequest->GetVerb(),
+		*HttpRequest->GetURL(),
+		HttpResponse->GetResponseCode(),
+		HttpResponse->GetContent().Num());
+
+	FLeetApiDecoder::DecodeAsync(HttpResponse, this, &ULeetGameInstance::ApplyGamePlayer);
+}
+
+void ULeetGameInstance::ApplyGamePlayer(const FLeetGamePlayerResult& Result)
+{
+	UE_LOG(LogLeet, Verbose, TEXT("Authorization"));
+	if (Result.bAuthorized)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%s]"),
-			*HttpRequest->GetVerb(),
-			*HttpRequest->GetURL(),
-			HttpResponse->GetResponseCode(),
-			*HttpResponse->GetContentAsString());
-		FString JsonRaw = *HttpResponse->GetContentAsString();
-		TSharedPtr<FJsonObject> JsonParsed;
-		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonRaw);
-		if (FJsonSerializer::Deserialize(JsonReader, JsonParsed))
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization True"));
+		APlayerController* pc = NULL;
+		FString platformId = Result.PlatformID;
+
+		FLeetActivePlayer* activePlayer =  getPlayerByPlayerKey(Result.PlayerKey);
+		if (activePlayer == nullptr)
 		{
-			bool Authorization = JsonParsed->GetBoolField("authorization");
-			UE_LOG(LogTemp, Log, TEXT("Authorization"));
-			if (Authorization)
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization True"));
-				APlayerController* pc = NULL;
-				FString platformId = JsonParsed->GetStringField("platformId");
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [GetGamePlayerRequestComplete] - playerKey not registered"));
+			return;
+		}
 
-				FLeetActivePlayer* activePlayer =  getPlayerByPlayerKey(JsonParsed->GetStringField("playerKey"));
-				for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
-				{
-					UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [GetGamePlayerRequestComplete] - Looking for player Controller"));
-					pc = Iterator->Get();
-					APlayerState* thisPlayerState = pc->PlayerState;
-					ALeetPlayerState* thisMyPlayerState = Cast<ALeetPlayerState>(thisPlayerState);
-
-					FString playerstatePlatformID = thisMyPlayerState->platformId;
-					UE_LOG(LogTemp, Log, TEXT("playerstatePlatformID: %s"), *playerstatePlatformID);
-					FString playerArrayPlatformId = activePlayer->platformID;
-					UE_LOG(LogTemp, Log, TEXT("playerArrayPlatformId: %s"), *playerArrayPlatformId);
-
-					if (playerstatePlatformID == playerArrayPlatformId)
-					{
-						UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [GetGamePlayerRequestComplete] - platformID match - Setting Game player state"));
-					}
-				}
+		// Last step of the join
+		FLeetTraceScope TraceScope(TEXT("ApplyGamePlayer"), activePlayer->platformID);
+		FLeetTrace::Get().Flow(FLeetTrace::JOIN_FLOW, activePlayer->platformID, TEXT('f'));
+		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+		{
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [GetGamePlayerRequestComplete] - Looking for player Controller"));
+			pc = Iterator->Get();
+			APlayerState* thisPlayerState = pc->PlayerState;
+			ALeetPlayerState* thisMyPlayerState = Cast<ALeetPlayerState>(thisPlayerState);
+
+			FString playerstatePlatformID = thisMyPlayerState->platformId;
+			UE_LOG(LogLeet, Verbose, TEXT("playerstatePlatformID: %s"), *playerstatePlatformID);
+			FString playerArrayPlatformId = activePlayer->platformID;
+			UE_LOG(LogLeet, Verbose, TEXT("playerArrayPlatformId: %s"), *playerArrayPlatformId);
+
+			if (playerstatePlatformID == playerArrayPlatformId)
+			{
+				UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [GetGamePlayerRequestComplete] - platformID match - Setting Game player state"));
 			}
 		}
 	}
 }
 
 
-bool ULeetGameInstance::DeActivatePlayer(int32 playerID)
+bool ULeetGameInstance::DeActivatePlayer(int32 playerID, bool bJournal)
 {
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] DeActivatePlayer"));
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] DEBUG TEST"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] DeActivatePlayer"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] DEBUG TEST"));
 
 	// check to see if this player is in the active list already
-	bool playerIDFound = false;
-	int32 ActivePlayerIndex = 0;
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] check to see if this player is in the active list already"));
+	FLeetActivePlayer* LeavingPlayer = PlayerRegistry.FindByPlayerId(playerID);
 
-	//UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [AuthorizePlayer] ActivePlayers: %i"), ActivePlayers);
+	if (LeavingPlayer) {
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] DeAuthorizePlayer - existing playerID found"));
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] ActivePlayers.Num() > 0"));
-	for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
-	{
-		//UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [DeAuthorizePlayer] playerID: %s"), ActivePlayers[b].playerID);
-		if (PlayerRecord.ActivePlayers[b].playerID == playerID) {
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] DeActivatePlayer - FOUND MATCHING playerID"));
-			playerIDFound = true;
-			ActivePlayerIndex = b;
-		}
-
-	}
-
-
-	if (playerIDFound == true) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] DeAuthorizePlayer - existing playerID found"));
-
-		// update the TArray as authorized=false
+		// update the record as authorized=false
 		FLeetActivePlayer leavingplayer;
 		leavingplayer.playerID = playerID;
 		leavingplayer.authorized = false;
-		leavingplayer.platformID = PlayerRecord.ActivePlayers[ActivePlayerIndex].platformID;
+		leavingplayer.platformID = LeavingPlayer->platformID;
+
+		FString PlatformID = LeavingPlayer->platformID;
 
-		FString PlatformID = PlayerRecord.ActivePlayers[ActivePlayerIndex].platformID;
+		PlayerRegistry.Update(*LeavingPlayer, leavingplayer);
 
-		PlayerRecord.ActivePlayers[ActivePlayerIndex] = leavingplayer;
+		UE_LOG(LogLeet, Verbose, TEXT("PlatformID: %s"), *PlatformID);
+		UE_LOG(LogLeet, Verbose, TEXT("Object is: %s"), *GetName());
 
-		UE_LOG(LogTemp, Log, TEXT("PlatformID: %s"), *PlatformID);
-		UE_LOG(LogTemp, Log, TEXT("Object is: %s"), *GetName());
+		// Left before the activation batch went out, the API never heard of this player
+		if (PendingActivations.Remove(PlatformID) > 0)
+		{
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] DeAuthorizePlayer - activation still pending, dropped"));
+			return true;
+		}
 
 		FString nonceString = "10951350917635";
 		FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
@@ -633,63 +897,56 @@ bool ULeetGameInstance::DeActivatePlayer(int32 playerID)
 
 		FString APIURI = "/api/v2/player/" + PlatformID + "/deactivate";;
 
-		bool requestSuccess = PerformHttpRequest(&ULeetGameInstance::ActivateRequestComplete, APIURI, OutputString);
+		bool requestSuccess = bJournal
+			? PerformJournaledHttpRequest(&ULeetGameInstance::DeActivateRequestComplete, APIURI, OutputString)
+			: PerformHttpRequest(&ULeetGameInstance::DeActivateRequestComplete, APIURI, OutputString);
 
 		return requestSuccess;
 
 	}
 	else {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] DeAuthorizePlayer - Not found - Ignoring"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [UMyGameInstance] DeAuthorizePlayer - Not found - Ignoring"));
 	}
 	return true;
 
 }
 
-void ULeetGameInstance::DeActivateRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded)
+void ULeetGameInstance::LogApiStatus(const FLeetApiStatusResult& Result)
 {
-	if (!HttpResponse.IsValid())
+	UE_LOG(LogLeet, Verbose, TEXT("Authorization"));
+	if (Result.bAuthorized)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Test failed. NULL response"));
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization True"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Log, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%s]"),
-			*HttpRequest->GetVerb(),
-			*HttpRequest->GetURL(),
-			HttpResponse->GetResponseCode(),
-			*HttpResponse->GetContentAsString());
+		UE_LOG(LogLeet, Verbose, TEXT("Authorization False"));
+	}
+}
 
-		FString JsonRaw = *HttpResponse->GetContentAsString();
-		TSharedPtr<FJsonObject> JsonParsed;
-		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonRaw);
-		if (FJsonSerializer::Deserialize(JsonReader, JsonParsed))
-		{
-			bool Authorization = JsonParsed->GetBoolField("authorization");
-			//  We don't care too much about the results from this call.  
-			UE_LOG(LogTemp, Log, TEXT("Authorization"));
-			if (Authorization)
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization True"));
-			}
-			else
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization False"));
-			}
-		}
+void ULeetGameInstance::DeActivateRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded)
+{
+	if (!HttpResponse.IsValid())
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("Test failed. NULL response"));
+		return;
 	}
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [DeActivateRequestComplete] Done!"));
+
+	UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
+		*HttpRequest->GetVerb(),
+		*HttpRequest->GetURL(),
+		HttpResponse->GetResponseCode(),
+		HttpResponse->GetContent().Num());
+
+	//  We don't care too much about the results from this call.  
+	FLeetApiDecoder::DecodeAsync(HttpResponse, this, &ULeetGameInstance::LogApiStatus);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [DeActivateRequestComplete] Done!"));
 }
 
 bool ULeetGameInstance::OutgoingChat(int32 playerID, FText message)
 {
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] OutgoingChat"));
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] DEBUG TEST"));
-
-	// check to see if this player is in the active list already
-	bool playerIDFound = false;
-	int32 ActivePlayerIndex = 0;
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] check to see if this player is in the active list already"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] OutgoingChat"));
 
 	// Get our player record
 	FLeetActivePlayer* CurrentActivePlayer = getPlayerByPlayerId(playerID);
@@ -698,106 +955,205 @@ bool ULeetGameInstance::OutgoingChat(int32 playerID, FText message)
 		return false;
 	}
 
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] OutgoingChat - existing playerID found"));
+	// Chat logging is best effort, when the API falls behind the oldest lines go first
+	if (PendingChatLines.Num() >= MaxPendingChatLines)
+	{
+		const int32 NumToDrop = PendingChatLines.Num() - MaxPendingChatLines + 1;
+		PendingChatLines.RemoveAt(0, NumToDrop, false);
+		NumChatLinesDropped += NumToDrop;
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] OutgoingChat - queue full, %d dropped so far"), NumChatLinesDropped);
+	}
+	PendingChatLines.Add(FLeetPendingChatLine(CurrentActivePlayer->platformID, message.ToString()));
+	SetChatRelayStats(PendingChatLines);
 
-		FString PlatformID = CurrentActivePlayer->platformID;
+	if (PendingChatLines.Num() >= ChatRelayBatchSize && !bChatRelayInFlight)
+	{
+		return FlushOutgoingChat();
+	}
+	if (!ChatRelayTickerHandle.IsValid())
+	{
+		ChatRelayTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeetGameInstance::HandleChatRelayTicker), ChatRelayInterval);
+	}
+	return true;
+}
 
-		UE_LOG(LogTemp, Log, TEXT("PlatformID: %s"), *PlatformID);
-		UE_LOG(LogTemp, Log, TEXT("Object is: %s"), *GetName());
-		UE_LOG(LogTemp, Log, TEXT("message is: %s"), *message.ToString());
+bool ULeetGameInstance::HandleChatRelayTicker(float DeltaTime)
+{
+	ChatRelayTickerHandle.Reset();
+	FlushOutgoingChat();
+	// One shot, the next OutgoingChat starts a new interval
+	return false;
+}
 
-		FString nonceString = "10951350917635";
-		FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
+bool ULeetGameInstance::FlushOutgoingChat()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetBuildRequest);
+	if (ChatRelayTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ChatRelayTickerHandle);
+		ChatRelayTickerHandle.Reset();
+	}
 
-		FString OutputString;
+	if (PendingChatLines.Num() == 0)
+	{
+		return true;
+	}
 
-		// Build Params as text string
-		OutputString = "nonce=" + nonceString + "&encryption=" + encryption + "&message=" + message.ToString();
-		// urlencode the params
+	// One relay at a time, lines keep queueing (and the oldest dropping) until the API has caught up
+	if (bChatRelayInFlight)
+	{
+		ChatRelayTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeetGameInstance::HandleChatRelayTicker), ChatRelayInterval);
+		return true;
+	}
 
-		FString APIURI = "/api/v2/player/" + PlatformID + "/chat";
+	const int32 BatchSize = FMath::Min(ChatRelayBatchSize, PendingChatLines.Num());
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] FlushOutgoingChat: %d of %d pending"), BatchSize, PendingChatLines.Num());
 
-		bool requestSuccess = PerformHttpRequest(&ULeetGameInstance::OutgoingChatComplete, APIURI, OutputString);
+	FLeetFormJsonWriter MessagesWriter(BatchSize * CHAT_LINE_RESERVE_BYTES);
+	MessagesWriter.BeginArray();
+	for (int32 b = 0; b < BatchSize; b++)
+	{
+		MessagesWriter.BeginObject();
+		MessagesWriter.WriteKey(TEXT("platformID"));
+		MessagesWriter.WriteString(PendingChatLines[b].PlatformID);
+		MessagesWriter.WriteKey(TEXT("message"));
+		MessagesWriter.WriteString(PendingChatLines[b].Message);
+		MessagesWriter.EndObject();
+	}
+	MessagesWriter.EndArray();
+	InFlightChatLines.Empty(BatchSize);
+	InFlightChatLines.Append(PendingChatLines.GetData(), BatchSize);
+	PendingChatLines.RemoveAt(0, BatchSize, false);
+	SetChatRelayStats(PendingChatLines);
 
-		return requestSuccess;
+	FString nonceString = "10951350917635";
+	FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
+
+	FString OutputString = "nonce=" + nonceString + "&encryption=" + encryption + "&messages=" + MessagesWriter.ToString();
+
+	FString APIURI = "/api/v2/players/chat";
+
+	bChatRelayInFlight = PerformHttpRequest(&ULeetGameInstance::OutgoingChatComplete, APIURI, OutputString, ELeetTaskPriority::Low);
+	if (!bChatRelayInFlight)
+	{
+		RequeueInFlightChat();
+	}
 
+	// Whatever did not fit waits for the next interval
+	if (PendingChatLines.Num() > 0 && !ChatRelayTickerHandle.IsValid())
+	{
+		ChatRelayTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeetGameInstance::HandleChatRelayTicker), ChatRelayInterval);
+	}
+
+	return bChatRelayInFlight;
 }
 
 void ULeetGameInstance::OutgoingChatComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded)
 {
+	bChatRelayInFlight = false;
+
 	if (!HttpResponse.IsValid())
 	{
-		UE_LOG(LogTemp, Log, TEXT("Test failed. NULL response"));
+		UE_LOG(LogLeet, Verbose, TEXT("Test failed. NULL response"));
+		RequeueInFlightChat();
 	}
 	else
 	{
-		UE_LOG(LogTemp, Log, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%s]"),
+		UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
 			*HttpRequest->GetVerb(),
 			*HttpRequest->GetURL(),
 			HttpResponse->GetResponseCode(),
-			*HttpResponse->GetContentAsString());
+			HttpResponse->GetContent().Num());
+
+		// A server error, timeout or throttle means the lines never got logged, anything else the API has dealt with
+		if (FLeetHttpTransport::IsTransientResponseCode(HttpResponse->GetResponseCode()))
+		{
+			RequeueInFlightChat();
+		}
+		else
+		{
+			InFlightChatLines.Empty();
+		}
+	}
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [OutgoingChatComplete] Done!"));
+}
+
+void ULeetGameInstance::RequeueInFlightChat()
+{
+	if (InFlightChatLines.Num() == 0)
+	{
+		return;
+	}
+
+	PendingChatLines.Insert(InFlightChatLines, 0);
+	InFlightChatLines.Empty();
+
+	// The queue kept filling while the relay was out, the oldest lines still go first
+	if (PendingChatLines.Num() > MaxPendingChatLines)
+	{
+		const int32 NumToDrop = PendingChatLines.Num() - MaxPendingChatLines;
+		PendingChatLines.RemoveAt(0, NumToDrop, false);
+		NumChatLinesDropped += NumToDrop;
+	}
+	SetChatRelayStats(PendingChatLines);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] RequeueInFlightChat - %d pending, %d dropped so far"), PendingChatLines.Num(), NumChatLinesDropped);
 
-		FString JsonRaw = *HttpResponse->GetContentAsString();
-		//  We don't care too much about the results from this call.  
+	if (!ChatRelayTickerHandle.IsValid())
+	{
+		ChatRelayTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULeetGameInstance::HandleChatRelayTicker), ChatRelayInterval);
 	}
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [OutgoingChatComplete] Done!"));
 }
 
 bool ULeetGameInstance::SubmitMatchResults()
 {
+	SCOPE_CYCLE_COUNTER(STAT_LeetBuildRequest);
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] SubmitMatchResults"));
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] DEBUG TEST"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] SubmitMatchResults"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] DEBUG TEST"));
 
-	FString player_dict_list = "%5B";  //TODO build this string urlencoded from json properly
 	bool FoundKills = false;
-	// get the data ready
 
-	for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
+	// Encode the player list straight into the form value, sized from the players and their kills so a match never grows the buffer
+	int32 NumKilled = 0;
+	for (int32 b = 0; b < PlayerRegistry.Num(); b++)
 	{
-		//UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [DeAuthorizePlayer] playerID: %s"), ActivePlayers[b].playerID);
-		if (PlayerRecord.ActivePlayers[b].roundKills > 0) {
+		for (TConstSetBitIterator<> KilledIt(PlayerRegistry.GetPlayer(b).KilledHandles); KilledIt; ++KilledIt)
+		{
+			NumKilled++;
+		}
+	}
+	FLeetFormJsonWriter PlayerDictList(PlayerRegistry.Num() * PLAYER_RESULT_RESERVE_BYTES + NumKilled * KILL_RESULT_RESERVE_BYTES + 2);
+	PlayerDictList.BeginArray();
+	for (int32 b = 0; b < PlayerRegistry.Num(); b++)
+	{
+		const FLeetActivePlayer& Player = PlayerRegistry.GetPlayer(b);
+		if (Player.roundKills > 0) {
 			FoundKills = true;
 		}
-		player_dict_list = player_dict_list + "%7B%22deaths%22%3A" + FString::FromInt(PlayerRecord.ActivePlayers[b].roundDeaths) + "%2C";  // deaths
-		player_dict_list = player_dict_list + "%22killed%22%3A+%5B"; // killed -list, go through em.
-		for (int32 pkilledi = 0; pkilledi < PlayerRecord.ActivePlayers[b].killed.Num(); pkilledi++)
+		PlayerDictList.BeginObject();
+		PlayerDictList.WriteKey(TEXT("deaths"));
+		PlayerDictList.WriteInt(Player.roundDeaths);
+		PlayerDictList.WriteKey(TEXT("killed"));
+		PlayerDictList.BeginArray();
+		for (TConstSetBitIterator<> KilledIt(Player.KilledHandles); KilledIt; ++KilledIt)
 		{
-			player_dict_list = player_dict_list + "%22" + PlayerRecord.ActivePlayers[b].killed[pkilledi] + "%22";
-			if (pkilledi < PlayerRecord.ActivePlayers[b].killed.Num() - 1) {
-				// If it's not the last one add a comma.  I know this is dumb and should just be json
-				player_dict_list = player_dict_list + "%2C+";
-			}
-		}
-		player_dict_list = player_dict_list + "%5D%2C";
-		player_dict_list = player_dict_list + "%22platformID%22%3A%22" + PlayerRecord.ActivePlayers[b].platformID + "%22%2C";
-		player_dict_list = player_dict_list + "%22kills%22%3A+" + FString::FromInt(PlayerRecord.ActivePlayers[b].roundKills) + "%2C";
-		player_dict_list = player_dict_list + "%22experience%22%3A+" + FString::FromInt(PlayerRecord.ActivePlayers[b].roundKills) + "%2C";
-		player_dict_list = player_dict_list + "%22weapon%22%3A%22Bomb%22";
-		player_dict_list = player_dict_list + "%7D";
-		if (b < PlayerRecord.ActivePlayers.Num() - 1) {
-			// If it's not the last one add a comma.  I know this is dumb and should just be json
-			player_dict_list = player_dict_list + "%2C+";
+			PlayerDictList.WriteString(PlayerRegistry.GetKeyForHandle(KilledIt.GetIndex()));
 		}
+		PlayerDictList.EndArray();
+		PlayerDictList.WriteKey(TEXT("platformID"));
+		PlayerDictList.WriteString(Player.platformID);
+		PlayerDictList.WriteKey(TEXT("kills"));
+		PlayerDictList.WriteInt(Player.roundKills);
+		PlayerDictList.WriteKey(TEXT("experience"));
+		PlayerDictList.WriteInt(Player.roundKills);
+		PlayerDictList.WriteKey(TEXT("weapon"));
+		PlayerDictList.WriteString(TEXT("Bomb"));
+		PlayerDictList.EndObject();
 	}
-	player_dict_list = player_dict_list + "%5D";
-
-	// DOing this in pure json for comparison
-	FString json_string;
-	
-	FJsonObjectConverter::UStructToJsonObjectString(FLeetActivePlayers::StaticStruct(), &PlayerRecord, json_string,0 ,0);
-
-	UE_LOG(LogTemp, Log, TEXT("player_dict_list: %s"), *player_dict_list);
-	UE_LOG(LogTemp, Log, TEXT("json_string: %s"), *json_string);
+	PlayerDictList.EndArray();
 
 	if (FoundKills == true) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] SubmitMatchResults - found kills"));
-
-		FHttpModule* Http = &FHttpModule::Get();
-		if (!Http) { return false; }
-		if (!Http->IsHttpEnabled()) { return false; }
-
-		UE_LOG(LogTemp, Log, TEXT("Object is: %s"), *GetName());
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] SubmitMatchResults - found kills"));
 
 		FString nonceString = "10951350917635";
 		FString encryption = "off";  // Allowing unencrypted on sandbox for now.  
@@ -806,17 +1162,17 @@ bool ULeetGameInstance::SubmitMatchResults()
 		FString OutputString;
 
 		// Build Params as text string
-		OutputString = "nonce=" + nonceString + "&encryption=" + encryption + "&map_title=Demo&player_dict_list=" + player_dict_list;
+		OutputString = "nonce=" + nonceString + "&encryption=" + encryption + "&map_title=Demo&player_dict_list=" + PlayerDictList.ToString();
 
 		FString APIURI = "/api/v2/match/results";;
 
-		bool requestSuccess = PerformHttpRequest(&ULeetGameInstance::SubmitMatchResultsComplete, APIURI, OutputString);
+		bool requestSuccess = PerformJournaledHttpRequest(&ULeetGameInstance::SubmitMatchResultsComplete, APIURI, OutputString);
 
 		return requestSuccess;
 
 	}
 	else {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] SubmitMatchResults - No Kills - Ignoring"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] SubmitMatchResults - No Kills - Ignoring"));
 	}
 	return true;
 
@@ -826,35 +1182,19 @@ void ULeetGameInstance::SubmitMatchResultsComplete(FHttpRequestPtr HttpRequest,
 {
 	if (!HttpResponse.IsValid())
 	{
-		UE_LOG(LogTemp, Log, TEXT("Test failed. NULL response"));
+		UE_LOG(LogLeet, Verbose, TEXT("Test failed. NULL response"));
+		return;
 	}
-	else
-	{
-		UE_LOG(LogTemp, Log, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%s]"),
-			*HttpRequest->GetVerb(),
-			*HttpRequest->GetURL(),
-			HttpResponse->GetResponseCode(),
-			*HttpResponse->GetContentAsString());
 
-		FString JsonRaw = *HttpResponse->GetContentAsString();
-		TSharedPtr<FJsonObject> JsonParsed;
-		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonRaw);
-		if (FJsonSerializer::Deserialize(JsonReader, JsonParsed))
-		{
-			bool Authorization = JsonParsed->GetBoolField("authorization");
-			//  We don't care too much about the results from this call.  
-			UE_LOG(LogTemp, Log, TEXT("Authorization"));
-			if (Authorization)
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization True"));
-			}
-			else
-			{
-				UE_LOG(LogTemp, Log, TEXT("Authorization False"));
-			}
-		}
-	}
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [SubmitMatchResults] Done!"));
+	UE_LOG(LogLeet, Verbose, TEXT("Completed test [%s] Url=[%s] Response=[%d] [%d bytes]"),
+		*HttpRequest->GetVerb(),
+		*HttpRequest->GetURL(),
+		HttpResponse->GetResponseCode(),
+		HttpResponse->GetContent().Num());
+
+	//  We don't care too much about the results from this call.  
+	FLeetApiDecoder::DecodeAsync(HttpResponse, this, &ULeetGameInstance::LogApiStatus);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [SubmitMatchResults] Done!"));
 }
 
 
@@ -867,13 +1207,13 @@ void ULeetGameInstance::SubmitMatchResultsComplete(FHttpRequestPtr HttpRequest,
 void ULeetGameInstance::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
 {
 	//UE_LOG(LogOnlineGame, Verbose, TEXT("OnCreateSessionComplete %s bSuccess: %d"), *SessionName.ToString(), bWasSuccessful);
-	UE_LOG(LogTemp, Log, TEXT("[LEET] ULeetGameInstance::OnCreateSessionComplete"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] ULeetGameInstance::OnCreateSessionComplete"));
 }
 
 /** Initiates the session searching */
 bool ULeetGameInstance::FindSessions(ULocalPlayer* PlayerOwner, bool bFindLAN)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::FindSessions"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::FindSessions"));
 	bool bResult = false;
 
 	/*
@@ -883,14 +1223,20 @@ bool ULeetGameInstance::FindSessions(ULocalPlayer* PlayerOwner, bool bFindLAN)
 	check(PlayerOwner != nullptr);
 	if (PlayerOwner)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE Player Owner found"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE Player Owner found"));
 		ALeetGameSession* const GameSession = GetGameSession();
-		UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE got game session"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE got game session"));
 		if (GameSession)
 		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE Game session found"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE Game session found"));
 			GameSession->OnFindSessionsComplete().RemoveAll(this);
 			OnSearchSessionsCompleteDelegateHandle = GameSession->OnFindSessionsComplete().AddUObject(this, &ULeetGameInstance::OnSearchSessionsComplete);
+			GameSession->OnSearchResultsChanged().RemoveAll(this);
+			GameSession->OnSearchResultsChanged().AddUObject(this, &ULeetGameInstance::OnSearchResultsChanged);
+
+			// Rows of an earlier search don't match the new results
+			LeetSessionSearchResults.Empty();
+			OnSessionSearchResultsChanged.Broadcast();
 
 			GameSession->FindSessions(PlayerOwner->GetPreferredUniqueNetId(), GameSessionName, bFindLAN, true);
 
@@ -903,17 +1249,19 @@ bool ULeetGameInstance::FindSessions(ULocalPlayer* PlayerOwner, bool bFindLAN)
 /** Callback which is intended to be called upon finding sessions */
 void ULeetGameInstance::OnSearchSessionsComplete(bool bWasSuccessful)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::OnSearchSessionsComplete"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::OnSearchSessionsComplete"));
 	ALeetGameSession* const Session = GetGameSession();
 	if (Session)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::OnSearchSessionsComplete: Session found"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::OnSearchSessionsComplete: Session found"));
 		Session->OnFindSessionsComplete().Remove(OnSearchSessionsCompleteDelegateHandle);
 
 		//Session->GetSearchResults();
 
 		const TArray<FOnlineSessionSearchResult> & SearchResults = Session->GetSearchResults();
 
+		// The streamed rows should already match, rebuilt so they are in search order and complete either way
+		LeetSessionSearchResults.Empty(SearchResults.Num());
 		for (int32 IdxResult = 0; IdxResult < SearchResults.Num(); ++IdxResult)
 		{
 			//TSharedPtr<FServerEntry> NewServerEntry = MakeShareable(new FServerEntry());
@@ -923,22 +1271,88 @@ void ULeetGameInstance::OnSearchSessionsComplete(bool bWasSuccessful)
 			// setup a ustruct for bp
 			// add the results to the TArray 
 			FLeetSessionSearchResult searchresult;
-			searchresult.OwningUserName = Result.Session.OwningUserName;
-			searchresult.SearchIdx = IdxResult;
-			FName key = "serverTitle";
-			FString serverTitle;
-			bool settingsSuccess = Result.Session.SessionSettings.Get(key, serverTitle);
-			searchresult.ServerTitle = serverTitle;
-
+			FillLeetSessionSearchResult(Result, IdxResult, searchresult);
 			LeetSessionSearchResults.Add(searchresult);
 		}
+		OnSessionSearchResultsChanged.Broadcast();
+	}
+}
+
+void ULeetGameInstance::OnSearchResultsChanged(const FLeetSearchResultsDelta& Delta)
+{
+	ALeetGameSession* const Session = GetGameSession();
+	if (Session == nullptr)
+	{
+		return;
+	}
+
+	const TArray<FOnlineSessionSearchResult>& SearchResults = Session->GetSearchResults();
+	TMap<FString, int32> ResultIdxByKey;
+	ResultIdxByKey.Reserve(SearchResults.Num());
+	for (int32 IdxResult = 0; IdxResult < SearchResults.Num(); ++IdxResult)
+	{
+		ResultIdxByKey.Add(FLeetSearchResultsDelta::GetResultKey(SearchResults[IdxResult]), IdxResult);
+	}
+
+	for (int32 RowIdx = LeetSessionSearchResults.Num() - 1; RowIdx >= 0; RowIdx--)
+	{
+		if (Delta.Removed.Contains(LeetSessionSearchResults[RowIdx].ServerKey))
+		{
+			LeetSessionSearchResults.RemoveAt(RowIdx);
+		}
+	}
+
+	// Every row gets its SearchIdx back, removals move the results behind them
+	TMap<FString, int32> RowIdxByKey;
+	RowIdxByKey.Reserve(LeetSessionSearchResults.Num());
+	for (int32 RowIdx = 0; RowIdx < LeetSessionSearchResults.Num(); RowIdx++)
+	{
+		FLeetSessionSearchResult& Row = LeetSessionSearchResults[RowIdx];
+		const int32* ResultIdx = ResultIdxByKey.Find(Row.ServerKey);
+		Row.SearchIdx = ResultIdx ? *ResultIdx : INDEX_NONE;
+		RowIdxByKey.Add(Row.ServerKey, RowIdx);
+	}
+
+	for (const FString& Key : Delta.Updated)
+	{
+		const int32* ResultIdx = ResultIdxByKey.Find(Key);
+		const int32* RowIdx = RowIdxByKey.Find(Key);
+		if (ResultIdx && RowIdx)
+		{
+			FillLeetSessionSearchResult(SearchResults[*ResultIdx], *ResultIdx, LeetSessionSearchResults[*RowIdx]);
+		}
+	}
+
+	for (const FString& Key : Delta.Added)
+	{
+		const int32* ResultIdx = ResultIdxByKey.Find(Key);
+		if (ResultIdx && !RowIdxByKey.Contains(Key))
+		{
+			FLeetSessionSearchResult searchresult;
+			FillLeetSessionSearchResult(SearchResults[*ResultIdx], *ResultIdx, searchresult);
+			RowIdxByKey.Add(Key, LeetSessionSearchResults.Add(searchresult));
+		}
 	}
+
+	OnSessionSearchResultsChanged.Broadcast();
+}
+
+void ULeetGameInstance::FillLeetSessionSearchResult(const FOnlineSessionSearchResult& Result, int32 SearchIdx, FLeetSessionSearchResult& OutRow)
+{
+	OutRow.OwningUserName = Result.Session.OwningUserName;
+	OutRow.SearchIdx = SearchIdx;
+	FName key = "serverTitle";
+	FString serverTitle;
+	Result.Session.SessionSettings.Get(key, serverTitle);
+	OutRow.ServerTitle = serverTitle;
+	OutRow.ServerKey = FLeetSearchResultsDelta::GetResultKey(Result);
+	OutRow.PingInMs = Result.PingInMs;
 }
 
 
 void ULeetGameInstance::BeginWelcomeScreenState()
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::BeginWelcomeScreenState"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::BeginWelcomeScreenState"));
 	//this must come before split screen player removal so that the OSS sets all players to not using online features.
 	SetIsOnline(false);
 
@@ -1012,7 +1426,7 @@ bool ULeetGameInstance::JoinSession(ULocalPlayer* LocalPlayer, int32 SessionInde
 {
 	// needs to tear anything down based on current state?
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::JoinSession 1"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::JoinSession 1"));
 
 
 	ALeetGameSession* const GameSession = GetGameSession();
@@ -1041,7 +1455,7 @@ bool ULeetGameInstance::JoinSession(ULocalPlayer* LocalPlayer, int32 SessionInde
 
 bool ULeetGameInstance::JoinSession(ULocalPlayer* LocalPlayer, const FOnlineSessionSearchResult& SearchResult)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::JoinSession 2"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::JoinSession 2"));
 	// needs to tear anything down based on current state?
 	ALeetGameSession* const GameSession = GetGameSession();
 	if (GameSession)
@@ -1075,7 +1489,7 @@ bool ULeetGameInstance::JoinSession(ULocalPlayer* LocalPlayer, const FOnlineSess
 */
 void ULeetGameInstance::OnJoinSessionComplete(EOnJoinSessionCompleteResult::Type Result)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::OnJoinSessionComplete"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::OnJoinSessionComplete"));
 	// unhook the delegate
 	ALeetGameSession* const GameSession = GetGameSession();
 	if (GameSession)
@@ -1320,7 +1734,7 @@ void ULeetGameInstance::CleanupSessionOnReturnToMenu()
 
 bool ULeetGameInstance::RegisterNewSession(FString IncServerSessionHostAddress, FString IncServerSessionID)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::RegisterNewSession"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::RegisterNewSession"));
 	ServerSessionHostAddress = IncServerSessionHostAddress;
 	ServerSessionID = IncServerSessionID;
 	GetServerInfo();
@@ -1411,7 +1825,7 @@ void ULeetGameInstance::HandleSignInChangeMessaging()
 
 void ULeetGameInstance::BeginLogin(FString InType, FString InId, FString InToken)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::BeginLogin"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME INSTANCE ULeetGameInstance::BeginLogin"));
 
 	const auto OnlineSub = IOnlineSubsystem::Get();
 	if (OnlineSub)
@@ -1428,135 +1842,76 @@ void ULeetGameInstance::BeginLogin(FString InType, FString InId, FString InToken
 
 FLeetActivePlayer* ULeetGameInstance::getPlayerByPlayerId(int32 playerID)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] getPlayerByPlayerID"));
-	for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
-	{
-		if (PlayerRecord.ActivePlayers[b].playerID == playerID) {
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] getPlayerByPlayerID - FOUND MATCHING playerID"));
-			FLeetActivePlayer* playerPointer = &PlayerRecord.ActivePlayers[b];
-			return playerPointer;
-		}
-	}
-	return nullptr;
+	return PlayerRegistry.FindByPlayerId(playerID);
 }
 
 FLeetActivePlayer* ULeetGameInstance::getPlayerByPlayerKey(FString playerKey)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] getPlayerByPlayerKey"));
-	for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
-	{
-		if (PlayerRecord.ActivePlayers[b].playerKey == playerKey) {
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] getPlayerByPlayerKey - FOUND MATCHING playerID"));
-			FLeetActivePlayer* playerPointer = &PlayerRecord.ActivePlayers[b];
-			return playerPointer;
-		}
-	}
-	return nullptr;
+	return PlayerRegistry.FindByPlayerKey(playerKey);
 }
 
-bool ULeetGameInstance::RecordKill(int32 killerPlayerID, int32 victimPlayerID)
+FLeetActivePlayer* ULeetGameInstance::getPlayerByPlatformId(FString platformID)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] "));
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] killerPlayerID: %i"), killerPlayerID);
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] victimPlayerID: %i "), victimPlayerID);
+	return PlayerRegistry.FindByPlatformId(platformID);
+}
 
-	// get attacker activeplayer
-	bool attackerPlayerIDFound = false;
-	int32 killerPlayerIndex = 0;
-	// sum all the round kills while we're looping
-	int32 roundKillsTotal = 0;
+FLeetActivePlayer* ULeetGameInstance::getPlayerByGamePlayerKey(FString gamePlayerKey)
+{
+	return PlayerRegistry.FindByGamePlayerKey(gamePlayerKey);
+}
 
-	// TODO refactor this to use our get player function instead
+bool ULeetGameInstance::RecordKill(int32 killerPlayerID, int32 victimPlayerID)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetRecordKill);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] "));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] killerPlayerID: %i"), killerPlayerID);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] victimPlayerID: %i "), victimPlayerID);
 
-	for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
-	{
-		//UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [DeAuthorizePlayer] playerID: %s"), ActivePlayers[b].playerID);
-		if (PlayerRecord.ActivePlayers[b].playerID == killerPlayerID) {
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - FOUND MATCHING killer playerID"));
-			attackerPlayerIDFound = true;
-			killerPlayerIndex = b;
-		}
-		roundKillsTotal = roundKillsTotal + PlayerRecord.ActivePlayers[b].roundKills;
+	// get attacker activeplayer
+	FLeetActivePlayer* Killer = PlayerRegistry.FindByPlayerId(killerPlayerID);
+	if (Killer == nullptr) {
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - killer not registered, ignoring"));
+		return false;
 	}
-	// we need one more since this kill has not been added to the list yet
-	roundKillsTotal = roundKillsTotal + 1;
 
 	if (killerPlayerID == victimPlayerID) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] suicide"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] suicide"));
 	}
 	else {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] Not a suicide"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] Not a suicide"));
 
 		// get victim activeplayer
-		bool victimPlayerIDFound = false;
-		int32 victimPlayerIndex = 0;
-
-		for (int32 b = 0; b < PlayerRecord.ActivePlayers.Num(); b++)
-		{
-			//UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [DeAuthorizePlayer] playerID: %s"), ActivePlayers[b].playerID);
-			if (PlayerRecord.ActivePlayers[b].playerID == victimPlayerID) {
-				UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - FOUND MATCHING victim playerID"));
-				victimPlayerIDFound = true;
-				victimPlayerIndex = b;
-			}
+		FLeetActivePlayer* Victim = PlayerRegistry.FindByPlayerId(victimPlayerID);
+		if (Victim == nullptr) {
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - victim not registered, ignoring"));
+			return false;
 		}
 
 		// check to see if this victim is already in the kill list
-		bool victimIDFoundInKillList = false;
-
-		for (int32 b = 0; b < PlayerRecord.ActivePlayers[killerPlayerIndex].killed.Num(); b++)
-		{
-			if (PlayerRecord.ActivePlayers[killerPlayerIndex].killed[b] == PlayerRecord.ActivePlayers[victimPlayerIndex].playerKey)
-			{
-				UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Victim already in kill list"));
-				victimIDFoundInKillList = true;
-			}
-		}
-
-		if (victimIDFoundInKillList == false) {
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Adding victim to kill list"));
-			PlayerRecord.ActivePlayers[killerPlayerIndex].killed.Add(PlayerRecord.ActivePlayers[victimPlayerIndex].playerKey);
+		if (PlayerRegistry.AddKill(*Killer, *Victim)) {
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Adding victim to kill list"));
 		}
 
 		// Increase the killer's kill count
-		PlayerRecord.ActivePlayers[killerPlayerIndex].roundKills = PlayerRecord.ActivePlayers[killerPlayerIndex].roundKills + 1;
+		Killer->roundKills = Killer->roundKills + 1;
 		// Increase the killer's balance
-		PlayerRecord.ActivePlayers[killerPlayerIndex].BTCHold = PlayerRecord.ActivePlayers[killerPlayerIndex].BTCHold + killRewardBTC;
+		Killer->BTCHold = Killer->BTCHold + killRewardBTC;
 		// And increase the victim's deaths
-		PlayerRecord.ActivePlayers[victimPlayerIndex].roundDeaths = PlayerRecord.ActivePlayers[victimPlayerIndex].roundDeaths + 1;
+		Victim->roundDeaths = Victim->roundDeaths + 1;
 		// Decrease the victim's balance
-		PlayerRecord.ActivePlayers[victimPlayerIndex].BTCHold = PlayerRecord.ActivePlayers[victimPlayerIndex].BTCHold - incrementBTC;
+		Victim->BTCHold = Victim->BTCHold - incrementBTC;
 
 		// TODO kick the victim if it falls below the minimum?
 
-		APlayerController* pc = NULL;
 		// Send out a chat message to all players
-		FText chatSender = NSLOCTEXT("LEET", "chatSender", "SYSTEM");
-		FText chatMessageText = NSLOCTEXT("LEET", "chatMessageText", " killed ");  //TODO figure out how to set up this string correctly.
+		FString chatSender = TEXT("SYSTEM");
+		FString chatMessageText = TEXT(" killed ");  //TODO figure out how to set up this string correctly.
 
-		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+		ALeetGameState* TheGameState = Cast<ALeetGameState>(GetWorld()->GameState);
+		if (TheGameState)
 		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Sending text chat"));
-			pc = Iterator->Get();
-			APlayerState* thisPlayerState = pc->PlayerState;
-			ALeetPlayerState* thisMyPlayerState = Cast<ALeetPlayerState>(thisPlayerState);
-			thisMyPlayerState->ReceiveChatMessage(chatSender, chatMessageText);
-
-			/*
-			// old way
-			TSubclassOf<APlayerController> thisPlayerController = pc;
-			AMyPlayerController* thisPlayerController = Cast<AMyPlayerController>(pc);
-			if (thisPlayerController) {
-				UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Cast Controller success"));
-
-				APlayerState* thisPlayerState = thisPlayerController->PlayerState;
-				AMyPlayerState* thisMyPlayerState = Cast<AMyPlayerState>(thisPlayerState);
-				if (thisMyPlayerState) {
-					UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Cast State success"));
-					thisMyPlayerState->ReceiveChatMessage(chatSender, chatMessageText);
-				}
-			}
-			*/
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Sending text chat"));
+			TheGameState->QueueChatLine(chatSender, chatMessageText);
 		}
 
 
@@ -1566,7 +1921,7 @@ bool ULeetGameInstance::RecordKill(int32 killerPlayerID, int32 victimPlayerID)
 	/*
 	//Check to see if the game is over
 	if (roundKillsTotal >= MinimumKillsBeforeResultsSubmit) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Ending the Game"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ULeetGameInstance] [RecordKill] - Ending the Game"));
 		bool gamesubmitted = SubmitMatchResults();
 
 		//Deauthorize everyone
@@ -1588,7 +1943,7 @@ bool ULeetGameInstance::RecordKill(int32 killerPlayerID, int32 victimPlayerID)
 	else {
 		// Check to see if the round is over
 		if (roundKillsTotal >= MinimumPlayerDeathsBeforeRoundReset) {
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [UMyGameInstance] [RecordKill] - Ending the Round"));
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] [UMyGameInstance] [RecordKill] - Ending the Round"));
 			// travel to the third person map
 			FString UrlString = TEXT("/Game/ThirdPersonCPP/Maps/ThirdPersonExampleMap?listen");
 			GetWorld()->GetAuthGameMode()->bUseSeamlessTravel = true;
@@ -1600,4 +1955,27 @@ bool ULeetGameInstance::RecordKill(int32 killerPlayerID, int32 victimPlayerID)
 
 
 	return true;
-}
\ No newline at end of file
+}
+
+void ULeetGameInstance::DumpServerLinks(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet server links: %d cached"), ServerLinks.links.Num());
+	for (int32 b = 0; b < ServerLinks.links.Num(); b++)
+	{
+		const FLeetServerLink& Link = ServerLinks.links[b];
+		Ar.Logf(TEXT("  %s (%s): %s%s%s, %d BTC to travel"), *Link.targetServerTitle, *Link.targetServerKey,
+			Link.targetStatusOnline ? TEXT("online") : TEXT("offline"), Link.targetStatusFull ? TEXT(", full") : TEXT(""), Link.targetStatusDead ? TEXT(", dead") : TEXT(""),
+			Link.btcCostToTravel);
+	}
+}
+
+void ULeetGameInstance::DumpChatRelay(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet chat relay: %d pending (max %d), batches of %d every %.1fs, %s, %d dropped"),
+		PendingChatLines.Num(), MaxPendingChatLines, ChatRelayBatchSize, ChatRelayInterval, bChatRelayInFlight ? TEXT("relay in flight") : TEXT("idle"), NumChatLinesDropped);
+}
+
+void ULeetGameInstance::DumpPendingActivations(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet activations: %d waiting for the batch window (%.2fs, max %d)"), PendingActivations.Num(), ActivationBatchWindow, MaxActivationBatchSize);
+}
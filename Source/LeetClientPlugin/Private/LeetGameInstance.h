@@ -29,9 +29,32 @@ namespace std { typedef type_info type_info; }
 #include "JsonUtilities.h"
 #include "Base64.h"
 #include <string>
+#include "LeetPlayerRegistry.h"
+#include "LeetAsyncScheduler.h"
 
 #include "LeetGameInstance.generated.h"
 
+struct FLeetServerInfoResult;
+struct FLeetServerLinksResult;
+struct FLeetPlayerActivationResult;
+struct FLeetActivationBatchResult;
+struct FLeetGamePlayerResult;
+struct FLeetApiStatusResult;
+struct FLeetSearchResultsDelta;
+
+/** A chat line waiting for the next upstream chat relay */
+struct FLeetPendingChatLine
+{
+	FString PlatformID;
+	FString Message;
+
+	FLeetPendingChatLine(const FString& InPlatformID, const FString& InMessage)
+		: PlatformID(InPlatformID)
+		, Message(InMessage)
+	{
+	}
+};
+
 
 USTRUCT(BlueprintType)
 struct FLeetSessionSearchResult {
@@ -46,8 +69,17 @@ struct FLeetSessionSearchResult {
 
 	UPROPERTY(BlueprintReadWrite)
 		int32 SearchIdx;
+
+	/** Names the result across updates of a streaming search, SearchIdx moves when results are removed */
+	UPROPERTY(BlueprintReadWrite)
+		FString ServerKey;
+
+	UPROPERTY(BlueprintReadWrite)
+		int32 PingInMs;
 };
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnLeetSessionSearchResultsChanged);
+
 USTRUCT()
 struct FLeetActivePlayer {
 
@@ -66,6 +98,7 @@ struct FLeetActivePlayer {
 	int32 roundKills;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "LEET")
 	int32 roundDeaths;
+	/** playerKeys of the victims, only filled in when the players are exported, kills are tracked in KilledHandles */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "LEET")
 	TArray<FString> killed;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "LEET")
@@ -75,6 +108,11 @@ struct FLeetActivePlayer {
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "LEET")
 	FString gamePlayerKey;
 
+	/** Interned playerKey, assigned by FLeetPlayerRegistry, INDEX_NONE until the player is activated */
+	int32 KeyHandle;
+	/** Victims of this player, one bit per KeyHandle */
+	TBitArray<> KilledHandles;
+
 };
 
 USTRUCT()
@@ -176,16 +214,27 @@ class LEETCLIENTPLUGIN_API ULeetGameInstance : public UGameInstance
 
 	// Moving this to a struct for easy JSON encode/decode
 	//TArray<FLeetActivePlayer> ActivePlayers;
-	FLeetActivePlayers PlayerRecord;
+	// Indexed by every id we look players up with, Export() gives back the FLeetActivePlayers JSON shape
+	FLeetPlayerRegistry PlayerRegistry;
 
 	FLeetServerLinks ServerLinks;
 
-	bool PerformHttpRequest(void(ULeetGameInstance::*delegateCallback)(FHttpRequestPtr, FHttpResponsePtr, bool), FString APIURI, FString ArgumentString);
+	// Calls are queued on the online subsystem's async task manager when it is up, Priority orders them when too many are pending
+	bool PerformHttpRequest(void(ULeetGameInstance::*delegateCallback)(FHttpRequestPtr, FHttpResponsePtr, bool), FString APIURI, FString ArgumentString, ELeetTaskPriority::Type Priority = ELeetTaskPriority::Normal);
+	bool PerformHttpRequest(const FHttpRequestCompleteDelegate& CompleteDelegate, FString APIURI, FString ArgumentString, const FString& IdempotencyKey = FString(), ELeetTaskPriority::Type Priority = ELeetTaskPriority::Normal);
+
+	// State changing calls go through the journal so they survive a crash or a network loss
+	bool PerformJournaledHttpRequest(void(ULeetGameInstance::*delegateCallback)(FHttpRequestPtr, FHttpResponsePtr, bool), FString APIURI, FString ArgumentString);
+	void JournaledRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, FString EntryId, FHttpRequestCompleteDelegate CallerDelegate);
+
+	// Write ahead journal of state changing calls, opened in Init
+	TSharedPtr<class FLeetJournal> Journal;
 
 public:
 	
 	ALeetGameSession* GetGameSession() const;
 	virtual void Init() override;
+	virtual void Shutdown() override;
 
 	/**
 	*	Find an online session
@@ -238,6 +287,10 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	TArray<FLeetSessionSearchResult> LeetSessionSearchResults;
 
+	/** Fired whenever LeetSessionSearchResults changed, while the search runs and once it completed */
+	UPROPERTY(BlueprintAssignable, Category = "LEET")
+	FOnLeetSessionSearchResultsChanged OnSessionSearchResultsChanged;
+
 	// Holds session search results
 	TSharedPtr<class FOnlineSessionSearch> SessionSearch;
 
@@ -265,11 +318,20 @@ public:
 	bool ActivatePlayer(FString PlatformID, int32 playerID);
 	void ActivateRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded);
 
-	bool DeActivatePlayer(int32 playerID);
+	// Send all queued activations now instead of waiting for the batch window to close
+	bool FlushPendingActivations();
+	void ActivateBatchRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, TArray<FString> BatchPlatformIDs);
+
+	// bJournal false leaves the request out of the journal, for players that only exist against a test API
+	bool DeActivatePlayer(int32 playerID, bool bJournal = true);
 	void DeActivateRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded);
 
+	// Queues a chat line for the next relay to the API, lines from every player go up together
 	bool OutgoingChat(int32 playerID, FText message);
+	bool FlushOutgoingChat();
 	void OutgoingChatComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded);
+	// Puts a relay that did not make it back in front of the queue, so it goes out with the next one
+	void RequeueInFlightChat();
 
 	bool SubmitMatchResults();
 	void SubmitMatchResultsComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded);
@@ -277,9 +339,23 @@ public:
 	bool GetGamePlayer(FString PlayerKey, bool bAttemptLock);
 	void GetGamePlayerRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded);
 
-	// Get a player out of our custom array struct
+	// Get a player out of the registry.  The pointers stay valid until the player is removed
 	FLeetActivePlayer* getPlayerByPlayerId(int32 playerID);
 	FLeetActivePlayer* getPlayerByPlayerKey(FString playerKey);
+	FLeetActivePlayer* getPlayerByPlatformId(FString platformID);
+	FLeetActivePlayer* getPlayerByGamePlayerKey(FString gamePlayerKey);
+
+	// Last server links answered by the API, used by the /links chat command
+	const FLeetServerLinks& GetCachedServerLinks() const { return ServerLinks; }
+
+	// Chat rate limit every player state starts with
+	int32 GetChatBurst() const { return ChatBurst; }
+	float GetChatRefillPerSecond() const { return ChatRefillPerSecond; }
+
+	// Diagnostics for the LEET console commands
+	void DumpServerLinks(FOutputDevice& Ar) const;
+	void DumpChatRelay(FOutputDevice& Ar) const;
+	void DumpPendingActivations(FOutputDevice& Ar) const;
 
 	// A Kill occurred.
 	// Record it.
@@ -301,6 +377,65 @@ private:
 
 	FString _configPath = "";
 
+	/** Platform ids of joining players waiting for the next batched activation */
+	TArray<FString> PendingActivations;
+
+	/** Ticker that closes the current activation batch window */
+	FDelegateHandle ActivationFlushTickerHandle;
+
+	/** How long activations are collected before being sent, in seconds.  0 flushes on the next tick */
+	float ActivationBatchWindow;
+
+	/** Flush early once this many activations are queued */
+	int32 MaxActivationBatchSize;
+
+	/** Chat lines a player may send back to back */
+	int32 ChatBurst;
+
+	/** Chat lines a player earns back per second once the burst is spent */
+	float ChatRefillPerSecond;
+
+	/** Chat lines waiting for the next relay, oldest first */
+	TArray<FLeetPendingChatLine> PendingChatLines;
+
+	/** Lines of the relay that is out, kept until the API has taken them */
+	TArray<FLeetPendingChatLine> InFlightChatLines;
+
+	/** Ticker that sends the pending chat lines */
+	FDelegateHandle ChatRelayTickerHandle;
+
+	/** How long chat lines are collected before being relayed, in seconds */
+	float ChatRelayInterval;
+
+	/** Relay early once this many lines are queued */
+	int32 ChatRelayBatchSize;
+
+	/** Most lines kept while a relay is still out, the oldest are dropped beyond that */
+	int32 MaxPendingChatLines;
+
+	/** Set while a relay request is out, the next one waits for it */
+	bool bChatRelayInFlight;
+
+	/** Lines dropped because the queue was full */
+	int32 NumChatLinesDropped;
+
+	/** Ticker callback for the chat relay interval */
+	bool HandleChatRelayTicker(float DeltaTime);
+
+	/** Ticker callback for the activation batch window */
+	bool HandleActivationFlushTicker(float DeltaTime);
+
+	/** Applies the activation result of a single player, shared by the single and batched endpoints */
+	void HandlePlayerActivationResult(const FLeetPlayerActivationResult& PlayerResult);
+
+	/** Game thread halves of the *Complete callbacks, called once the response has been decoded off thread */
+	void ApplyServerInfo(const FLeetServerInfoResult& Result);
+	void ApplyServerLinks(const FLeetServerLinksResult& Result);
+	void ApplyActivation(const FLeetPlayerActivationResult& Result);
+	void ApplyActivationBatch(const FLeetActivationBatchResult& Result);
+	void ApplyGamePlayer(const FLeetGamePlayerResult& Result);
+	void LogApiStatus(const FLeetApiStatusResult& Result);
+
 	/** Whether the match is online or not */
 	bool bIsOnline;
 
@@ -325,6 +460,10 @@ private:
 
 	/** Callback which is intended to be called upon finding sessions */
 	void OnSearchSessionsComplete(bool bWasSuccessful);
+	/** Patches LeetSessionSearchResults with a batch of changes to the running search */
+	void OnSearchResultsChanged(const FLeetSearchResultsDelta& Delta);
+	/** Fills a row of LeetSessionSearchResults from a search result */
+	static void FillLeetSessionSearchResult(const FOnlineSessionSearchResult& Result, int32 SearchIdx, FLeetSessionSearchResult& OutRow);
 	/** Callback which is intended to be called upon joining session */
 	void OnJoinSessionComplete(EOnJoinSessionCompleteResult::Type Result);
 	/** Called after all the local players are registered in a session we're joining */
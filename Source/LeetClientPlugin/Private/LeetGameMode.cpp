@@ -12,6 +12,7 @@ ALeetGameMode::ALeetGameMode(const FObjectInitializer& ObjectInitializer) : Supe
 	// set default pawn class to our flying pawn
 	DefaultPawnClass = ALeetPawn::StaticClass();
 	PlayerStateClass = ALeetPlayerState::StaticClass();
+	GameStateClass = ALeetGameState::StaticClass();
 
 }
 
@@ -24,7 +25,7 @@ TSubclassOf<AGameSession> ALeetGameMode::GetGameSessionClass() const
 
 void ALeetGameMode::PreLogin(const FString& Options, const FString& Address, const TSharedPtr<const FUniqueNetId>& UniqueId, FString& ErrorMessage)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] PreLogin"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] PreLogin"));
 	/*
 	Ideally we could do activate here, but we don't have the playerID
 	*/
@@ -34,17 +35,21 @@ void ALeetGameMode::PreLogin(const FString& Options, const FString& Address, con
 FString ALeetGameMode::InitNewPlayer(APlayerController* NewPlayerController, const TSharedPtr<const FUniqueNetId>& UniqueId, const FString& Options, const FString& Portal)
 {
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] InitNewPlayer"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] InitNewPlayer"));
 
 	check(NewPlayerController);
 	int32 playerId = NewPlayerController->PlayerState->PlayerId;
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] InitNewPlayer playerId: %d"), playerId);
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] InitNewPlayer Options: %s"), *Options);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] InitNewPlayer playerId: %d"), playerId);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] InitNewPlayer Options: %s"), *Options);
 
 	FString Name = UGameplayStatics::ParseOption(Options, TEXT("Name"));
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] InitNewPlayer Param1: %s"), *Name);
+	// First step of the player's join trace
+	FLeetTraceScope TraceScope(TEXT("InitNewPlayer"), Name);
+	FLeetTrace::Get().Flow(FLeetTrace::JOIN_FLOW, Name, TEXT('s'));
+
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] InitNewPlayer Param1: %s"), *Name);
 
 	FString ErrorMessage;
 
@@ -53,9 +58,9 @@ FString ALeetGameMode::InitNewPlayer(APlayerController* NewPlayerController, con
 
 	if (PlayerS)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] [InitNewPlayer] - Found Leet player state"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] [InitNewPlayer] - Found Leet player state"));
 		PlayerS->platformId = Name;
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] [InitNewPlayer] - Set platformID"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] [InitNewPlayer] - Set platformID"));
 	}
 
 
@@ -99,13 +104,13 @@ FString ALeetGameMode::InitNewPlayer(APlayerController* NewPlayerController, con
 void ALeetGameMode::Logout(AController* Exiting)
 {
 	// Handle users that disconnect from the server.
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] [Logout] "));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] [Logout] "));
 	Super::Logout(Exiting);
 
 	//AMyPlayerState* ExitingPlayerState = Cast<AMyPlayerState>(Exiting->PlayerState);
 	//int ExitingPlayerId = ExitingPlayerState->PlayerId;
 
-	//UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameMode] [Logout] ExitingPlayerId: %i"), ExitingPlayerId);
+	//UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameMode] [Logout] ExitingPlayerId: %i"), ExitingPlayerId);
 
 	ULeetGameInstance* TheGameInstance = Cast<ULeetGameInstance>(GetWorld()->GetGameInstance());
 
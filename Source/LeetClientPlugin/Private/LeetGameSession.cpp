@@ -11,10 +11,10 @@ namespace
 ALeetGameSession::ALeetGameSession(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::ALeetGameSession"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::ALeetGameSession"));
 	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::ALeetGameSession !HasAnyFlags"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::ALeetGameSession !HasAnyFlags"));
 		OnCreateSessionCompleteDelegate = FOnCreateSessionCompleteDelegate::CreateUObject(this, &ALeetGameSession::OnCreateSessionComplete);
 		OnDestroySessionCompleteDelegate = FOnDestroySessionCompleteDelegate::CreateUObject(this, &ALeetGameSession::OnDestroySessionComplete);
 		OnFindSessionsCompleteDelegate = FOnFindSessionsCompleteDelegate::CreateUObject(this, &ALeetGameSession::OnFindSessionsComplete);
@@ -27,7 +27,7 @@ ALeetGameSession::ALeetGameSession(const FObjectInitializer& ObjectInitializer)
 
 EOnlineAsyncTaskState::Type ALeetGameSession::GetSearchResultStatus(int32& SearchResultIdx, int32& NumSearchResults)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION ::GetSearchResultStatus"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] GAME SESSION ::GetSearchResultStatus"));
 	SearchResultIdx = 0;
 	NumSearchResults = 0;
 
@@ -51,7 +51,7 @@ EOnlineAsyncTaskState::Type ALeetGameSession::GetSearchResultStatus(int32& Searc
 */
 const TArray<FOnlineSessionSearchResult> & ALeetGameSession::GetSearchResults() const
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION ::GetSearchResults"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] GAME SESSION ::GetSearchResults"));
 	return SearchSettings->SearchResults;
 };
 
@@ -64,12 +64,12 @@ const TArray<FOnlineSessionSearchResult> & ALeetGameSession::GetSearchResults()
 void ALeetGameSession::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
 {
 	//UE_LOG(LogOnlineGame, Verbose, TEXT("OnCreateSessionComplete %s bSuccess: %d"), *SessionName.ToString(), bWasSuccessful);
-	UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete"));
 
 	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
 	if (OnlineSub)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete OnlineSub"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete OnlineSub"));
 		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 		Sessions->ClearOnCreateSessionCompleteDelegate_Handle(OnCreateSessionCompleteDelegateHandle);
 		FNamedOnlineSession *sess = Sessions->GetNamedSession(SessionName);
@@ -77,11 +77,11 @@ void ALeetGameSession::OnCreateSessionComplete(FName SessionName, bool bWasSucce
 		ULeetGameInstance *gameInstance = Cast<ULeetGameInstance>(this->GetGameInstance());
 		//if (GEngine->GetWorld() != nullptr && GEngine->GetWorld()->GetGameInstance() != nullptr)
 		//{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete Got Instance"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete Got Instance"));
 			//ULeetGameInstance *gameInstance = Cast<ULeetGameInstance>(GEngine->GetWorld()->GetGameInstance());
-			UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete 2"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete 2"));
 			bool result = gameInstance->RegisterNewSession(sess->SessionInfo->ToString(), sess->SessionInfo->GetSessionId().ToString());
-			UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete 3"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::OnCreateSessionComplete 3"));
 			gameInstance->GetServerInfo();
 		//}
 	}
@@ -92,7 +92,7 @@ void ALeetGameSession::OnCreateSessionComplete(FName SessionName, bool bWasSucce
 void ALeetGameSession::OnFindSessionsComplete(bool bWasSuccessful)
 {
 	//UE_LOG(LogOnlineGame, Verbose, TEXT("OnFindSessionsComplete bSuccess: %d"), bWasSuccessful);
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION ::OnFindSessionsComplete"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION ::OnFindSessionsComplete"));
 
 	IOnlineSubsystem* const OnlineSub = IOnlineSubsystem::Get();
 	if (OnlineSub)
@@ -103,7 +103,7 @@ void ALeetGameSession::OnFindSessionsComplete(bool bWasSuccessful)
 			
 			Sessions->ClearOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegateHandle);
 
-			UE_LOG(LogTemp, Verbose, TEXT("Num Search Results: %d"), SearchSettings->SearchResults.Num());
+			UE_LOG(LogLeet, Verbose, TEXT("Num Search Results: %d"), SearchSettings->SearchResults.Num());
 			for (int32 SearchIdx = 0; SearchIdx < SearchSettings->SearchResults.Num(); SearchIdx++)
 			{
 				const FOnlineSessionSearchResult& SearchResult = SearchSettings->SearchResults[SearchIdx];
@@ -116,13 +116,19 @@ void ALeetGameSession::OnFindSessionsComplete(bool bWasSuccessful)
 	}
 }
 
+void ALeetGameSession::HandleSearchResultsChanged(const FLeetSearchResultsDelta& Delta)
+{
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] GAME SESSION ::HandleSearchResultsChanged %d added, %d updated, %d removed"), Delta.Added.Num(), Delta.Updated.Num(), Delta.Removed.Num());
+	OnSearchResultsChanged().Broadcast(Delta);
+}
+
 void ALeetGameSession::FindSessions(TSharedPtr<const FUniqueNetId> UserId, FName SessionName, bool bIsLAN, bool bIsPresence)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions"));
 	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
 	if (OnlineSub)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions:  OnlineSub"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions:  OnlineSub"));
 		
 		CurrentSessionParams.SessionName = SessionName;
 		CurrentSessionParams.bIsLAN = bIsLAN;
@@ -132,19 +138,20 @@ void ALeetGameSession::FindSessions(TSharedPtr<const FUniqueNetId> UserId, FName
 		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 		if (Sessions.IsValid() && CurrentSessionParams.UserId.IsValid())
 		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions:  Session Valid"));
-			SearchSettings = MakeShareable(new FLeetOnlineSearchSettings(bIsLAN, bIsPresence));
-			//UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions:  1"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions:  Session Valid"));
+			SearchSettings = MakeShareable(new FLeetOnlineSearchSettings(bIsLAN, bIsPresence, true));
+			SearchSettings->OnResultsChanged.AddUObject(this, &ALeetGameSession::HandleSearchResultsChanged);
+			//UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions:  1"));
 			SearchSettings->QuerySettings.Set(SEARCH_KEYWORDS, CustomMatchKeyword, EOnlineComparisonOp::Equals);
-			//UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions:  2"));
+			//UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions:  2"));
 
 			TSharedRef<FOnlineSessionSearch> SearchSettingsRef = SearchSettings.ToSharedRef();
-			//UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions:  3"));
+			//UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions:  3"));
 
 			OnFindSessionsCompleteDelegateHandle = Sessions->AddOnFindSessionsCompleteDelegate_Handle(OnFindSessionsCompleteDelegate);
-			//UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions:  4"));
+			//UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions:  4"));
 			Sessions->FindSessions(*CurrentSessionParams.UserId, SearchSettingsRef);
-			UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION FindSessions:  Done"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION FindSessions:  Done"));
 		}
 		
 	}
@@ -198,7 +205,7 @@ void ALeetGameSession::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCo
 
 bool ALeetGameSession::JoinSession(TSharedPtr<const FUniqueNetId> UserId, FName SessionName, int32 SessionIndexInSearchResults)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION JoinSession 1"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION JoinSession 1"));
 	bool bResult = false;
 
 	if (SessionIndexInSearchResults >= 0 && SessionIndexInSearchResults < SearchSettings->SearchResults.Num())
@@ -211,17 +218,17 @@ bool ALeetGameSession::JoinSession(TSharedPtr<const FUniqueNetId> UserId, FName
 
 bool ALeetGameSession::JoinSession(TSharedPtr<const FUniqueNetId> UserId, FName SessionName, const FOnlineSessionSearchResult& SearchResult)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION JoinSession 2"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION JoinSession 2"));
 	bool bResult = false;
 
 	IOnlineSubsystem* OnlineSub = IOnlineSubsystem::Get();
 	if (OnlineSub)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION JoinSession : OnelineSub"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION JoinSession : OnelineSub"));
 		IOnlineSessionPtr Sessions = OnlineSub->GetSessionInterface();
 		if (Sessions.IsValid() && UserId.IsValid())
 		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] GAME SESSION JoinSession : Session valid"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] GAME SESSION JoinSession : Session valid"));
 			OnJoinSessionCompleteDelegateHandle = Sessions->AddOnJoinSessionCompleteDelegate_Handle(OnJoinSessionCompleteDelegate);
 			bResult = Sessions->JoinSession(*UserId, SessionName, SearchResult);
 		}
@@ -231,7 +238,7 @@ bool ALeetGameSession::JoinSession(TSharedPtr<const FUniqueNetId> UserId, FName
 }
 
 void ALeetGameSession::RegisterServer() {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::RegisterServer"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] ALeetGameSession::RegisterServer"));
 	UWorld* World = GetWorld();
 	IOnlineSessionPtr SessionInt = Online::GetSessionInterface();
 
@@ -254,12 +261,12 @@ void ALeetGameSession::RegisterServer() {
 
 void ALeetGameSession::PostLogin(APlayerController* NewPlayer)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::PostLogin"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] ALeetGameSession::PostLogin"));
 }
 
 FString ALeetGameSession::ApproveLogin(const FString& Options)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameSession] ApproveLogin Options: %s"), *Options);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameSession] ApproveLogin Options: %s"), *Options);
 	UWorld* const World = GetWorld();
 	check(World);
 
@@ -288,7 +295,7 @@ FString ALeetGameSession::ApproveLogin(const FString& Options)
 
 void ALeetGameSession::RegisterPlayer(APlayerController* NewPlayer, const TSharedPtr<const FUniqueNetId>& UniqueId, bool bWasFromInvite)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] ALeetGameSession::RegisterPlayer"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] ALeetGameSession::RegisterPlayer"));
 	if (NewPlayer != NULL)
 	{
 		// Set the player's ID.
@@ -300,11 +307,11 @@ void ALeetGameSession::RegisterPlayer(APlayerController* NewPlayer, const TShare
 		int32 playerId = NewPlayer->PlayerState->PlayerId;
 		//FString playerUniqueId = UniqueId->ToString(); // assertion fail
 
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameSession] RegisterPlayer playerId: %d"), playerId);
-		//UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameSession] RegisterPlayer UniqueId: %s"), *UniqueId->ToString()); //assertionFail
-		//UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameSession] RegisterPlayer playerUniqueId: %s"), *playerUniqueId);  // assertion fail
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameSession] RegisterPlayer playerId: %d"), playerId);
+		//UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameSession] RegisterPlayer UniqueId: %s"), *UniqueId->ToString()); //assertionFail
+		//UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameSession] RegisterPlayer playerUniqueId: %s"), *playerUniqueId);  // assertion fail
 
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetGameSession] RegisterPlayer NewPlayer->PlayerState->PlayerName: %s"), *NewPlayer->PlayerState->PlayerName);
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameSession] RegisterPlayer NewPlayer->PlayerState->PlayerName: %s"), *NewPlayer->PlayerState->PlayerName);
 		//NewPlayer->PlayerState->
 		
 
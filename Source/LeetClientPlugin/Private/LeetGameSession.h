@@ -4,6 +4,7 @@
 
 #include "GameFramework/GameSession.h"
 #include "Online.h"
+#include "LeetOnlineGameSettings.h"
 #include "LeetGameSession.generated.h"
 
 struct FLeetGameSessionParams
@@ -100,6 +101,9 @@ protected:
 	* @param bWasSuccessful true if the async action completed without error, false if there was an error
 	*/
 	void OnFindSessionsComplete(bool bWasSuccessful);
+
+	/** Passes a batch of changes to the running search on to OnSearchResultsChanged */
+	void HandleSearchResultsChanged(const FLeetSearchResultsDelta& Delta);
 	/**
 	* Delegate fired when a session join request has completed
 	*
@@ -123,6 +127,11 @@ protected:
 	DECLARE_EVENT_OneParam(ALeetGameSession, FOnFindSessionsComplete, bool /*bWasSuccessful*/);
 	FOnFindSessionsComplete FindSessionsCompleteEvent;
 	/*
+	* Event triggered with each batch of search results added, updated or removed while the search runs
+	*/
+	DECLARE_EVENT_OneParam(ALeetGameSession, FOnSearchResultsChanged, const FLeetSearchResultsDelta& /*Delta*/);
+	FOnSearchResultsChanged SearchResultsChangedEvent;
+	/*
 	* Event triggered when a presence session is created
 	*
 	* @param SessionName name of session that was created
@@ -204,6 +213,8 @@ public:
 
 	/** @return the delegate fired when search of session completes */
 	FOnFindSessionsComplete& OnFindSessionsComplete() { return FindSessionsCompleteEvent; }
+	/** @return the delegate fired as search results come in, ahead of the search completing */
+	FOnSearchResultsChanged& OnSearchResultsChanged() { return SearchResultsChangedEvent; }
 	/** @return the delegate fired when joining a session */
 	FOnJoinSessionComplete& OnJoinSessionComplete() { return JoinSessionCompleteEvent; }
 
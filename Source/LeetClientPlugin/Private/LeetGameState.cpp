@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetGameState.h"
+
+namespace
+{
+	/** An FString goes out as its length followed by its characters, one byte each when they all fit in ANSI */
+	int32 GetReplicatedStringSize(const FString& String)
+	{
+		const TCHAR* Chars = *String;
+		bool bIsPureAnsi = true;
+		for (int32 CharIdx = 0; CharIdx < String.Len(); CharIdx++)
+		{
+			if (Chars[CharIdx] > 0x7f)
+			{
+				bIsPureAnsi = false;
+				break;
+			}
+		}
+		const int32 NumChars = String.Len() > 0 ? String.Len() + 1 : 0;
+		return sizeof(int32) + NumChars * (bIsPureAnsi ? sizeof(ANSICHAR) : sizeof(UCS2CHAR));
+	}
+}
+
+int32 FLeetChatLine::GetReplicatedSize() const
+{
+	return GetReplicatedStringSize(Sender) + GetReplicatedStringSize(Message);
+}
+
+ALeetGameState::ALeetGameState(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, NumChatLinesSent(0)
+	, NumChatBatchesSent(0)
+	, ChatBytesSent(0)
+	, ChatBytesPerControllerEstimate(0)
+{
+}
+
+void ALeetGameState::QueueChatLine(const FString& Sender, const FString& Message)
+{
+	check(HasAuthority());
+	PendingChatLines.Add(FLeetChatLine(Sender, Message));
+
+	// Everything said during this frame goes out together
+	if (!ChatFlushTimerHandle.IsValid())
+	{
+		ChatFlushTimerHandle = GetWorldTimerManager().SetTimerForNextTick(this, &ALeetGameState::FlushChatLines);
+	}
+}
+
+void ALeetGameState::FlushChatLines()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetChatFanOut);
+	ChatFlushTimerHandle.Invalidate();
+	if (PendingChatLines.Num() == 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameState] FlushChatLines %d lines"), PendingChatLines.Num());
+
+	// A listen server's own player has no connection
+	UNetDriver* NetDriver = GetNetDriver();
+	const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+	const int32 NumControllers = GetWorld()->GetNumPlayerControllers();
+
+	for (int32 BatchStart = 0; BatchStart < PendingChatLines.Num(); BatchStart += MAX_CHAT_LINES_PER_BATCH)
+	{
+		const int32 BatchSize = FMath::Min(MAX_CHAT_LINES_PER_BATCH, PendingChatLines.Num() - BatchStart);
+		TArray<FLeetChatLine> Batch;
+		Batch.Append(PendingChatLines.GetData() + BatchStart, BatchSize);
+
+		int32 BatchBytes = sizeof(int32);
+		for (int32 LineIdx = 0; LineIdx < Batch.Num(); LineIdx++)
+		{
+			BatchBytes += Batch[LineIdx].GetReplicatedSize();
+		}
+
+		ReceiveChatLines(Batch);
+
+		NumChatLinesSent += BatchSize;
+		NumChatBatchesSent++;
+		ChatBytesSent += BatchBytes * NumConnections;
+		ChatBytesPerControllerEstimate += (BatchBytes - sizeof(int32)) * NumControllers * NumConnections;
+	}
+	PendingChatLines.Reset();
+}
+
+void ALeetGameState::ReceiveChatLines_Implementation(const TArray<FLeetChatLine>& ChatLines)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetChatFanOut);
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetGameState] ReceiveChatLines_Implementation %d lines"), ChatLines.Num());
+
+	// Widgets listen on their own player's state, hand every line to each local one
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		APlayerController* pc = Iterator->Get();
+		ALeetPlayerState* LocalPlayerState = pc && pc->IsLocalController() ? Cast<ALeetPlayerState>(pc->PlayerState) : nullptr;
+		if (LocalPlayerState)
+		{
+			for (int32 LineIdx = 0; LineIdx < ChatLines.Num(); LineIdx++)
+			{
+				LocalPlayerState->OnTextDelegate.Broadcast(FText::FromString(ChatLines[LineIdx].Sender), FText::FromString(ChatLines[LineIdx].Message));
+			}
+		}
+	}
+}
+
+void ALeetGameState::DumpChatStats(FOutputDevice& Ar) const
+{
+	int32 NumDropped = 0;
+	int32 NumMerged = 0;
+	for (int32 PlayerIdx = 0; PlayerIdx < PlayerArray.Num(); PlayerIdx++)
+	{
+		const ALeetPlayerState* LeetPlayerState = Cast<ALeetPlayerState>(PlayerArray[PlayerIdx]);
+		if (LeetPlayerState)
+		{
+			NumDropped += LeetPlayerState->GetNumChatMessagesDropped();
+			NumMerged += LeetPlayerState->GetNumChatMessagesMerged();
+		}
+	}
+
+	Ar.Logf(TEXT("Leet chat: %d lines in %d batches, %d bytes sent, %d bytes sent once per controller, %d pending, %d dropped, %d merged"),
+		NumChatLinesSent, NumChatBatchesSent, ChatBytesSent, ChatBytesPerControllerEstimate, PendingChatLines.Num(), NumDropped, NumMerged);
+}
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GameFramework/GameState.h"
+#include "LeetGameState.generated.h"
+
+/** One chat line as it goes over the wire, plain strings instead of FText */
+USTRUCT()
+struct FLeetChatLine {
+
+	GENERATED_USTRUCT_BODY()
+	UPROPERTY()
+		FString Sender;
+	UPROPERTY()
+		FString Message;
+
+	FLeetChatLine()
+	{
+	}
+
+	FLeetChatLine(const FString& InSender, const FString& InMessage)
+		: Sender(InSender)
+		, Message(InMessage)
+	{
+	}
+
+	/** @return rough size of the line in a replicated bunch, in bytes */
+	int32 GetReplicatedSize() const;
+};
+
+/**
+ * Game state that fans chat out to every client.
+ *
+ * Lines queued on the server during a frame are sent together in a single multicast on the next tick, so a chat
+ * line costs one RPC per connection instead of one per connection for every player controller.
+ */
+UCLASS()
+class LEETCLIENTPLUGIN_API ALeetGameState : public AGameState
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	/** Most lines sent in one multicast, a bigger backlog goes out in several */
+	static const int32 MAX_CHAT_LINES_PER_BATCH = 32;
+
+	/**
+	 * Queues a chat line for every client.  Server only
+	 *
+	 * @param Sender name shown in front of the line
+	 * @param Message the line itself
+	 */
+	void QueueChatLine(const FString& Sender, const FString& Message);
+
+	/** Sends everything queued since the last flush.  Server only, runs on its own on the tick after a line was queued */
+	void FlushChatLines();
+
+	/** This function is called remotely by the server. */
+	UFUNCTION(NetMulticast, Unreliable)
+		void ReceiveChatLines(const TArray<FLeetChatLine>& ChatLines);
+
+	/** Chat bandwidth since the map started, in bytes summed over all connections */
+	int32 GetChatBytesSent() const { return ChatBytesSent; }
+
+	/** What the same lines would have cost sent once per player controller, in bytes summed over all connections */
+	int32 GetChatBytesPerControllerEstimate() const { return ChatBytesPerControllerEstimate; }
+
+	/** Writes the chat counters to the given output device */
+	void DumpChatStats(FOutputDevice& Ar) const;
+
+protected:
+
+	/** Lines waiting for the next flush */
+	TArray<FLeetChatLine> PendingChatLines;
+
+	/** Next tick flush timer */
+	FTimerHandle ChatFlushTimerHandle;
+
+	/** Counters, server only */
+	int32 NumChatLinesSent;
+	int32 NumChatBatchesSent;
+	int32 ChatBytesSent;
+	int32 ChatBytesPerControllerEstimate;
+};
@@ -0,0 +1,468 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetHttpTransport.h"
+
+FLeetHttpTransport* FLeetHttpTransport::Instance = nullptr;
+
+const float FLeetHttpTransport::DEFAULT_CIRCUIT_OPEN_SECONDS = 10.0f;
+
+FLeetHttpTransport& FLeetHttpTransport::Get()
+{
+	if (Instance == nullptr)
+	{
+		Instance = new FLeetHttpTransport();
+	}
+	return *Instance;
+}
+
+void FLeetHttpTransport::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FLeetHttpTransport::FLeetHttpTransport()
+	: NumInFlight(0)
+	, NumDispatched(0)
+	, bIsPumping(false)
+	, MaxInFlight(DEFAULT_MAX_IN_FLIGHT)
+	, MaxConnectionsPerHost(DEFAULT_MAX_CONNECTIONS_PER_HOST)
+	, CircuitFailureThreshold(DEFAULT_CIRCUIT_FAILURE_THRESHOLD)
+	, CircuitOpenSeconds(DEFAULT_CIRCUIT_OPEN_SECONDS)
+{
+}
+
+FLeetHttpTransport::~FLeetHttpTransport()
+{
+	// Anything still on the wire would call back into a deleted object
+	for (int32 RequestIdx = 0; RequestIdx < InFlightRequests.Num(); RequestIdx++)
+	{
+		InFlightRequests[RequestIdx]->OnProcessRequestComplete().Unbind();
+		InFlightRequests[RequestIdx]->CancelRequest();
+	}
+	InFlightRequests.Empty();
+	HostQueues.Empty();
+	DelayedRetries.Empty();
+	RejectedRequests.Empty();
+}
+
+bool FLeetHttpTransport::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LeetTransportTick);
+	SET_DWORD_STAT(STAT_LeetRequestsInFlight, NumInFlight);
+	SET_DWORD_STAT(STAT_LeetRequestsQueued, GetNumQueued());
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Pull out everything due first, caller delegates fired below may schedule more retries
+	TArray<FPendingRequest> DueRetries;
+	for (int32 RetryIdx = DelayedRetries.Num() - 1; RetryIdx >= 0; RetryIdx--)
+	{
+		if (DelayedRetries[RetryIdx].RetryTime <= Now)
+		{
+			DueRetries.Insert(DelayedRetries[RetryIdx], 0);
+			DelayedRetries.RemoveAt(RetryIdx);
+		}
+	}
+
+	TArray<FPendingRequest> Rejected;
+	Exchange(Rejected, RejectedRequests);
+
+	for (int32 RetryIdx = 0; RetryIdx < DueRetries.Num(); RetryIdx++)
+	{
+		const FPendingRequest& Retry = DueRetries[RetryIdx];
+		if (AcquireCircuit(Retry.Endpoint))
+		{
+			HostQueues.FindOrAdd(Retry.Host).Pending.Add(Retry);
+		}
+		else
+		{
+			Rejected.Add(Retry);
+		}
+	}
+
+	if (DueRetries.Num() > 0)
+	{
+		PumpQueues();
+	}
+
+	for (int32 RejectedIdx = 0; RejectedIdx < Rejected.Num(); RejectedIdx++)
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetHttpTransport] Circuit open, failing %s"), *Rejected[RejectedIdx].Request->GetURL());
+		Rejected[RejectedIdx].OnComplete.ExecuteIfBound(Rejected[RejectedIdx].Request, nullptr, false);
+	}
+
+	return true;
+}
+
+void FLeetHttpTransport::Configure(int32 InMaxInFlight, int32 InMaxConnectionsPerHost)
+{
+	MaxInFlight = FMath::Max(1, InMaxInFlight);
+	MaxConnectionsPerHost = FMath::Clamp(InMaxConnectionsPerHost, 1, MaxInFlight);
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetHttpTransport] Configure MaxInFlight: %d MaxConnectionsPerHost: %d"), MaxInFlight, MaxConnectionsPerHost);
+
+	// Raising the limits may free up slots for queued requests
+	PumpQueues();
+}
+
+void FLeetHttpTransport::ConfigureCircuitBreaker(int32 InFailureThreshold, float InOpenSeconds)
+{
+	CircuitFailureThreshold = FMath::Max(1, InFailureThreshold);
+	CircuitOpenSeconds = FMath::Max(0.0f, InOpenSeconds);
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetHttpTransport] ConfigureCircuitBreaker FailureThreshold: %d OpenSeconds: %f"), CircuitFailureThreshold, CircuitOpenSeconds);
+}
+
+void FLeetHttpTransport::SetRetryPolicy(const FString& PathPattern, const FLeetRetryPolicy& Policy)
+{
+	FLeetRetryPolicy& NewPolicy = RetryPolicies.Add(PathPattern.ToLower(), Policy);
+	NewPolicy.MaxAttempts = FMath::Max(1, NewPolicy.MaxAttempts);
+}
+
+TSharedRef<IHttpRequest> FLeetHttpTransport::CreateRequest(const FString& Verb, const FString& URL) const
+{
+	TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
+	Request->SetVerb(Verb);
+	Request->SetURL(URL);
+	Request->SetHeader(TEXT("User-Agent"), TEXT("LEET_UE4_API_CLIENT/1.0"));
+	// Ask the server to keep the connection around so the next request to this host can reuse it
+	Request->SetHeader(TEXT("Connection"), TEXT("keep-alive"));
+	return Request;
+}
+
+bool FLeetHttpTransport::ProcessRequest(const TSharedRef<IHttpRequest>& Request, const FHttpRequestCompleteDelegate& OnComplete)
+{
+	FHttpModule* Http = &FHttpModule::Get();
+	if (!Http || !Http->IsHttpEnabled())
+	{
+		return false;
+	}
+
+	const FString PolicyPattern = FindPolicyPattern(Request->GetURL());
+
+	FPendingRequest Pending;
+	Pending.Request = Request;
+	Pending.OnComplete = OnComplete;
+	Pending.Host = GetHostFromURL(Request->GetURL());
+	Pending.Endpoint = Pending.Host + PolicyPattern;
+	Pending.Policy = FindRetryPolicy(PolicyPattern);
+
+	// While the API is down don't pile more doomed requests onto the HTTP module
+	if (!AcquireCircuit(Pending.Endpoint))
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetHttpTransport] Circuit open for %s, rejecting %s"), *Pending.Endpoint, *Request->GetURL());
+		return false;
+	}
+
+	// Retries reuse the key so the API can tell a resend from a new call
+	if (Request->GetVerb() == TEXT("POST") && Request->GetHeader(TEXT("Idempotency-Key")).IsEmpty())
+	{
+		Request->SetHeader(TEXT("Idempotency-Key"), FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphens));
+	}
+
+	HostQueues.FindOrAdd(Pending.Host).Pending.Add(Pending);
+
+	PumpQueues();
+	return true;
+}
+
+int32 FLeetHttpTransport::GetNumQueued() const
+{
+	int32 NumQueued = 0;
+	for (TMap<FString, FHostQueue>::TConstIterator It(HostQueues); It; ++It)
+	{
+		NumQueued += It.Value().Pending.Num();
+	}
+	return NumQueued;
+}
+
+ELeetCircuitState::Type FLeetHttpTransport::GetCircuitState(const FString& URL) const
+{
+	const FCircuitBreaker* Breaker = CircuitBreakers.Find(GetHostFromURL(URL) + FindPolicyPattern(URL));
+	return Breaker ? Breaker->State : ELeetCircuitState::Closed;
+}
+
+void FLeetHttpTransport::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet transport: %d in flight (max %d), %d queued, %d awaiting retry, %d connections per host"), NumInFlight, MaxInFlight, GetNumQueued(), DelayedRetries.Num(), MaxConnectionsPerHost);
+	for (TMap<FString, FHostQueue>::TConstIterator It(HostQueues); It; ++It)
+	{
+		Ar.Logf(TEXT("  %s: %d in flight, %d queued"), *It.Key(), It.Value().NumInFlight, It.Value().Pending.Num());
+	}
+	const double Now = FPlatformTime::Seconds();
+	for (int32 RetryIdx = 0; RetryIdx < DelayedRetries.Num(); RetryIdx++)
+	{
+		const FPendingRequest& Retry = DelayedRetries[RetryIdx];
+		Ar.Logf(TEXT("  retry %s: attempt %d/%d in %.2fs"), *Retry.Endpoint, Retry.Attempt + 1, Retry.Policy.MaxAttempts, FMath::Max(0.0, Retry.RetryTime - Now));
+	}
+	for (TMap<FString, FCircuitBreaker>::TConstIterator It(CircuitBreakers); It; ++It)
+	{
+		Ar.Logf(TEXT("  circuit %s: %s, %d consecutive failures"), *It.Key(), ELeetCircuitState::ToString(It.Value().State), It.Value().ConsecutiveFailures);
+	}
+	for (TMap<FString, FLeetRetryPolicy>::TConstIterator It(RetryPolicies); It; ++It)
+	{
+		Ar.Logf(TEXT("  policy %s: %d attempts, %.2fs-%.2fs backoff"), *It.Key(), It.Value().MaxAttempts, It.Value().InitialBackoff, It.Value().MaxBackoff);
+	}
+}
+
+FString FLeetHttpTransport::GetHostFromURL(const FString& URL)
+{
+	FString Host = URL;
+	int32 SchemeEnd = Host.Find(TEXT("://"));
+	if (SchemeEnd != INDEX_NONE)
+	{
+		Host = Host.Mid(SchemeEnd + 3);
+	}
+	int32 PathStart = INDEX_NONE;
+	if (Host.FindChar(TEXT('/'), PathStart))
+	{
+		Host = Host.Left(PathStart);
+	}
+	return Host.ToLower();
+}
+
+FString FLeetHttpTransport::GetPathFromURL(const FString& URL)
+{
+	FString Path = URL;
+	int32 SchemeEnd = Path.Find(TEXT("://"));
+	if (SchemeEnd != INDEX_NONE)
+	{
+		Path = Path.Mid(SchemeEnd + 3);
+	}
+	int32 PathStart = INDEX_NONE;
+	if (!Path.FindChar(TEXT('/'), PathStart))
+	{
+		return TEXT("/");
+	}
+	Path = Path.Mid(PathStart);
+	int32 QueryStart = INDEX_NONE;
+	if (Path.FindChar(TEXT('?'), QueryStart))
+	{
+		Path = Path.Left(QueryStart);
+	}
+	return Path.ToLower();
+}
+
+FString FLeetHttpTransport::FindPolicyPattern(const FString& URL) const
+{
+	const FString Path = GetPathFromURL(URL);
+
+	// The longest pattern is the most specific one
+	FString BestPattern;
+	for (TMap<FString, FLeetRetryPolicy>::TConstIterator It(RetryPolicies); It; ++It)
+	{
+		if (It.Key().Len() > BestPattern.Len() && Path.MatchesWildcard(It.Key()))
+		{
+			BestPattern = It.Key();
+		}
+	}
+	return BestPattern;
+}
+
+const FLeetRetryPolicy& FLeetHttpTransport::FindRetryPolicy(const FString& PolicyPattern) const
+{
+	const FLeetRetryPolicy* Policy = RetryPolicies.Find(PolicyPattern);
+	return Policy ? *Policy : DefaultRetryPolicy;
+}
+
+TSharedRef<IHttpRequest> FLeetHttpTransport::CloneRequest(const TSharedPtr<IHttpRequest>& Source)
+{
+	TSharedRef<IHttpRequest> Clone = FHttpModule::Get().CreateRequest();
+	Clone->SetVerb(Source->GetVerb());
+	Clone->SetURL(Source->GetURL());
+
+	// Headers come back as "Name: Value"
+	TArray<FString> Headers = Source->GetAllHeaders();
+	for (int32 HeaderIdx = 0; HeaderIdx < Headers.Num(); HeaderIdx++)
+	{
+		FString Name;
+		FString Value;
+		if (Headers[HeaderIdx].Split(TEXT(":"), &Name, &Value))
+		{
+			Clone->SetHeader(Name.Trim().TrimTrailing(), Value.Trim().TrimTrailing());
+		}
+	}
+
+	Clone->SetContent(Source->GetContent());
+	return Clone;
+}
+
+bool FLeetHttpTransport::AcquireCircuit(const FString& Endpoint)
+{
+	FCircuitBreaker& Breaker = CircuitBreakers.FindOrAdd(Endpoint);
+	switch (Breaker.State)
+	{
+	case ELeetCircuitState::Closed:
+		return true;
+
+	case ELeetCircuitState::Open:
+		if (FPlatformTime::Seconds() < Breaker.OpenUntil)
+		{
+			return false;
+		}
+		// Open period is over, this request becomes the probe
+		SetCircuitState(Endpoint, Breaker, ELeetCircuitState::HalfOpen);
+		Breaker.bProbeInFlight = true;
+		return true;
+
+	case ELeetCircuitState::HalfOpen:
+		if (Breaker.bProbeInFlight)
+		{
+			return false;
+		}
+		Breaker.bProbeInFlight = true;
+		return true;
+	}
+	return true;
+}
+
+void FLeetHttpTransport::RecordCircuitResult(const FString& Endpoint, bool bSuccess)
+{
+	FCircuitBreaker& Breaker = CircuitBreakers.FindOrAdd(Endpoint);
+	if (bSuccess)
+	{
+		Breaker.ConsecutiveFailures = 0;
+		Breaker.bProbeInFlight = false;
+		if (Breaker.State != ELeetCircuitState::Closed)
+		{
+			SetCircuitState(Endpoint, Breaker, ELeetCircuitState::Closed);
+		}
+		return;
+	}
+
+	Breaker.ConsecutiveFailures++;
+	if (Breaker.State == ELeetCircuitState::HalfOpen ||
+		(Breaker.State == ELeetCircuitState::Closed && Breaker.ConsecutiveFailures >= CircuitFailureThreshold))
+	{
+		Breaker.bProbeInFlight = false;
+		Breaker.OpenUntil = FPlatformTime::Seconds() + CircuitOpenSeconds;
+		SetCircuitState(Endpoint, Breaker, ELeetCircuitState::Open);
+	}
+}
+
+void FLeetHttpTransport::SetCircuitState(const FString& Endpoint, FCircuitBreaker& Breaker, ELeetCircuitState::Type NewState)
+{
+	UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetHttpTransport] Circuit %s: %s -> %s after %d consecutive failures"),
+		*Endpoint, ELeetCircuitState::ToString(Breaker.State), ELeetCircuitState::ToString(NewState), Breaker.ConsecutiveFailures);
+
+	Breaker.State = NewState;
+	CircuitStateChangedDelegates.Broadcast(Endpoint, NewState);
+}
+
+void FLeetHttpTransport::PumpQueues()
+{
+	// A request failing inside ProcessRequest completes synchronously and lands back here, the outer pump carries on
+	if (bIsPumping)
+	{
+		return;
+	}
+	TGuardValue<bool> PumpGuard(bIsPumping, true);
+
+	// Round robin over the hosts so a single busy host can't starve the others.
+	// Completion delegates may queue requests for new hosts, so the host list is refreshed every pass.
+	bool bDispatchedAny = true;
+	while (bDispatchedAny && NumInFlight < MaxInFlight)
+	{
+		bDispatchedAny = false;
+
+		TArray<FString> Hosts;
+		HostQueues.GenerateKeyArray(Hosts);
+		for (int32 HostIdx = 0; HostIdx < Hosts.Num() && NumInFlight < MaxInFlight; HostIdx++)
+		{
+			FHostQueue* Queue = HostQueues.Find(Hosts[HostIdx]);
+			if (Queue && Queue->Pending.Num() > 0 && Queue->NumInFlight < MaxConnectionsPerHost)
+			{
+				FPendingRequest Pending = Queue->Pending[0];
+				Queue->Pending.RemoveAt(0, 1, false);
+				Dispatch(Pending);
+				bDispatchedAny = true;
+			}
+		}
+	}
+}
+
+void FLeetHttpTransport::Dispatch(const FPendingRequest& Pending)
+{
+	// Queued before its circuit opened, fail it on the next tick instead of sending it
+	const FCircuitBreaker* Breaker = CircuitBreakers.Find(Pending.Endpoint);
+	if (Breaker && Breaker->State == ELeetCircuitState::Open)
+	{
+		RejectedRequests.Add(Pending);
+		return;
+	}
+
+	HostQueues.FindChecked(Pending.Host).NumInFlight++;
+	NumInFlight++;
+	InFlightRequests.Add(Pending.Request);
+
+	// The request hands itself to the handler, keeping it in the payload too would make it own itself
+	FPendingRequest Sent = Pending;
+	Sent.Request.Reset();
+	Sent.Attempt++;
+	Sent.SentTime = FPlatformTime::Seconds();
+	Sent.TraceId = ++NumDispatched;
+	if (FLeetTrace::Get().IsEnabled())
+	{
+		FLeetTrace::Get().AsyncBegin(TEXT("HttpRequest"), Sent.TraceId, Pending.Request->GetURL());
+	}
+
+	Pending.Request->OnProcessRequestComplete().BindRaw(this, &FLeetHttpTransport::HandleRequestComplete, Sent);
+	if (!Pending.Request->ProcessRequest() && InFlightRequests.Contains(Pending.Request))
+	{
+		// The HTTP module refused the request without reporting it, release the slot ourselves
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetHttpTransport] Failed to start request %s"), *Pending.Request->GetURL());
+		Pending.Request->OnProcessRequestComplete().Unbind();
+		HandleRequestComplete(Pending.Request, nullptr, false, Sent);
+	}
+}
+
+void FLeetHttpTransport::HandleRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, FPendingRequest Pending)
+{
+	FLeetTrace::Get().AsyncEnd(TEXT("HttpRequest"), Pending.TraceId);
+	InFlightRequests.RemoveSingleSwap(HttpRequest);
+	NumInFlight--;
+
+	FHostQueue* Queue = HostQueues.Find(Pending.Host);
+	if (Queue)
+	{
+		Queue->NumInFlight--;
+	}
+
+	// No answer or a server side error means the endpoint is in trouble, 4xx means it is up and said no
+	const int32 ResponseCode = HttpResponse.IsValid() ? HttpResponse->GetResponseCode() : 0;
+	const bool bServerFailure = !bSucceeded || !HttpResponse.IsValid() || ResponseCode >= EHttpResponseCodes::ServerError;
+	const bool bThrottled = ResponseCode == EHttpResponseCodes::RequestTimeout || ResponseCode == 429;
+	RecordCircuitResult(Pending.Endpoint, !bServerFailure);
+
+	const FCircuitBreaker* Breaker = CircuitBreakers.Find(Pending.Endpoint);
+	const bool bCircuitOpen = Breaker && Breaker->State == ELeetCircuitState::Open;
+	const bool bRetry = (bServerFailure || bThrottled) && Pending.Attempt < Pending.Policy.MaxAttempts && !bCircuitOpen;
+
+	FLeetMetrics::Get().RecordRequest(HttpRequest->GetURL(), FPlatformTime::Seconds() - Pending.SentTime, bSucceeded ? ResponseCode : 0,
+		HttpRequest->GetContentLength(), HttpResponse.IsValid() ? HttpResponse->GetContentLength() : 0, bRetry);
+
+	if (bRetry)
+	{
+		// Full jitter keeps a crowd of failed requests from coming back in lockstep
+		const float BackoffCap = FMath::Min(Pending.Policy.MaxBackoff, Pending.Policy.InitialBackoff * FMath::Pow(2.0f, Pending.Attempt - 1));
+		const float Backoff = FMath::FRandRange(0.0f, BackoffCap);
+
+		UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetHttpTransport] Attempt %d/%d of %s failed (%d), retrying in %.2fs"),
+			Pending.Attempt, Pending.Policy.MaxAttempts, *HttpRequest->GetURL(), ResponseCode, Backoff);
+
+		FPendingRequest Retry = Pending;
+		Retry.Request = CloneRequest(HttpRequest);
+		Retry.RetryTime = FPlatformTime::Seconds() + Backoff;
+		DelayedRetries.Add(Retry);
+
+		PumpQueues();
+		return;
+	}
+
+	// Hand the freed slot to the next queued request before running caller code, which may queue more work
+	PumpQueues();
+
+	Pending.OnComplete.ExecuteIfBound(HttpRequest, HttpResponse, bSucceeded);
+}
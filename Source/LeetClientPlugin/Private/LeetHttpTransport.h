@@ -0,0 +1,329 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Http.h"
+#include "Ticker.h"
+
+/** Retry behaviour for requests sent to a given endpoint */
+struct LEETCLIENTPLUGIN_API FLeetRetryPolicy
+{
+	/** Total number of attempts, including the first one.  1 disables retries */
+	int32 MaxAttempts;
+	/** Backoff cap of the first retry, in seconds.  Doubles with every attempt */
+	float InitialBackoff;
+	/** Upper bound of the backoff, in seconds */
+	float MaxBackoff;
+
+	FLeetRetryPolicy()
+		: MaxAttempts(3)
+		, InitialBackoff(0.5f)
+		, MaxBackoff(8.0f)
+	{
+	}
+
+	FLeetRetryPolicy(int32 InMaxAttempts, float InInitialBackoff, float InMaxBackoff)
+		: MaxAttempts(InMaxAttempts)
+		, InitialBackoff(InInitialBackoff)
+		, MaxBackoff(InMaxBackoff)
+	{
+	}
+};
+
+/** State of the circuit breaker guarding an endpoint */
+namespace ELeetCircuitState
+{
+	enum Type
+	{
+		/** Requests flow normally */
+		Closed,
+		/** Endpoint considered down, requests fail fast */
+		Open,
+		/** Open period elapsed, a single probe request is allowed through */
+		HalfOpen
+	};
+
+	inline const TCHAR* ToString(ELeetCircuitState::Type State)
+	{
+		switch (State)
+		{
+		case Closed: return TEXT("Closed");
+		case Open: return TEXT("Open");
+		case HalfOpen: return TEXT("HalfOpen");
+		}
+		return TEXT("");
+	}
+}
+
+/** Fired when the circuit breaker of an endpoint changes state */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnLeetCircuitStateChanged, const FString& /*Endpoint*/, ELeetCircuitState::Type /*NewState*/);
+
+/**
+ * Shared HTTP transport for all Leet API traffic.
+ *
+ * Every Leet call site (game instance and online subsystem) hands its requests to this object instead of
+ * calling FHttpModule directly.  Requests are queued per host and only dispatched while a connection slot
+ * is free, so a join storm reuses a small pool of keep-alive connections instead of opening a burst of
+ * cold TCP connections to the API.
+ *
+ * Failed requests are retried with exponential backoff and full jitter according to the retry policy of
+ * their endpoint.  POSTs carry an Idempotency-Key header that is kept across retries so the API can drop
+ * duplicates.  Each endpoint is guarded by a circuit breaker that fails requests fast while the endpoint is down.
+ */
+class LEETCLIENTPLUGIN_API FLeetHttpTransport : public FTickerObjectBase
+{
+public:
+
+	/** Default upper bound for requests on the wire across all hosts */
+	static const int32 DEFAULT_MAX_IN_FLIGHT = 16;
+	/** Default number of keep-alive connections kept open per host */
+	static const int32 DEFAULT_MAX_CONNECTIONS_PER_HOST = 4;
+	/** Default number of consecutive failures that open a circuit */
+	static const int32 DEFAULT_CIRCUIT_FAILURE_THRESHOLD = 5;
+	/** Default time a circuit stays open before letting a probe through, in seconds */
+	static const float DEFAULT_CIRCUIT_OPEN_SECONDS;
+
+	/** @return the transport shared by every Leet module, created on first use */
+	static FLeetHttpTransport& Get();
+
+	/** Destroys the shared transport, dropping anything still queued.  Called on module shutdown */
+	static void Shutdown();
+
+	/**
+	 * @param ResponseCode final code of a request, 0 when there was no answer
+	 * @return true if sending the request again may still get a different answer: no answer, a server error, a
+	 *         request timeout (408) or throttling (429).  Anything else is the API's last word on it.
+	 */
+	static bool IsTransientResponseCode(int32 ResponseCode)
+	{
+		return ResponseCode == 0 || ResponseCode >= EHttpResponseCodes::ServerError
+			|| ResponseCode == EHttpResponseCodes::RequestTimeout || ResponseCode == 429;
+	}
+
+	virtual ~FLeetHttpTransport();
+
+	// FTickerObjectBase
+
+	virtual bool Tick(float DeltaTime) override;
+
+	// FLeetHttpTransport
+
+	/**
+	 * Sets the concurrency limits of the transport
+	 *
+	 * @param InMaxInFlight maximum number of requests on the wire across all hosts
+	 * @param InMaxConnectionsPerHost size of the keep-alive connection pool for each host
+	 */
+	void Configure(int32 InMaxInFlight, int32 InMaxConnectionsPerHost);
+
+	/**
+	 * Sets when circuits open and how long they stay open
+	 *
+	 * @param InFailureThreshold consecutive failures that open the circuit of an endpoint
+	 * @param InOpenSeconds time an open circuit fails requests fast before letting a probe through
+	 */
+	void ConfigureCircuitBreaker(int32 InFailureThreshold, float InOpenSeconds);
+
+	/**
+	 * Sets the retry policy of every endpoint whose path matches the given pattern.  The longest matching
+	 * pattern wins, endpoints without a match use the default policy.  Each pattern also gets its own circuit breaker.
+	 *
+	 * @param PathPattern URL path with * wildcards, ie "/api/v2/match/results*"
+	 * @param Policy retry policy to use for the endpoint
+	 */
+	void SetRetryPolicy(const FString& PathPattern, const FLeetRetryPolicy& Policy);
+
+	/** Sets the retry policy used for endpoints without a specific one */
+	void SetDefaultRetryPolicy(const FLeetRetryPolicy& Policy) { DefaultRetryPolicy = Policy; }
+
+	/**
+	 * Creates a request with the headers every Leet API call carries
+	 *
+	 * @param Verb HTTP verb to use
+	 * @param URL fully qualified URL of the endpoint
+	 *
+	 * @return the new request, not yet queued
+	 */
+	TSharedRef<IHttpRequest> CreateRequest(const FString& Verb, const FString& URL) const;
+
+	/**
+	 * Queues a request for dispatch.  The request is started as soon as a connection slot for its host is free.
+	 * If it fails it may be retried with a copy of the request, so the request handed to OnComplete is not
+	 * necessarily the one passed in here.
+	 *
+	 * @param Request request to send, its completion delegate must not be bound by the caller
+	 * @param OnComplete delegate fired on the game thread when the request completes or runs out of attempts
+	 *
+	 * @return false if HTTP is unavailable or the endpoint's circuit is open, the request was not queued
+	 */
+	bool ProcessRequest(const TSharedRef<IHttpRequest>& Request, const FHttpRequestCompleteDelegate& OnComplete);
+
+	/** @return number of requests currently on the wire */
+	int32 GetNumInFlight() const { return NumInFlight; }
+
+	/** @return number of requests waiting for a free connection slot */
+	int32 GetNumQueued() const;
+
+	/** @return number of failed requests waiting for their backoff to elapse */
+	int32 GetNumAwaitingRetry() const { return DelayedRetries.Num(); }
+
+	/** @return state of the circuit breaker guarding the given URL */
+	ELeetCircuitState::Type GetCircuitState(const FString& URL) const;
+
+	/** @return delegate fired whenever a circuit opens, half opens or closes */
+	FOnLeetCircuitStateChanged& OnCircuitStateChanged() { return CircuitStateChangedDelegates; }
+
+	/** Writes the per host queue and circuit state to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+
+	/** Hidden on purpose, use Get() */
+	FLeetHttpTransport();
+
+	/** A request waiting for, or holding, a connection slot */
+	struct FPendingRequest
+	{
+		/** The request itself */
+		TSharedPtr<IHttpRequest> Request;
+		/** Caller's completion delegate */
+		FHttpRequestCompleteDelegate OnComplete;
+		/** Host the request is queued under */
+		FString Host;
+		/** Key of the circuit breaker guarding the request */
+		FString Endpoint;
+		/** Retry policy of the request's endpoint */
+		FLeetRetryPolicy Policy;
+		/** Number of times the request has been sent */
+		int32 Attempt;
+		/** Earliest time a retry may be sent, in FPlatformTime::Seconds */
+		double RetryTime;
+		/** Time the current attempt was sent, in FPlatformTime::Seconds */
+		double SentTime;
+		/** Id of the current attempt in the Leet trace */
+		uint64 TraceId;
+
+		FPendingRequest()
+			: Attempt(0)
+			, RetryTime(0.0)
+			, SentTime(0.0)
+			, TraceId(0)
+		{
+		}
+	};
+
+	/** Requests and connection usage for a single host */
+	struct FHostQueue
+	{
+		/** Requests waiting for a slot, in submission order */
+		TArray<FPendingRequest> Pending;
+		/** Number of connections of this host currently in use */
+		int32 NumInFlight;
+
+		FHostQueue()
+			: NumInFlight(0)
+		{
+		}
+	};
+
+	/** Failure tracking for a single endpoint */
+	struct FCircuitBreaker
+	{
+		ELeetCircuitState::Type State;
+		/** Failures since the last success */
+		int32 ConsecutiveFailures;
+		/** When an open circuit lets its probe through, in FPlatformTime::Seconds */
+		double OpenUntil;
+		/** Whether the half open probe has been sent */
+		bool bProbeInFlight;
+
+		FCircuitBreaker()
+			: State(ELeetCircuitState::Closed)
+			, ConsecutiveFailures(0)
+			, OpenUntil(0.0)
+			, bProbeInFlight(false)
+		{
+		}
+	};
+
+	/** @return the host portion of a URL, used as the queue key */
+	static FString GetHostFromURL(const FString& URL);
+
+	/** @return the path portion of a URL, without query string */
+	static FString GetPathFromURL(const FString& URL);
+
+	/** @return the registered path pattern matching the URL, empty if none */
+	FString FindPolicyPattern(const FString& URL) const;
+
+	/** @return the retry policy registered for the pattern, or the default policy */
+	const FLeetRetryPolicy& FindRetryPolicy(const FString& PolicyPattern) const;
+
+	/** Copies verb, URL, headers and content into a fresh request, HTTP requests can't be sent twice */
+	static TSharedRef<IHttpRequest> CloneRequest(const TSharedPtr<IHttpRequest>& Source);
+
+	/** @return true if the circuit of the endpoint lets a request through, moving open circuits to half open when due */
+	bool AcquireCircuit(const FString& Endpoint);
+
+	/** Records the outcome of a request against its endpoint's circuit */
+	void RecordCircuitResult(const FString& Endpoint, bool bSuccess);
+
+	/** Moves a circuit to a new state and notifies listeners */
+	void SetCircuitState(const FString& Endpoint, FCircuitBreaker& Breaker, ELeetCircuitState::Type NewState);
+
+	/** Starts as many queued requests as the connection limits allow */
+	void PumpQueues();
+
+	/** Starts a single request, taking a connection slot for its host */
+	void Dispatch(const FPendingRequest& Pending);
+
+	/** Releases the connection slot of a completed request, then retries it or forwards the result to the caller */
+	void HandleRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, FPendingRequest Pending);
+
+	/** Per host queues, keyed by host name */
+	TMap<FString, FHostQueue> HostQueues;
+
+	/** Requests currently on the wire, so they can be unbound if the transport goes away first */
+	TArray<FHttpRequestPtr> InFlightRequests;
+
+	/** Failed requests waiting for their backoff to elapse */
+	TArray<FPendingRequest> DelayedRetries;
+
+	/** Queued requests whose circuit opened before they were sent, failed on the next tick */
+	TArray<FPendingRequest> RejectedRequests;
+
+	/** Retry policies keyed by path pattern */
+	TMap<FString, FLeetRetryPolicy> RetryPolicies;
+
+	/** Policy for endpoints without a specific one */
+	FLeetRetryPolicy DefaultRetryPolicy;
+
+	/** Circuit breakers keyed by endpoint */
+	TMap<FString, FCircuitBreaker> CircuitBreakers;
+
+	/** Circuit state change listeners */
+	FOnLeetCircuitStateChanged CircuitStateChangedDelegates;
+
+	/** Number of requests on the wire across all hosts */
+	int32 NumInFlight;
+
+	/** Number of attempts sent so far, gives each its trace id */
+	uint64 NumDispatched;
+
+	/** Set while PumpQueues is running, to ignore re-entrant pumps */
+	bool bIsPumping;
+
+	/** Maximum number of requests on the wire across all hosts */
+	int32 MaxInFlight;
+
+	/** Maximum number of connections used for a single host */
+	int32 MaxConnectionsPerHost;
+
+	/** Consecutive failures that open a circuit */
+	int32 CircuitFailureThreshold;
+
+	/** Time an open circuit fails fast, in seconds */
+	float CircuitOpenSeconds;
+
+	/** The shared instance */
+	static FLeetHttpTransport* Instance;
+};
@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetJournal.h"
+
+const float FLeetJournal::DEFAULT_FLUSH_INTERVAL = 0.1f;
+
+FLeetJournal::FLeetJournal(const FString& InFilename, int32 InBufferSize, float InFlushInterval)
+	: Filename(InFilename)
+	, Writer(nullptr)
+	, BufferSize(FMath::Max(1024, InBufferSize))
+	, FlushInterval(FMath::Max(0.01f, InFlushInterval))
+	, FlushEvent(nullptr)
+	, Thread(nullptr)
+{
+	AppendBuffer.Reserve(BufferSize);
+	WriteBuffer.Reserve(BufferSize);
+}
+
+FLeetJournal::~FLeetJournal()
+{
+	Close();
+}
+
+bool FLeetJournal::Open(TArray<FLeetJournalEntry>& OutPendingEntries)
+{
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetJournal] Open %s"), *Filename);
+
+	OutPendingEntries.Empty();
+
+	// Collect what the last run left behind.  A crash may have cut the last line short, anything malformed is skipped
+	FString Contents;
+	if (FFileHelper::LoadFileToString(Contents, *Filename))
+	{
+		TArray<FString> Lines;
+		Contents.ParseIntoArrayLines(Lines);
+
+		TArray<FLeetJournalEntry> Recorded;
+		TSet<FString> Completed;
+		for (int32 LineIdx = 0; LineIdx < Lines.Num(); LineIdx++)
+		{
+			TArray<FString> Fields;
+			Lines[LineIdx].ParseIntoArray(Fields, TEXT(" "), false);
+			if (Fields.Num() == 4 && Fields[0] == TEXT("P"))
+			{
+				FLeetJournalEntry Entry;
+				Entry.Id = Fields[1];
+				Entry.APIURI = Fields[2];
+				if (FBase64::Decode(Fields[3], Entry.Arguments))
+				{
+					Recorded.Add(Entry);
+				}
+			}
+			else if (Fields.Num() == 2 && Fields[0] == TEXT("C"))
+			{
+				Completed.Add(Fields[1]);
+			}
+		}
+
+		for (int32 EntryIdx = 0; EntryIdx < Recorded.Num(); EntryIdx++)
+		{
+			if (!Completed.Contains(Recorded[EntryIdx].Id))
+			{
+				OutPendingEntries.Add(Recorded[EntryIdx]);
+			}
+		}
+		UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetJournal] %d recorded, %d pending"), Recorded.Num(), OutPendingEntries.Num());
+	}
+
+	// Compact the file down to the entries still pending, they stay pending until their replay completes
+	FString Compacted;
+	for (int32 EntryIdx = 0; EntryIdx < OutPendingEntries.Num(); EntryIdx++)
+	{
+		const FLeetJournalEntry& Entry = OutPendingEntries[EntryIdx];
+		Compacted += FString::Printf(TEXT("P %s %s %s\n"), *Entry.Id, *Entry.APIURI, *FBase64::Encode(Entry.Arguments));
+	}
+	NumPending.Set(OutPendingEntries.Num());
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+	if (!FFileHelper::SaveStringToFile(Compacted, *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetJournal] Could not rewrite %s"), *Filename);
+	}
+
+	Writer = IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_Append | FILEWRITE_AllowRead);
+	if (!Writer)
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetJournal] Could not open %s, state changing calls will not be journaled"), *Filename);
+		return false;
+	}
+
+	FlushEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("LeetJournalFlush"), 0, TPri_BelowNormal);
+	return true;
+}
+
+void FLeetJournal::Close()
+{
+	if (Thread)
+	{
+		Stop();
+		FlushEvent->Trigger();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+	if (FlushEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(FlushEvent);
+		FlushEvent = nullptr;
+	}
+
+	// Flush thread is gone, whatever it didn't get to is written from here
+	FlushBuffer();
+
+	if (Writer)
+	{
+		Writer->Close();
+		delete Writer;
+		Writer = nullptr;
+	}
+}
+
+FString FLeetJournal::AppendPending(const FString& APIURI, const FString& Arguments)
+{
+	const FString EntryId = FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphens);
+	Append(FString::Printf(TEXT("P %s %s %s\n"), *EntryId, *APIURI, *FBase64::Encode(Arguments)));
+	NumPending.Increment();
+	return EntryId;
+}
+
+void FLeetJournal::MarkComplete(const FString& EntryId)
+{
+	Append(FString::Printf(TEXT("C %s\n"), *EntryId));
+	NumPending.Decrement();
+}
+
+uint32 FLeetJournal::Run()
+{
+	while (StopRequested.GetValue() == 0)
+	{
+		FlushEvent->Wait(FMath::CeilToInt(FlushInterval * 1000.0f));
+		FlushBuffer();
+	}
+	return 0;
+}
+
+void FLeetJournal::Stop()
+{
+	StopRequested.Set(1);
+}
+
+void FLeetJournal::Append(const FString& Record)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	FTCHARToUTF8 RecordUTF8(*Record);
+
+	bool bWakeFlushThread = false;
+	{
+		FScopeLock Lock(&AppendLock);
+		AppendBuffer.Append(RecordUTF8.Get(), RecordUTF8.Length());
+		bWakeFlushThread = AppendBuffer.Num() >= BufferSize / 2;
+	}
+
+	// Don't wait for the interval once the buffer is filling up, it would have to grow
+	if (bWakeFlushThread && FlushEvent)
+	{
+		FlushEvent->Trigger();
+	}
+}
+
+void FLeetJournal::FlushBuffer()
+{
+	{
+		FScopeLock Lock(&AppendLock);
+		Exchange(AppendBuffer, WriteBuffer);
+	}
+
+	if (WriteBuffer.Num() > 0 && Writer)
+	{
+		// Hands the batch to the OS, the file layer has no fsync so this is as durable as it gets
+		Writer->Serialize(WriteBuffer.GetData(), WriteBuffer.Num());
+		Writer->Flush();
+	}
+
+	// Keeps the allocation for the next swap
+	WriteBuffer.Reset();
+}
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/** A state changing API call recorded in the journal */
+struct FLeetJournalEntry
+{
+	/** Unique id of the call, also sent as its Idempotency-Key so a replay can't be applied twice */
+	FString Id;
+	/** Endpoint the call was sent to */
+	FString APIURI;
+	/** Form encoded body of the call */
+	FString Arguments;
+};
+
+/**
+ * Append only write ahead journal for state changing Leet API calls (match results, deactivations).
+ *
+ * Calls are recorded before they are sent and marked complete once the API answers, so anything left pending
+ * by a crash or a network loss is replayed on the next startup.  Appends only copy into a preallocated buffer
+ * and are cheap enough for the game thread, a background thread writes the buffer out in batches.
+ *
+ * On disk every record is one line: "P <id> <uri> <base64 arguments>" for a pending call, "C <id>" once it completed.
+ */
+class FLeetJournal : public FRunnable
+{
+public:
+
+	/** Default size of each of the two append buffers, in bytes */
+	static const int32 DEFAULT_BUFFER_SIZE = 64 * 1024;
+	/** Default time between background flushes, in seconds */
+	static const float DEFAULT_FLUSH_INTERVAL;
+
+	/**
+	 * @param InFilename journal file, created if missing
+	 * @param InBufferSize size of the preallocated append buffers
+	 * @param InFlushInterval longest time an append waits in memory before being written out
+	 */
+	FLeetJournal(const FString& InFilename, int32 InBufferSize = DEFAULT_BUFFER_SIZE, float InFlushInterval = DEFAULT_FLUSH_INTERVAL);
+
+	virtual ~FLeetJournal();
+
+	/**
+	 * Reads back the calls a previous run left pending, compacts the file down to those, and starts the flush thread
+	 *
+	 * @param OutPendingEntries calls that were recorded but never completed, in the order they were made
+	 *
+	 * @return false if the journal file could not be opened, appends are then dropped
+	 */
+	bool Open(TArray<FLeetJournalEntry>& OutPendingEntries);
+
+	/** Flushes everything still buffered and stops the flush thread */
+	void Close();
+
+	/**
+	 * Records a call that is about to be sent
+	 *
+	 * @param APIURI endpoint of the call
+	 * @param Arguments form encoded body of the call
+	 *
+	 * @return id of the new entry, to be passed to MarkComplete
+	 */
+	FString AppendPending(const FString& APIURI, const FString& Arguments);
+
+	/**
+	 * Records a pending entry (new or replayed) as complete
+	 *
+	 * @param EntryId id returned by AppendPending
+	 */
+	void MarkComplete(const FString& EntryId);
+
+	/** @return number of entries recorded but not completed yet */
+	int32 GetNumPending() const { return NumPending.GetValue(); }
+
+	// FRunnable
+
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	/** Copies a record into the append buffer, waking the flush thread once the buffer fills up */
+	void Append(const FString& Record);
+
+	/** Swaps the append buffer out and writes it to disk.  Only called from the flush thread, or after it stopped */
+	void FlushBuffer();
+
+	/** Path of the journal file */
+	FString Filename;
+
+	/** Open journal file, written by the flush thread only */
+	FArchive* Writer;
+
+	/** Buffer appends go to */
+	TArray<ANSICHAR> AppendBuffer;
+
+	/** Buffer being written out by the flush thread, swapped with AppendBuffer */
+	TArray<ANSICHAR> WriteBuffer;
+
+	/** Guards AppendBuffer */
+	FCriticalSection AppendLock;
+
+	/** Size both buffers are preallocated to */
+	int32 BufferSize;
+
+	/** Longest time between flushes, in seconds */
+	float FlushInterval;
+
+	/** Wakes the flush thread early */
+	FEvent* FlushEvent;
+
+	/** The flush thread */
+	FRunnableThread* Thread;
+
+	/** Non zero once the flush thread has been asked to exit */
+	FThreadSafeCounter StopRequested;
+
+	/** Entries recorded but not completed */
+	FThreadSafeCounter NumPending;
+};
@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetLoadTest.h"
+
+#if !UE_BUILD_SHIPPING
+
+const float FLeetLoadTest::DRAIN_TIMEOUT = 60.0f;
+
+namespace
+{
+	FString GetSyntheticPlatformId(int32 PlayerIdx)
+	{
+		return FString::Printf(TEXT("loadtest-%d"), PlayerIdx);
+	}
+}
+
+FLeetLoadTest::FLeetLoadTest(ULeetGameInstance* InGameInstance, const FLeetLoadTestSettings& InSettings)
+	: GameInstance(InGameInstance)
+	, Settings(InSettings)
+	, Phase(EPhase::Idle)
+	, NumJoined(0)
+	, JoinBudget(0.0f)
+	, ChatBudget(0.0f)
+	, KillBudget(0.0f)
+	, NumChatLines(0)
+	, NumKills(0)
+	, StartTime(0.0)
+	, DrainStartTime(0.0)
+{
+}
+
+void FLeetLoadTest::Start()
+{
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetLoadTest] Start %d players at %.0f/s for %.0fs, %.2f chat lines per player per second, %.0f kills/s"),
+		Settings.NumPlayers, Settings.JoinsPerSecond, Settings.Duration, Settings.ChatPerPlayerPerSecond, Settings.KillsPerSecond);
+
+	FLeetMetrics::Get().Reset();
+	StartTime = FPlatformTime::Seconds();
+	Phase = EPhase::Running;
+}
+
+void FLeetLoadTest::Finish()
+{
+	if (Phase != EPhase::Running)
+	{
+		return;
+	}
+
+	ULeetGameInstance* Instance = GameInstance.Get();
+	if (Instance)
+	{
+		for (int32 PlayerIdx = 0; PlayerIdx < NumJoined; PlayerIdx++)
+		{
+			const int32 PlayerID = LOAD_TEST_PLAYER_ID_BASE + PlayerIdx;
+			// Journaled requests are replayed against the configured API on the next start, synthetic players must never get there
+			Instance->DeActivatePlayer(PlayerID, false);
+			Instance->PlayerRegistry.Remove(PlayerID);
+		}
+	}
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetLoadTest] %d players left, draining"), NumJoined);
+	DrainStartTime = FPlatformTime::Seconds();
+	Phase = EPhase::Draining;
+}
+
+bool FLeetLoadTest::Tick(float DeltaTime)
+{
+	ULeetGameInstance* Instance = GameInstance.Get();
+	if (Instance == nullptr && Phase == EPhase::Running)
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetLoadTest] Game instance went away, stopping"));
+		Phase = EPhase::Draining;
+		DrainStartTime = FPlatformTime::Seconds();
+	}
+
+	if (Phase == EPhase::Running)
+	{
+		JoinBudget += Settings.JoinsPerSecond * DeltaTime;
+		while (JoinBudget >= 1.0f && NumJoined < Settings.NumPlayers)
+		{
+			Instance->ActivatePlayer(GetSyntheticPlatformId(NumJoined), LOAD_TEST_PLAYER_ID_BASE + NumJoined);
+			NumJoined++;
+			JoinBudget -= 1.0f;
+		}
+
+		if (NumJoined > 1)
+		{
+			ChatBudget += Settings.ChatPerPlayerPerSecond * NumJoined * DeltaTime;
+			for (; ChatBudget >= 1.0f; ChatBudget -= 1.0f)
+			{
+				Instance->OutgoingChat(LOAD_TEST_PLAYER_ID_BASE + FMath::RandHelper(NumJoined), FText::FromString(TEXT("load test chat line")));
+				NumChatLines++;
+			}
+
+			KillBudget += Settings.KillsPerSecond * DeltaTime;
+			for (; KillBudget >= 1.0f; KillBudget -= 1.0f)
+			{
+				Instance->RecordKill(LOAD_TEST_PLAYER_ID_BASE + FMath::RandHelper(NumJoined), LOAD_TEST_PLAYER_ID_BASE + FMath::RandHelper(NumJoined));
+				NumKills++;
+			}
+		}
+
+		if (FPlatformTime::Seconds() - StartTime >= Settings.Duration)
+		{
+			Finish();
+		}
+	}
+	else if (Phase == EPhase::Draining)
+	{
+		const FLeetHttpTransport& Transport = FLeetHttpTransport::Get();
+		const bool bDrained = Transport.GetNumInFlight() == 0 && Transport.GetNumQueued() == 0 && Transport.GetNumAwaitingRetry() == 0
+			&& ILeetAsyncScheduler::GetNumPending() == 0;
+		if (bDrained || FPlatformTime::Seconds() - DrainStartTime >= DRAIN_TIMEOUT)
+		{
+			Report();
+			Phase = EPhase::Done;
+		}
+	}
+
+	return true;
+}
+
+void FLeetLoadTest::Report()
+{
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	const FLeetEndpointMetrics Totals = FLeetMetrics::Get().GetTotals();
+	const uint64 NumRequests = Totals.Latency.GetCount();
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetLoadTest] %d players, %d chat lines, %d kills in %.1fs"), NumJoined, NumChatLines, NumKills, Elapsed);
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetLoadTest] %llu requests, %.1f/s, %u ok, %u error, %u timeout, %u retried"),
+		NumRequests, Elapsed > 0.0 ? NumRequests / Elapsed : 0.0, Totals.NumSuccess, Totals.NumError, Totals.NumTimeout, Totals.NumRetries);
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetLoadTest] latency p50 %.1fms p90 %.1fms p99 %.1fms p99.9 %.1fms max %.1fms"),
+		Totals.Latency.GetPercentile(0.5) / 1000.0, Totals.Latency.GetPercentile(0.9) / 1000.0, Totals.Latency.GetPercentile(0.99) / 1000.0,
+		Totals.Latency.GetPercentile(0.999) / 1000.0, Totals.Latency.GetMax() / 1000.0);
+	FLeetMetrics::Get().Dump(*GLog);
+}
+
+void FLeetLoadTest::Dump(FOutputDevice& Ar) const
+{
+	static const TCHAR* PhaseNames[] = { TEXT("idle"), TEXT("running"), TEXT("draining"), TEXT("done") };
+	Ar.Logf(TEXT("Leet load test: %s, %d/%d players joined, %d chat lines, %d kills, %.1fs"),
+		PhaseNames[Phase], NumJoined, Settings.NumPlayers, NumChatLines, NumKills, Phase == EPhase::Idle ? 0.0 : FPlatformTime::Seconds() - StartTime);
+}
+
+#endif
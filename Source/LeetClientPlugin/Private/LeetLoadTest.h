@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#if !UE_BUILD_SHIPPING
+
+#include "Ticker.h"
+
+class ULeetGameInstance;
+
+/** Shape of a load test run */
+struct FLeetLoadTestSettings
+{
+	/** Synthetic players joined over the run */
+	int32 NumPlayers;
+	/** Joins per second */
+	float JoinsPerSecond;
+	/** Time from the first join until everyone leaves, in seconds */
+	float Duration;
+	/** Chat lines per joined player per second */
+	float ChatPerPlayerPerSecond;
+	/** Kills per second among the joined players */
+	float KillsPerSecond;
+
+	FLeetLoadTestSettings()
+		: NumPlayers(1000)
+		, JoinsPerSecond(200.0f)
+		, Duration(30.0f)
+		, ChatPerPlayerPerSecond(0.1f)
+		, KillsPerSecond(20.0f)
+	{
+	}
+};
+
+/**
+ * Drives a game instance with synthetic players and reports API throughput and tail latency.
+ *
+ * Players are joined through ActivatePlayer at a fixed rate, chat and kill each other while the run lasts, then
+ * leave through DeActivatePlayer.  Once the transport has drained the request metrics of the run are logged.
+ * Meant to run against FLeetMockApiServer, every call goes to whatever API the game instance points at.
+ * Synthetic players have ids from LOAD_TEST_PLAYER_ID_BASE up and no controller.  Not built in shipping.
+ */
+class LEETCLIENTPLUGIN_API FLeetLoadTest : public FTickerObjectBase
+{
+public:
+
+	/** First playerID handed to synthetic players, far above what the engine assigns */
+	static const int32 LOAD_TEST_PLAYER_ID_BASE = 1000000;
+
+	/** Longest wait for the transport to drain after the players left, in seconds */
+	static const float DRAIN_TIMEOUT;
+
+	FLeetLoadTest(ULeetGameInstance* InGameInstance, const FLeetLoadTestSettings& InSettings);
+
+	/** Resets the request metrics and starts joining players */
+	void Start();
+
+	/** Makes every synthetic player leave now, the report follows once the requests drained */
+	void Finish();
+
+	/** @return true once the report was logged */
+	bool IsDone() const { return Phase == EPhase::Done; }
+
+	/** Writes the progress of the run to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+	// FTickerObjectBase
+
+	virtual bool Tick(float DeltaTime) override;
+
+private:
+
+	struct EPhase
+	{
+		enum Type
+		{
+			Idle,
+			Running,
+			Draining,
+			Done
+		};
+	};
+
+	/** Logs throughput and latency of the run */
+	void Report();
+
+	TWeakObjectPtr<ULeetGameInstance> GameInstance;
+	FLeetLoadTestSettings Settings;
+	EPhase::Type Phase;
+
+	/** Players joined so far, the joined ones are the first NumJoined ids */
+	int32 NumJoined;
+
+	/** Fractional joins, chat lines and kills carried over to the next tick */
+	float JoinBudget;
+	float ChatBudget;
+	float KillBudget;
+
+	int32 NumChatLines;
+	int32 NumKills;
+
+	/** Start of the run and of the drain, in FPlatformTime::Seconds */
+	double StartTime;
+	double DrainStartTime;
+};
+
+#endif
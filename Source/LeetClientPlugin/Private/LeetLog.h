@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+ * Log category of every Leet module.
+ *
+ * Per request, per player and per packet messages are logged at Verbose, lifecycle messages at Log.  Shipping
+ * and Test builds compile everything below Warning out, other builds show Log and above unless raised at runtime
+ * with "log LogLeet Verbose".
+ */
+#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+LEETCLIENTPLUGIN_API DECLARE_LOG_CATEGORY_EXTERN(LogLeet, Log, Warning);
+#else
+LEETCLIENTPLUGIN_API DECLARE_LOG_CATEGORY_EXTERN(LogLeet, Log, All);
+#endif
@@ -0,0 +1,350 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetMetrics.h"
+
+namespace
+{
+	/** Values below this have a bucket each */
+	const int32 LINEAR_BUCKETS = 32;
+	/** Buckets per power of two above the linear range */
+	const int32 SUB_BUCKETS = 16;
+	const int32 SUB_BUCKET_BITS = 4;
+
+	/** Percentiles written to the snapshots */
+	const double SNAPSHOT_PERCENTILES[] = { 0.5, 0.9, 0.99 };
+
+	/** @return true if the path segment carries an id rather than naming a resource */
+	bool IsIdSegment(const FString& Segment)
+	{
+		if (Segment.Len() >= 16)
+		{
+			return true;
+		}
+		// Version segments (v2) name the API, any other digit means an id
+		if (Segment.Len() > 1 && Segment[0] == TEXT('v') && Segment.Mid(1).IsNumeric())
+		{
+			return false;
+		}
+		for (int32 CharIdx = 0; CharIdx < Segment.Len(); CharIdx++)
+		{
+			if (FChar::IsDigit(Segment[CharIdx]))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Escapes a label value for the Prometheus text format */
+	FString EscapePrometheusLabel(const FString& Value)
+	{
+		return Value.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+	}
+}
+
+FLeetLatencyHistogram::FLeetLatencyHistogram()
+	: Count(0)
+	, Sum(0)
+	, Max(0)
+{
+	FMemory::Memzero(Buckets, sizeof(Buckets));
+}
+
+int32 FLeetLatencyHistogram::GetBucketIndex(uint64 Micros)
+{
+	if (Micros < LINEAR_BUCKETS)
+	{
+		return (int32)Micros;
+	}
+	Micros = FMath::Min<uint64>(Micros, MAX_uint32);
+	const int32 HighBit = FMath::FloorLog2((uint32)Micros);
+	const int32 Shift = HighBit - SUB_BUCKET_BITS;
+	const int32 SubBucket = (int32)(Micros >> Shift) - SUB_BUCKETS;
+	return LINEAR_BUCKETS + (HighBit - 5) * SUB_BUCKETS + SubBucket;
+}
+
+uint64 FLeetLatencyHistogram::GetBucketUpperBound(int32 BucketIndex)
+{
+	if (BucketIndex < LINEAR_BUCKETS)
+	{
+		return BucketIndex;
+	}
+	const int32 Offset = BucketIndex - LINEAR_BUCKETS;
+	const int32 HighBit = 5 + Offset / SUB_BUCKETS;
+	const uint64 SubBucket = SUB_BUCKETS + Offset % SUB_BUCKETS;
+	return ((SubBucket + 1) << (HighBit - SUB_BUCKET_BITS)) - 1;
+}
+
+void FLeetLatencyHistogram::Record(uint64 Micros)
+{
+	Buckets[GetBucketIndex(Micros)]++;
+	Count++;
+	Sum += Micros;
+	Max = FMath::Max(Max, Micros);
+}
+
+void FLeetLatencyHistogram::Merge(const FLeetLatencyHistogram& Other)
+{
+	for (int32 BucketIndex = 0; BucketIndex < NUM_BUCKETS; BucketIndex++)
+	{
+		Buckets[BucketIndex] += Other.Buckets[BucketIndex];
+	}
+	Count += Other.Count;
+	Sum += Other.Sum;
+	Max = FMath::Max(Max, Other.Max);
+}
+
+uint64 FLeetLatencyHistogram::GetPercentile(double Fraction) const
+{
+	if (Count == 0)
+	{
+		return 0;
+	}
+	const uint64 Rank = FMath::Max<uint64>(1, (uint64)FMath::CeilToDouble(Fraction * Count));
+	uint64 Seen = 0;
+	for (int32 BucketIndex = 0; BucketIndex < NUM_BUCKETS; BucketIndex++)
+	{
+		Seen += Buckets[BucketIndex];
+		if (Seen >= Rank)
+		{
+			return FMath::Min(GetBucketUpperBound(BucketIndex), Max);
+		}
+	}
+	return Max;
+}
+
+void FLeetEndpointMetrics::Merge(const FLeetEndpointMetrics& Other)
+{
+	Latency.Merge(Other.Latency);
+	NumSuccess += Other.NumSuccess;
+	NumError += Other.NumError;
+	NumTimeout += Other.NumTimeout;
+	NumRetries += Other.NumRetries;
+	BytesOut += Other.BytesOut;
+	BytesIn += Other.BytesIn;
+}
+
+FLeetMetrics* FLeetMetrics::Instance = nullptr;
+
+const float FLeetMetrics::DEFAULT_EXPORT_INTERVAL = 60.0f;
+
+void FLeetMetrics::Startup()
+{
+	check(IsInGameThread());
+	if (Instance == nullptr)
+	{
+		Instance = new FLeetMetrics();
+	}
+}
+
+FLeetMetrics& FLeetMetrics::Get()
+{
+	check(Instance != nullptr);
+	return *Instance;
+}
+
+void FLeetMetrics::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FLeetMetrics::FLeetMetrics()
+	: ExportInterval(DEFAULT_EXPORT_INTERVAL)
+	, TimeUntilExport(DEFAULT_EXPORT_INTERVAL)
+{
+}
+
+bool FLeetMetrics::Tick(float DeltaTime)
+{
+	if (ExportFilename.IsEmpty())
+	{
+		return true;
+	}
+
+	TimeUntilExport -= DeltaTime;
+	if (TimeUntilExport <= 0.0f)
+	{
+		TimeUntilExport = ExportInterval;
+		Export();
+	}
+	return true;
+}
+
+void FLeetMetrics::SetExport(const FString& InExportFilename, float InExportInterval)
+{
+	ExportFilename = InExportFilename;
+	ExportInterval = FMath::Max(1.0f, InExportInterval);
+	TimeUntilExport = ExportInterval;
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetMetrics] SetExport %s every %.0fs"), ExportFilename.IsEmpty() ? TEXT("(off)") : *ExportFilename, ExportInterval);
+}
+
+void FLeetMetrics::RecordRequest(const FString& URL, double Seconds, int32 ResponseCode, int32 InBytesOut, int32 InBytesIn, bool bRetried)
+{
+	FLeetEndpointMetrics& Metrics = Endpoints.FindOrAdd(GetEndpointKey(URL));
+	Metrics.Latency.Record((uint64)FMath::Max(0.0, Seconds * 1000000.0));
+	if (ResponseCode == 0)
+	{
+		Metrics.NumTimeout++;
+	}
+	else if (ResponseCode < EHttpResponseCodes::BadRequest)
+	{
+		Metrics.NumSuccess++;
+	}
+	else
+	{
+		Metrics.NumError++;
+	}
+	if (bRetried)
+	{
+		Metrics.NumRetries++;
+	}
+	Metrics.BytesOut += FMath::Max(0, InBytesOut);
+	Metrics.BytesIn += FMath::Max(0, InBytesIn);
+}
+
+FLeetEndpointMetrics FLeetMetrics::GetTotals() const
+{
+	FLeetEndpointMetrics Totals;
+	for (TMap<FString, FLeetEndpointMetrics>::TConstIterator It(Endpoints); It; ++It)
+	{
+		Totals.Merge(It.Value());
+	}
+	return Totals;
+}
+
+FString FLeetMetrics::GetEndpointKey(const FString& URL)
+{
+	FString Rest = URL;
+	int32 SchemeEnd = Rest.Find(TEXT("://"));
+	if (SchemeEnd != INDEX_NONE)
+	{
+		Rest = Rest.Mid(SchemeEnd + 3);
+	}
+	int32 QueryStart = INDEX_NONE;
+	if (Rest.FindChar(TEXT('?'), QueryStart))
+	{
+		Rest = Rest.Left(QueryStart);
+	}
+
+	// The first segment is the host, kept as is
+	TArray<FString> Segments;
+	Rest.ParseIntoArray(Segments, TEXT("/"), true);
+	FString Key;
+	for (int32 SegmentIdx = 0; SegmentIdx < Segments.Num(); SegmentIdx++)
+	{
+		if (SegmentIdx > 0)
+		{
+			Key += TEXT("/");
+		}
+		Key += SegmentIdx > 0 && IsIdSegment(Segments[SegmentIdx]) ? TEXT("*") : Segments[SegmentIdx].ToLower();
+	}
+	return Key;
+}
+
+void FLeetMetrics::WriteJson(FString& Out) const
+{
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Out);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	Writer->WriteObjectStart(TEXT("endpoints"));
+	for (TMap<FString, FLeetEndpointMetrics>::TConstIterator It(Endpoints); It; ++It)
+	{
+		const FLeetEndpointMetrics& Metrics = It.Value();
+		Writer->WriteObjectStart(It.Key());
+		Writer->WriteValue(TEXT("count"), (double)Metrics.Latency.GetCount());
+		Writer->WriteValue(TEXT("success"), (int32)Metrics.NumSuccess);
+		Writer->WriteValue(TEXT("error"), (int32)Metrics.NumError);
+		Writer->WriteValue(TEXT("timeout"), (int32)Metrics.NumTimeout);
+		Writer->WriteValue(TEXT("retries"), (int32)Metrics.NumRetries);
+		Writer->WriteValue(TEXT("bytesOut"), (double)Metrics.BytesOut);
+		Writer->WriteValue(TEXT("bytesIn"), (double)Metrics.BytesIn);
+		Writer->WriteValue(TEXT("latencyMeanMs"), Metrics.Latency.GetCount() > 0 ? Metrics.Latency.GetSum() / 1000.0 / Metrics.Latency.GetCount() : 0.0);
+		Writer->WriteValue(TEXT("latencyP50Ms"), Metrics.Latency.GetPercentile(0.5) / 1000.0);
+		Writer->WriteValue(TEXT("latencyP90Ms"), Metrics.Latency.GetPercentile(0.9) / 1000.0);
+		Writer->WriteValue(TEXT("latencyP99Ms"), Metrics.Latency.GetPercentile(0.99) / 1000.0);
+		Writer->WriteValue(TEXT("latencyMaxMs"), Metrics.Latency.GetMax() / 1000.0);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteObjectEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+}
+
+void FLeetMetrics::WritePrometheus(FString& Out) const
+{
+	Out += TEXT("# TYPE leet_request_latency_seconds summary\n");
+	for (TMap<FString, FLeetEndpointMetrics>::TConstIterator It(Endpoints); It; ++It)
+	{
+		const FString Endpoint = EscapePrometheusLabel(It.Key());
+		const FLeetLatencyHistogram& Latency = It.Value().Latency;
+		for (int32 PercentileIdx = 0; PercentileIdx < ARRAY_COUNT(SNAPSHOT_PERCENTILES); PercentileIdx++)
+		{
+			Out += FString::Printf(TEXT("leet_request_latency_seconds{endpoint=\"%s\",quantile=\"%g\"} %f\n"), *Endpoint, SNAPSHOT_PERCENTILES[PercentileIdx], Latency.GetPercentile(SNAPSHOT_PERCENTILES[PercentileIdx]) / 1000000.0);
+		}
+		Out += FString::Printf(TEXT("leet_request_latency_seconds_sum{endpoint=\"%s\"} %f\n"), *Endpoint, Latency.GetSum() / 1000000.0);
+		Out += FString::Printf(TEXT("leet_request_latency_seconds_count{endpoint=\"%s\"} %llu\n"), *Endpoint, Latency.GetCount());
+	}
+
+	Out += TEXT("# TYPE leet_requests_total counter\n");
+	for (TMap<FString, FLeetEndpointMetrics>::TConstIterator It(Endpoints); It; ++It)
+	{
+		const FString Endpoint = EscapePrometheusLabel(It.Key());
+		Out += FString::Printf(TEXT("leet_requests_total{endpoint=\"%s\",result=\"success\"} %u\n"), *Endpoint, It.Value().NumSuccess);
+		Out += FString::Printf(TEXT("leet_requests_total{endpoint=\"%s\",result=\"error\"} %u\n"), *Endpoint, It.Value().NumError);
+		Out += FString::Printf(TEXT("leet_requests_total{endpoint=\"%s\",result=\"timeout\"} %u\n"), *Endpoint, It.Value().NumTimeout);
+	}
+
+	Out += TEXT("# TYPE leet_request_retries_total counter\n");
+	for (TMap<FString, FLeetEndpointMetrics>::TConstIterator It(Endpoints); It; ++It)
+	{
+		Out += FString::Printf(TEXT("leet_request_retries_total{endpoint=\"%s\"} %u\n"), *EscapePrometheusLabel(It.Key()), It.Value().NumRetries);
+	}
+
+	Out += TEXT("# TYPE leet_request_bytes_total counter\n");
+	for (TMap<FString, FLeetEndpointMetrics>::TConstIterator It(Endpoints); It; ++It)
+	{
+		const FString Endpoint = EscapePrometheusLabel(It.Key());
+		Out += FString::Printf(TEXT("leet_request_bytes_total{endpoint=\"%s\",direction=\"out\"} %llu\n"), *Endpoint, It.Value().BytesOut);
+		Out += FString::Printf(TEXT("leet_request_bytes_total{endpoint=\"%s\",direction=\"in\"} %llu\n"), *Endpoint, It.Value().BytesIn);
+	}
+}
+
+void FLeetMetrics::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet metrics: %d endpoints"), Endpoints.Num());
+	for (TMap<FString, FLeetEndpointMetrics>::TConstIterator It(Endpoints); It; ++It)
+	{
+		const FLeetEndpointMetrics& Metrics = It.Value();
+		Ar.Logf(TEXT("  %s: %llu calls, %u ok, %u error, %u timeout, %u retried, p50 %.1fms p99 %.1fms max %.1fms, %llu bytes out, %llu bytes in"),
+			*It.Key(), Metrics.Latency.GetCount(), Metrics.NumSuccess, Metrics.NumError, Metrics.NumTimeout, Metrics.NumRetries,
+			Metrics.Latency.GetPercentile(0.5) / 1000.0, Metrics.Latency.GetPercentile(0.99) / 1000.0, Metrics.Latency.GetMax() / 1000.0,
+			Metrics.BytesOut, Metrics.BytesIn);
+	}
+}
+
+void FLeetMetrics::Export() const
+{
+	FString Snapshot;
+	if (ExportFilename.EndsWith(TEXT(".json")))
+	{
+		WriteJson(Snapshot);
+	}
+	else
+	{
+		WritePrometheus(Snapshot);
+	}
+
+	// Written to a temporary file and moved over, a scraper never reads half a snapshot
+	const FString Filename = ExportFilename;
+	AsyncTask(ENamedThreads::AnyThread, [Filename, Snapshot]()
+	{
+		const FString TempFilename = Filename + TEXT(".tmp");
+		if (FFileHelper::SaveStringToFile(Snapshot, *TempFilename))
+		{
+			IFileManager::Get().Move(*Filename, *TempFilename, true, true);
+		}
+	});
+}
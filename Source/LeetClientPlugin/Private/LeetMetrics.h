@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Ticker.h"
+
+/**
+ * Fixed size log-linear latency histogram, in the spirit of an HDR histogram.
+ *
+ * Values are microseconds.  Below 32 every value has its own bucket, above that every power of two is split
+ * into 16 buckets, so any recorded value is known to within about 6% up to a bit over an hour.  Recording is a
+ * couple of shifts and an increment, no allocation.
+ */
+struct LEETCLIENTPLUGIN_API FLeetLatencyHistogram
+{
+	/** Number of buckets, covers values up to 2^32 us */
+	static const int32 NUM_BUCKETS = 32 + 27 * 16;
+
+	FLeetLatencyHistogram();
+
+	/** Adds a value, in microseconds */
+	void Record(uint64 Micros);
+
+	/** Adds every value recorded in another histogram */
+	void Merge(const FLeetLatencyHistogram& Other);
+
+	/** @return value below which the given fraction of the recorded values fall, in microseconds, 0 if empty */
+	uint64 GetPercentile(double Fraction) const;
+
+	uint64 GetCount() const { return Count; }
+	uint64 GetSum() const { return Sum; }
+	uint64 GetMax() const { return Max; }
+
+private:
+
+	/** @return bucket holding the value */
+	static int32 GetBucketIndex(uint64 Micros);
+
+	/** @return highest value the bucket holds */
+	static uint64 GetBucketUpperBound(int32 BucketIndex);
+
+	uint32 Buckets[NUM_BUCKETS];
+	uint64 Count;
+	uint64 Sum;
+	uint64 Max;
+};
+
+/** Everything recorded for one endpoint */
+struct FLeetEndpointMetrics
+{
+	FLeetLatencyHistogram Latency;
+	/** Answers below 400 */
+	uint32 NumSuccess;
+	/** Answers of 400 and above */
+	uint32 NumError;
+	/** Requests that got no answer at all (timeout, connection failure) */
+	uint32 NumTimeout;
+	/** Attempts that were retried */
+	uint32 NumRetries;
+	uint64 BytesOut;
+	uint64 BytesIn;
+
+	/** Adds the counters of another endpoint */
+	void Merge(const FLeetEndpointMetrics& Other);
+
+	FLeetEndpointMetrics()
+		: NumSuccess(0)
+		, NumError(0)
+		, NumTimeout(0)
+		, NumRetries(0)
+		, BytesOut(0)
+		, BytesIn(0)
+	{
+	}
+};
+
+/**
+ * Per endpoint request metrics of the Leet transport, game thread only.
+ *
+ * Endpoints are keyed by host and path, with the path segments that carry ids folded into "*" so the calls
+ * made for every player share one entry.  When an export file is set a snapshot is written to it every
+ * export interval, as JSON if the file ends in .json and as Prometheus text otherwise.  The file is written on
+ * a worker thread.
+ */
+class LEETCLIENTPLUGIN_API FLeetMetrics : public FTickerObjectBase
+{
+public:
+
+	/** Default time between snapshot exports, in seconds */
+	static const float DEFAULT_EXPORT_INTERVAL;
+
+	/** Creates the shared metrics.  Its ticker registers on the game thread, so this is called from module startup */
+	static void Startup();
+
+	/** @return the metrics shared by every Leet module, once they are started */
+	static FLeetMetrics& Get();
+
+	/** Destroys the shared metrics.  Called on module shutdown */
+	static void Shutdown();
+
+	// FTickerObjectBase
+
+	virtual bool Tick(float DeltaTime) override;
+
+	// FLeetMetrics
+
+	/**
+	 * Starts writing a snapshot to a file at a fixed interval
+	 *
+	 * @param InExportFilename file to write, empty turns exporting off
+	 * @param InExportInterval time between two snapshots, in seconds
+	 */
+	void SetExport(const FString& InExportFilename, float InExportInterval);
+
+	/**
+	 * Records one finished attempt of a request
+	 *
+	 * @param URL URL the request was sent to
+	 * @param Seconds time between sending the request and its answer
+	 * @param ResponseCode HTTP status of the answer, 0 if there was none
+	 * @param InBytesOut size of the request body
+	 * @param InBytesIn size of the response body
+	 * @param bRetried whether the attempt is going to be retried
+	 */
+	void RecordRequest(const FString& URL, double Seconds, int32 ResponseCode, int32 InBytesOut, int32 InBytesIn, bool bRetried);
+
+	/** Forgets everything recorded so far */
+	void Reset() { Endpoints.Empty(); }
+
+	/** @return the counters of every endpoint added together */
+	FLeetEndpointMetrics GetTotals() const;
+
+	/** @return metrics key of a URL, host and path with id segments replaced by "*" */
+	static FString GetEndpointKey(const FString& URL);
+
+	/** Writes the snapshot as a JSON object keyed by endpoint */
+	void WriteJson(FString& Out) const;
+
+	/** Writes the snapshot in the Prometheus text exposition format */
+	void WritePrometheus(FString& Out) const;
+
+	/** Writes a one line summary of every endpoint to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+
+	/** Hidden on purpose, use Get() */
+	FLeetMetrics();
+
+	/** Builds the snapshot and writes it out on a worker thread */
+	void Export() const;
+
+	/** Metrics keyed by endpoint */
+	TMap<FString, FLeetEndpointMetrics> Endpoints;
+
+	/** Snapshot file, empty when not exporting */
+	FString ExportFilename;
+
+	/** Time between snapshots, and time left until the next one, in seconds */
+	float ExportInterval;
+	float TimeUntilExport;
+
+	/** The shared instance */
+	static FLeetMetrics* Instance;
+};
@@ -0,0 +1,412 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetMockApiServer.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Networking.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+namespace
+{
+	const uint32 RECEIVE_CHUNK_SIZE = 4096;
+
+	/** @return the UTF-8 bytes as a string */
+	FString BytesToUtf8String(const uint8* Bytes, int32 NumBytes)
+	{
+		if (NumBytes <= 0)
+		{
+			return FString();
+		}
+		FUTF8ToTCHAR Converter((const ANSICHAR*)Bytes, NumBytes);
+		return FString(Converter.Length(), Converter.Get());
+	}
+
+	/** Decodes a form or URL component, %XX and + */
+	FString UrlDecode(const FString& Encoded)
+	{
+		TArray<ANSICHAR> Decoded;
+		for (int32 CharIdx = 0; CharIdx < Encoded.Len(); CharIdx++)
+		{
+			const TCHAR Char = Encoded[CharIdx];
+			if (Char == TEXT('%') && CharIdx + 2 < Encoded.Len() && FChar::IsHexDigit(Encoded[CharIdx + 1]) && FChar::IsHexDigit(Encoded[CharIdx + 2]))
+			{
+				Decoded.Add((ANSICHAR)FParse::HexNumber(*Encoded.Mid(CharIdx + 1, 2)));
+				CharIdx += 2;
+			}
+			else
+			{
+				Decoded.Add(Char == TEXT('+') ? ' ' : (ANSICHAR)Char);
+			}
+		}
+		return BytesToUtf8String((const uint8*)Decoded.GetData(), Decoded.Num());
+	}
+
+	/** @return the decoded value of a form field, empty if absent */
+	FString GetFormValue(const FString& Body, const TCHAR* Key)
+	{
+		TArray<FString> Fields;
+		Body.ParseIntoArray(Fields, TEXT("&"), true);
+		const FString Prefix = FString(Key) + TEXT("=");
+		for (int32 FieldIdx = 0; FieldIdx < Fields.Num(); FieldIdx++)
+		{
+			if (Fields[FieldIdx].StartsWith(Prefix))
+			{
+				return Fields[FieldIdx].Mid(Prefix.Len());
+			}
+		}
+		return FString();
+	}
+
+	FString EscapeJson(const FString& Value)
+	{
+		return Value.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+	}
+
+	const TCHAR* STATUS_OK_JSON = TEXT("{\"authorization\":true}");
+	const TCHAR* NOT_FOUND_JSON = TEXT("{\"authorization\":false,\"error\":\"not found\"}");
+	const TCHAR* INJECTED_ERROR_JSON = TEXT("{\"authorization\":false,\"error\":\"injected\"}");
+}
+
+FLeetMockApiServer::FLeetMockApiServer(const FLeetMockApiSettings& InSettings)
+	: Settings(InSettings)
+	, ListenSocket(nullptr)
+	, Thread(nullptr)
+	, bStopping(false)
+{
+	if (Settings.PayloadBytes > 0)
+	{
+		Padding = FString::ChrN(Settings.PayloadBytes, TEXT('x'));
+	}
+}
+
+FLeetMockApiServer::~FLeetMockApiServer()
+{
+	Shutdown();
+}
+
+bool FLeetMockApiServer::Start()
+{
+	// Loopback only, the mock answers anything and has no business being reachable from the network
+	ListenSocket = FTcpSocketBuilder(TEXT("LeetMockApi"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToAddress(FIPv4Address(127, 0, 0, 1))
+		.BoundToPort(Settings.Port)
+		.Listening(128)
+		.Build();
+	if (ListenSocket == nullptr)
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FLeetMockApiServer] Could not listen on port %d"), Settings.Port);
+		return false;
+	}
+
+	bStopping = false;
+	Thread = FRunnableThread::Create(this, TEXT("LeetMockApi"), 0, TPri_Normal);
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetMockApiServer] Listening on port %d, %.0fms +%.0fms latency, %.1f%% errors, %d bytes padding"),
+		Settings.Port, Settings.LatencyMs, Settings.JitterMs, Settings.ErrorRate * 100.0f, Settings.PayloadBytes);
+	return true;
+}
+
+void FLeetMockApiServer::Shutdown()
+{
+	if (Thread)
+	{
+		// Kill stops the runnable and waits for Run to return, which closes the connections
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+	if (ListenSocket)
+	{
+		ListenSocket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+	}
+}
+
+uint32 FLeetMockApiServer::Run()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	while (!bStopping)
+	{
+		const double Now = FPlatformTime::Seconds();
+
+		bool bHasPendingConnection = false;
+		while (ListenSocket->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+		{
+			FSocket* Socket = ListenSocket->Accept(TEXT("LeetMockApiConnection"));
+			if (Socket == nullptr)
+			{
+				break;
+			}
+			Socket->SetNonBlocking(true);
+			Socket->SetNoDelay(true);
+			Connections[Connections.AddDefaulted()].Socket = Socket;
+			NumConnectionsAccepted.Increment();
+			NumOpenConnections.Increment();
+		}
+
+		for (int32 ConnectionIdx = Connections.Num() - 1; ConnectionIdx >= 0; ConnectionIdx--)
+		{
+			if (!ServiceConnection(Connections[ConnectionIdx], Now))
+			{
+				Connections[ConnectionIdx].Socket->Close();
+				SocketSubsystem->DestroySocket(Connections[ConnectionIdx].Socket);
+				Connections.RemoveAtSwap(ConnectionIdx);
+				NumOpenConnections.Decrement();
+			}
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	for (int32 ConnectionIdx = 0; ConnectionIdx < Connections.Num(); ConnectionIdx++)
+	{
+		Connections[ConnectionIdx].Socket->Close();
+		SocketSubsystem->DestroySocket(Connections[ConnectionIdx].Socket);
+	}
+	Connections.Empty();
+	NumOpenConnections.Reset();
+	return 0;
+}
+
+bool FLeetMockApiServer::ServiceConnection(FConnection& Connection, double Now)
+{
+	uint8 Chunk[RECEIVE_CHUNK_SIZE];
+	uint32 PendingSize = 0;
+	while (Connection.Socket->HasPendingData(PendingSize))
+	{
+		int32 BytesRead = 0;
+		if (!Connection.Socket->Recv(Chunk, sizeof(Chunk), BytesRead) || BytesRead == 0)
+		{
+			// Readable with nothing to read means the client hung up
+			return false;
+		}
+		Connection.Received.Append(Chunk, BytesRead);
+	}
+
+	// Every complete request in the buffer gets its answer queued
+	for (;;)
+	{
+		int32 HeaderEnd = INDEX_NONE;
+		const uint8* Received = Connection.Received.GetData();
+		for (int32 ByteIdx = 0; ByteIdx + 3 < Connection.Received.Num(); ByteIdx++)
+		{
+			if (Received[ByteIdx] == '\r' && Received[ByteIdx + 1] == '\n' && Received[ByteIdx + 2] == '\r' && Received[ByteIdx + 3] == '\n')
+			{
+				HeaderEnd = ByteIdx;
+				break;
+			}
+		}
+		if (HeaderEnd == INDEX_NONE)
+		{
+			break;
+		}
+
+		TArray<FString> HeaderLines;
+		BytesToUtf8String(Received, HeaderEnd).ParseIntoArray(HeaderLines, TEXT("\r\n"), true);
+		TArray<FString> RequestLine;
+		if (HeaderLines.Num() > 0)
+		{
+			HeaderLines[0].ParseIntoArray(RequestLine, TEXT(" "), true);
+		}
+		if (RequestLine.Num() < 2)
+		{
+			return false;
+		}
+
+		int32 ContentLength = 0;
+		for (int32 LineIdx = 1; LineIdx < HeaderLines.Num(); LineIdx++)
+		{
+			if (HeaderLines[LineIdx].StartsWith(TEXT("Content-Length:")))
+			{
+				ContentLength = FCString::Atoi(*HeaderLines[LineIdx].Mid(15).Trim());
+			}
+		}
+
+		const int32 BodyStart = HeaderEnd + 4;
+		if (Connection.Received.Num() < BodyStart + ContentLength)
+		{
+			break;
+		}
+		const FString Body = BytesToUtf8String(Received + BodyStart, ContentLength);
+		Connection.Received.RemoveAt(0, BodyStart + ContentLength, false);
+
+		FString Path = RequestLine[1];
+		FString Query;
+		int32 QueryStart = INDEX_NONE;
+		if (Path.FindChar(TEXT('?'), QueryStart))
+		{
+			Query = Path.Mid(QueryStart + 1);
+			Path = Path.Left(QueryStart);
+		}
+
+		NumRequests.Increment();
+		int32 Status = 200;
+		FString Json = Route(RequestLine[0], Path, Query, Body, Status);
+		if (Settings.ErrorRate > 0.0f && FMath::FRand() < Settings.ErrorRate)
+		{
+			Status = 500;
+			Json = INJECTED_ERROR_JSON;
+		}
+		if (Status != 200)
+		{
+			NumErrors.Increment();
+		}
+		if (!Padding.IsEmpty())
+		{
+			Json = Json.LeftChop(1) + TEXT(",\"padding\":\"") + Padding + TEXT("\"}");
+		}
+
+		FTCHARToUTF8 JsonUtf8(*Json);
+		const FString Head = FString::Printf(TEXT("HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %d\r\nConnection: keep-alive\r\n\r\n"),
+			Status, Status == 200 ? TEXT("OK") : Status == 404 ? TEXT("Not Found") : TEXT("Internal Server Error"), JsonUtf8.Length());
+
+		FAnswer& Answer = Connection.Answers[Connection.Answers.AddDefaulted()];
+		Answer.DueTime = Now + (Settings.LatencyMs + FMath::FRand() * Settings.JitterMs) / 1000.0;
+		if (Connection.Answers.Num() > 1)
+		{
+			// Answers leave in request order, a later one is never due before an earlier one
+			Answer.DueTime = FMath::Max(Answer.DueTime, Connection.Answers[Connection.Answers.Num() - 2].DueTime);
+		}
+		Answer.Bytes.Append((const uint8*)TCHAR_TO_ANSI(*Head), Head.Len());
+		Answer.Bytes.Append((const uint8*)JsonUtf8.Get(), JsonUtf8.Length());
+	}
+
+	while (Connection.Answers.Num() > 0 && Connection.Answers[0].DueTime <= Now)
+	{
+		const FAnswer& Answer = Connection.Answers[0];
+		int32 BytesSent = 0;
+		if (!Connection.Socket->Send(Answer.Bytes.GetData() + Connection.NumSent, Answer.Bytes.Num() - Connection.NumSent, BytesSent))
+		{
+			return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK;
+		}
+		Connection.NumSent += BytesSent;
+		if (Connection.NumSent < Answer.Bytes.Num())
+		{
+			break;
+		}
+		Connection.Answers.RemoveAt(0, 1, false);
+		Connection.NumSent = 0;
+	}
+
+	return Connection.Socket->GetConnectionState() != SCS_ConnectionError;
+}
+
+FString FLeetMockApiServer::Route(const FString& Verb, const FString& Path, const FString& Query, const FString& Body, int32& OutStatus)
+{
+	OutStatus = 200;
+	TArray<FString> Segments;
+	Path.ParseIntoArray(Segments, TEXT("/"), true);
+
+	if (Segments.Num() == 1 && Segments[0] == TEXT("me"))
+	{
+		return TEXT("{\"authorization\":true,\"id\":\"mock-user\",\"name\":\"Mock User\"}");
+	}
+
+	if (Segments.Num() >= 4 && Segments[0] == TEXT("api") && Segments[1] == TEXT("v2"))
+	{
+		const FString& Resource = Segments[2];
+		if (Resource == TEXT("server") && Segments.Num() == 4)
+		{
+			if (Segments[3] == TEXT("info"))
+			{
+				return TEXT("{\"authorization\":true,\"incrementBTC\":100,\"minimumBTCHold\":1000,\"serverRakeBTCPercentage\":0.1,\"leetcoinRakePercentage\":0.05}");
+			}
+			if (Segments[3] == TEXT("links"))
+			{
+				return TEXT("{\"authorization\":true,\"links\":[]}");
+			}
+		}
+		else if (Resource == TEXT("player") && Segments.Num() == 5)
+		{
+			const FString PlatformID = UrlDecode(Segments[3]);
+			if (Segments[4] == TEXT("activate"))
+			{
+				return MakePlayerJson(PlatformID);
+			}
+			if (Segments[4] == TEXT("deactivate") || Segments[4] == TEXT("chat"))
+			{
+				return STATUS_OK_JSON;
+			}
+		}
+		else if (Resource == TEXT("players") && Segments.Num() == 4)
+		{
+			if (Segments[3] == TEXT("activate"))
+			{
+				TArray<FString> PlatformIDs;
+				GetFormValue(Body, TEXT("platform_ids")).ParseIntoArray(PlatformIDs, TEXT(","), true);
+				FString Json = TEXT("{\"authorization\":true,\"players\":[");
+				for (int32 PlayerIdx = 0; PlayerIdx < PlatformIDs.Num(); PlayerIdx++)
+				{
+					if (PlayerIdx > 0)
+					{
+						Json += TEXT(",");
+					}
+					Json += MakePlayerJson(UrlDecode(PlatformIDs[PlayerIdx]));
+				}
+				return Json + TEXT("]}");
+			}
+			if (Segments[3] == TEXT("chat"))
+			{
+				return STATUS_OK_JSON;
+			}
+		}
+		else if (Resource == TEXT("match") && Segments.Num() == 4 && Segments[3] == TEXT("results"))
+		{
+			return STATUS_OK_JSON;
+		}
+		else if (Resource == TEXT("game") && Segments.Num() == 5 && Segments[3] == TEXT("player"))
+		{
+			// Game player keys are handed out as gp-<platform id> by the activation answers
+			const FString PlatformID = UrlDecode(Segments[4]).Mid(3);
+			return FString::Printf(TEXT("{\"authorization\":true,\"platformId\":\"%s\",\"playerKey\":\"p-%s\"}"), *EscapeJson(PlatformID), *EscapeJson(PlatformID));
+		}
+		else if (Resource == TEXT("game") && Segments.Num() == 5 && Segments[4] == TEXT("servers"))
+		{
+			// Pages like the API, the cursor is simply the index of the first server of the next page
+			const FString Limit = GetFormValue(Query, TEXT("limit"));
+			const int32 FirstIdx = FMath::Clamp(FCString::Atoi(*GetFormValue(Query, TEXT("cursor"))), 0, Settings.NumServers);
+			const int32 EndIdx = Limit.IsEmpty() ? Settings.NumServers : FMath::Min(Settings.NumServers, FirstIdx + FMath::Max(FCString::Atoi(*Limit), 1));
+
+			FString Json = TEXT("{\"servers\":[");
+			for (int32 ServerIdx = FirstIdx; ServerIdx < EndIdx; ServerIdx++)
+			{
+				if (ServerIdx > FirstIdx)
+				{
+					Json += TEXT(",");
+				}
+				Json += FString::Printf(TEXT("{\"key\":\"mock-server-%d\",\"title\":\"Mock Server %d\",\"session_host_address\":\"127.0.0.1:%d\"}"), ServerIdx, ServerIdx, 7777 + ServerIdx);
+			}
+			Json += TEXT("]");
+			if (EndIdx < Settings.NumServers)
+			{
+				Json += FString::Printf(TEXT(",\"next_cursor\":\"%d\""), EndIdx);
+			}
+			return Json + TEXT("}");
+		}
+	}
+
+	OutStatus = 404;
+	return NOT_FOUND_JSON;
+}
+
+FString FLeetMockApiServer::MakePlayerJson(const FString& PlatformID) const
+{
+	const FString Id = EscapeJson(PlatformID);
+	return FString::Printf(TEXT("{\"authorization\":true,\"player_authorized\":true,\"player_platformid\":\"%s\",\"player_name\":\"Mock %s\",\"player_key\":\"p-%s\",\"player_btchold\":100000,\"player_rank\":1,\"game_player_member_key\":\"gp-%s\"}"),
+		*Id, *Id, *Id, *Id);
+}
+
+void FLeetMockApiServer::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet mock API on port %d: %d requests, %d errors, %d connections open, %d accepted, %.0fms +%.0fms latency, %.1f%% injected errors, %d bytes padding"),
+		Settings.Port, NumRequests.GetValue(), NumErrors.GetValue(), NumOpenConnections.GetValue(), NumConnectionsAccepted.GetValue(),
+		Settings.LatencyMs, Settings.JitterMs, Settings.ErrorRate * 100.0f, Settings.PayloadBytes);
+}
+
+#endif
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#if !UE_BUILD_SHIPPING
+
+#include "HAL/Runnable.h"
+
+class FSocket;
+
+/** How the mock API behaves */
+struct FLeetMockApiSettings
+{
+	/** Port listened on, all interfaces */
+	int32 Port;
+	/** Time every answer is held back, in milliseconds */
+	float LatencyMs;
+	/** Random extra time added on top of the latency, up to this many milliseconds */
+	float JitterMs;
+	/** Fraction of requests answered with a 500 */
+	float ErrorRate;
+	/** Size of the filler field added to every answer, in bytes */
+	int32 PayloadBytes;
+	/** Number of entries in the server list */
+	int32 NumServers;
+
+	FLeetMockApiSettings()
+		: Port(8089)
+		, LatencyMs(30.0f)
+		, JitterMs(10.0f)
+		, ErrorRate(0.0f)
+		, PayloadBytes(0)
+		, NumServers(20)
+	{
+	}
+};
+
+/**
+ * Local stand-in for the Leet API, for benchmarks and load tests without the sandbox.
+ *
+ * A plain HTTP/1.1 server on its own thread that answers every endpoint the plugin calls (server info and links,
+ * single and batch activation, deactivation, chat, match results, game player, the game's server list and /me)
+ * with canned JSON in the shapes the decoders read.  Connections are kept alive like the real API.  Answers are
+ * delayed by the configured latency without blocking other connections, and a share of them can be turned into
+ * server errors.  Not built in shipping.
+ */
+class LEETCLIENTPLUGIN_API FLeetMockApiServer : public FRunnable
+{
+public:
+
+	FLeetMockApiServer(const FLeetMockApiSettings& InSettings);
+	virtual ~FLeetMockApiServer();
+
+	/** Opens the listen socket and starts the server thread, @return false if the port could not be bound */
+	bool Start();
+
+	/** Stops the server thread and closes every connection */
+	void Shutdown();
+
+	const FLeetMockApiSettings& GetSettings() const { return Settings; }
+
+	/** Writes the request counters to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+	// FRunnable
+
+	virtual uint32 Run() override;
+	virtual void Stop() override { bStopping = true; }
+
+private:
+
+	/** An answer held back until its latency has passed */
+	struct FAnswer
+	{
+		/** When it may go out, in FPlatformTime::Seconds */
+		double DueTime;
+		/** Status line, headers and body */
+		TArray<uint8> Bytes;
+	};
+
+	/** An accepted connection */
+	struct FConnection
+	{
+		FSocket* Socket;
+		/** Bytes received and not parsed into a request yet */
+		TArray<uint8> Received;
+		/** Answers waiting to go out, in request order */
+		TArray<FAnswer> Answers;
+		/** Part of the first answer already sent */
+		int32 NumSent;
+
+		FConnection()
+			: Socket(nullptr)
+			, NumSent(0)
+		{
+		}
+	};
+
+	/** Reads what arrived on a connection and queues the answers, @return false once the connection is closed */
+	bool ServiceConnection(FConnection& Connection, double Now);
+
+	/**
+	 * Builds the answer to a request
+	 *
+	 * @param Verb request method
+	 * @param Path request path without the query string
+	 * @param Query query string of the request, without the '?'
+	 * @param Body request body
+	 * @param OutStatus HTTP status of the answer
+	 *
+	 * @return the JSON body of the answer
+	 */
+	FString Route(const FString& Verb, const FString& Path, const FString& Query, const FString& Body, int32& OutStatus);
+
+	/** @return JSON of one activated player, in the shape of the activation endpoints */
+	FString MakePlayerJson(const FString& PlatformID) const;
+
+	FLeetMockApiSettings Settings;
+
+	/** Filler field appended to every answer, empty without PayloadBytes */
+	FString Padding;
+
+	FSocket* ListenSocket;
+	FRunnableThread* Thread;
+
+	/** Server thread only */
+	TArray<FConnection> Connections;
+
+	/** Set to end the server thread */
+	volatile bool bStopping;
+
+	/** Counters, written by the server thread */
+	FThreadSafeCounter NumRequests;
+	FThreadSafeCounter NumErrors;
+	FThreadSafeCounter NumConnectionsAccepted;
+	FThreadSafeCounter NumOpenConnections;
+};
+
+#endif
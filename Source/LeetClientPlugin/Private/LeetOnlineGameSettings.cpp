@@ -20,16 +20,60 @@ FLeetOnlineSessionSettings::FLeetOnlineSessionSettings(bool bIsLAN, bool bIsPres
 	bAllowJoinViaPresenceFriendsOnly = false;
 }
 
-FLeetOnlineSearchSettings::FLeetOnlineSearchSettings(bool bSearchingLAN, bool bSearchingPresence)
+void FLeetSearchResultsDelta::Add(const FString& Key)
+{
+	// Removed and back again in one batch, the consumer still has the old row
+	if (Removed.Remove(Key) > 0)
+	{
+		Updated.AddUnique(Key);
+	}
+	else
+	{
+		Added.AddUnique(Key);
+	}
+}
+
+void FLeetSearchResultsDelta::Update(const FString& Key)
+{
+	if (!Added.Contains(Key))
+	{
+		Updated.AddUnique(Key);
+	}
+}
+
+void FLeetSearchResultsDelta::Remove(const FString& Key)
+{
+	Updated.Remove(Key);
+	if (Added.Remove(Key) == 0)
+	{
+		Removed.AddUnique(Key);
+	}
+}
+
+FString FLeetSearchResultsDelta::GetResultKey(const FOnlineSessionSearchResult& SearchResult)
+{
+	FString Key;
+	if (!SearchResult.Session.SessionSettings.Get(FName(TEXT("serverKey")), Key) && SearchResult.Session.SessionInfo.IsValid())
+	{
+		Key = SearchResult.Session.SessionInfo->GetSessionId().ToString();
+	}
+	return Key;
+}
+
+FLeetOnlineSearchSettings::FLeetOnlineSearchSettings(bool bSearchingLAN, bool bSearchingPresence, bool bStreamResults)
 {
 	bIsLanQuery = bSearchingLAN;
-	MaxSearchResults = 10;
+	MaxSearchResults = DEFAULT_MAX_SEARCH_RESULTS;
 	PingBucketSize = 50;
 
 	if (bSearchingPresence)
 	{
 		QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
 	}
+	if (bStreamResults)
+	{
+		QuerySettings.Set(SEARCH_LEET_STREAM_RESULTS, true, EOnlineComparisonOp::Equals);
+	}
 }
 
 FLeetOnlineSearchSettingsEmptyDedicated::FLeetOnlineSearchSettingsEmptyDedicated(bool bSearchingLAN, bool bSearchingPresence) :
@@ -16,15 +16,63 @@ public:
 	virtual ~FLeetOnlineSessionSettings() {}
 };
 
+/** Set on searches that publish their results while they run, see FLeetOnlineSearchSettings::OnResultsChanged */
+#define SEARCH_LEET_STREAM_RESULTS FName(TEXT("LEETSTREAMRESULTS"))
+
+/**
+ * One batch of changes to the results of a streaming search.
+ *
+ * Results are named by their key, the serverKey setting of online results and the session id of LAN results, as
+ * their index in SearchResults moves when results are removed or sorted.
+ */
+struct LEETCLIENTPLUGIN_API FLeetSearchResultsDelta
+{
+	TArray<FString> Added;
+	TArray<FString> Updated;
+	TArray<FString> Removed;
+
+	/** Records a new result */
+	void Add(const FString& Key);
+
+	/** Records a change to a result, nothing extra if it is new in this batch */
+	void Update(const FString& Key);
+
+	/** Records a removed result, a result added and removed in the same batch is dropped altogether */
+	void Remove(const FString& Key);
+
+	bool IsEmpty() const { return Added.Num() == 0 && Updated.Num() == 0 && Removed.Num() == 0; }
+
+	/** @return the key a result is named by in the batches, empty for a result without one */
+	static FString GetResultKey(const FOnlineSessionSearchResult& SearchResult);
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnLeetSearchResultsChanged, const FLeetSearchResultsDelta& /*Delta*/);
+
 /**
 * General search setting for a Shooter game
 */
 class FLeetOnlineSearchSettings : public FOnlineSessionSearch
 {
 public:
-	FLeetOnlineSearchSettings(bool bSearchingLAN = false, bool bSearchingPresence = false);
+	/** Servers a search lists by default, the API picks them before they are pinged so this stays well above a screenful */
+	static const int32 DEFAULT_MAX_SEARCH_RESULTS = 200;
+
+	FLeetOnlineSearchSettings(bool bSearchingLAN = false, bool bSearchingPresence = false, bool bStreamResults = false);
 
 	virtual ~FLeetOnlineSearchSettings() {}
+
+	/**
+	 * Fired on the game thread with every batch of results added, updated or removed while the search runs, and
+	 * for ping updates after it completed.  Only fired for searches made with bStreamResults.
+	 */
+	FOnLeetSearchResultsChanged OnResultsChanged;
+
+	/** @return the search as a streaming Leet search, null for searches that don't stream */
+	static FLeetOnlineSearchSettings* AsStreaming(FOnlineSessionSearch& Search)
+	{
+		bool bStreamResults = false;
+		return Search.QuerySettings.Get(SEARCH_LEET_STREAM_RESULTS, bStreamResults) && bStreamResults ? static_cast<FLeetOnlineSearchSettings*>(&Search) : nullptr;
+	}
 };
 
 /**
@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetPlayerRegistry.h"
+
+FLeetPlayerRegistry::FLeetPlayerRegistry()
+{
+}
+
+FLeetPlayerRegistry::~FLeetPlayerRegistry()
+{
+	Empty();
+}
+
+FLeetActivePlayer* FLeetPlayerRegistry::Add(const FLeetActivePlayer& Player)
+{
+	if (ByPlayerId.Contains(Player.playerID))
+	{
+		return nullptr;
+	}
+
+	FLeetActivePlayer* NewPlayer = new FLeetActivePlayer(Player);
+	Players.Add(NewPlayer);
+	Index(NewPlayer);
+	SET_DWORD_STAT(STAT_LeetActivePlayers, Players.Num());
+	return NewPlayer;
+}
+
+bool FLeetPlayerRegistry::Remove(int32 PlayerID)
+{
+	FLeetActivePlayer* Player = FindByPlayerId(PlayerID);
+	if (Player == nullptr)
+	{
+		return false;
+	}
+
+	Unindex(Player);
+	for (int32 PlayerIdx = 0; PlayerIdx < Players.Num(); PlayerIdx++)
+	{
+		if (&Players[PlayerIdx] == Player)
+		{
+			Players.RemoveAt(PlayerIdx);
+			break;
+		}
+	}
+	SET_DWORD_STAT(STAT_LeetActivePlayers, Players.Num());
+	return true;
+}
+
+void FLeetPlayerRegistry::Empty()
+{
+	ByPlayerId.Empty();
+	ByPlayerKey.Empty();
+	ByPlatformId.Empty();
+	ByGamePlayerKey.Empty();
+	Players.Empty();
+	InternedKeys.Empty();
+	HandleByKey.Empty();
+	SET_DWORD_STAT(STAT_LeetActivePlayers, 0);
+}
+
+FLeetActivePlayer* FLeetPlayerRegistry::FindByPlayerId(int32 PlayerID) const
+{
+	FLeetActivePlayer* const* Player = ByPlayerId.Find(PlayerID);
+	return Player ? *Player : nullptr;
+}
+
+FLeetActivePlayer* FLeetPlayerRegistry::FindByPlayerKey(const FString& PlayerKey) const
+{
+	FLeetActivePlayer* const* Player = ByPlayerKey.Find(PlayerKey);
+	return Player ? *Player : nullptr;
+}
+
+FLeetActivePlayer* FLeetPlayerRegistry::FindByPlatformId(const FString& PlatformID) const
+{
+	FLeetActivePlayer* const* Player = ByPlatformId.Find(PlatformID);
+	return Player ? *Player : nullptr;
+}
+
+FLeetActivePlayer* FLeetPlayerRegistry::FindByGamePlayerKey(const FString& GamePlayerKey) const
+{
+	FLeetActivePlayer* const* Player = ByGamePlayerKey.Find(GamePlayerKey);
+	return Player ? *Player : nullptr;
+}
+
+void FLeetPlayerRegistry::SetPlayerKey(FLeetActivePlayer& Player, const FString& PlayerKey)
+{
+	if (ByPlayerKey.FindRef(Player.playerKey) == &Player)
+	{
+		ByPlayerKey.Remove(Player.playerKey);
+	}
+	Player.playerKey = PlayerKey;
+	Player.KeyHandle = INDEX_NONE;
+	if (!PlayerKey.IsEmpty())
+	{
+		ByPlayerKey.Add(PlayerKey, &Player);
+		Player.KeyHandle = InternPlayerKey(PlayerKey);
+	}
+}
+
+void FLeetPlayerRegistry::SetGamePlayerKey(FLeetActivePlayer& Player, const FString& GamePlayerKey)
+{
+	if (ByGamePlayerKey.FindRef(Player.gamePlayerKey) == &Player)
+	{
+		ByGamePlayerKey.Remove(Player.gamePlayerKey);
+	}
+	Player.gamePlayerKey = GamePlayerKey;
+	if (!GamePlayerKey.IsEmpty())
+	{
+		ByGamePlayerKey.Add(GamePlayerKey, &Player);
+	}
+}
+
+void FLeetPlayerRegistry::Update(FLeetActivePlayer& Player, const FLeetActivePlayer& NewState)
+{
+	Unindex(&Player);
+	Player = NewState;
+	Index(&Player);
+}
+
+bool FLeetPlayerRegistry::AddKill(FLeetActivePlayer& Killer, const FLeetActivePlayer& Victim)
+{
+	if (Victim.KeyHandle == INDEX_NONE)
+	{
+		return false;
+	}
+
+	if (Killer.KilledHandles.Num() <= Victim.KeyHandle)
+	{
+		Killer.KilledHandles.Add(false, Victim.KeyHandle + 1 - Killer.KilledHandles.Num());
+	}
+	if (Killer.KilledHandles[Victim.KeyHandle])
+	{
+		return false;
+	}
+	Killer.KilledHandles[Victim.KeyHandle] = true;
+	return true;
+}
+
+void FLeetPlayerRegistry::GetKilledKeys(const FLeetActivePlayer& Player, TArray<FString>& OutKeys) const
+{
+	for (TConstSetBitIterator<> It(Player.KilledHandles); It; ++It)
+	{
+		OutKeys.Add(InternedKeys[It.GetIndex()]);
+	}
+}
+
+const FString& FLeetPlayerRegistry::GetKeyForHandle(int32 KeyHandle) const
+{
+	return InternedKeys[KeyHandle];
+}
+
+int32 FLeetPlayerRegistry::Num() const
+{
+	return Players.Num();
+}
+
+FLeetActivePlayer& FLeetPlayerRegistry::GetPlayer(int32 Index) const
+{
+	return const_cast<FLeetActivePlayer&>(Players[Index]);
+}
+
+void FLeetPlayerRegistry::Export(FLeetActivePlayers& OutPlayers) const
+{
+	OutPlayers.ActivePlayers.Empty(Players.Num());
+	for (int32 PlayerIdx = 0; PlayerIdx < Players.Num(); PlayerIdx++)
+	{
+		FLeetActivePlayer& Exported = OutPlayers.ActivePlayers[OutPlayers.ActivePlayers.Add(Players[PlayerIdx])];
+		Exported.killed.Empty();
+		GetKilledKeys(Players[PlayerIdx], Exported.killed);
+	}
+}
+
+void FLeetPlayerRegistry::Index(FLeetActivePlayer* Player)
+{
+	// Keys are only known once the API answered, empty ones are not indexed
+	ByPlayerId.Add(Player->playerID, Player);
+	Player->KeyHandle = INDEX_NONE;
+	if (!Player->playerKey.IsEmpty())
+	{
+		ByPlayerKey.Add(Player->playerKey, Player);
+		Player->KeyHandle = InternPlayerKey(Player->playerKey);
+	}
+	if (!Player->platformID.IsEmpty())
+	{
+		ByPlatformId.Add(Player->platformID, Player);
+	}
+	if (!Player->gamePlayerKey.IsEmpty())
+	{
+		ByGamePlayerKey.Add(Player->gamePlayerKey, Player);
+	}
+}
+
+void FLeetPlayerRegistry::Unindex(FLeetActivePlayer* Player)
+{
+	// Only drop entries that still point at this player, another one may have taken the key over since
+	if (ByPlayerId.FindRef(Player->playerID) == Player)
+	{
+		ByPlayerId.Remove(Player->playerID);
+	}
+	if (ByPlayerKey.FindRef(Player->playerKey) == Player)
+	{
+		ByPlayerKey.Remove(Player->playerKey);
+	}
+	if (ByPlatformId.FindRef(Player->platformID) == Player)
+	{
+		ByPlatformId.Remove(Player->platformID);
+	}
+	if (ByGamePlayerKey.FindRef(Player->gamePlayerKey) == Player)
+	{
+		ByGamePlayerKey.Remove(Player->gamePlayerKey);
+	}
+}
+
+int32 FLeetPlayerRegistry::InternPlayerKey(const FString& PlayerKey)
+{
+	if (const int32* KeyHandle = HandleByKey.Find(PlayerKey))
+	{
+		return *KeyHandle;
+	}
+	const int32 NewHandle = InternedKeys.Add(PlayerKey);
+	HandleByKey.Add(PlayerKey, NewHandle);
+	return NewHandle;
+}
+
+void FLeetPlayerRegistry::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet players: %d registered, %d keys interned"), Players.Num(), InternedKeys.Num());
+	for (int32 PlayerIdx = 0; PlayerIdx < Players.Num(); PlayerIdx++)
+	{
+		const FLeetActivePlayer& Player = GetPlayer(PlayerIdx);
+		Ar.Logf(TEXT("  %d %s (%s): %s, key %s, game key %s, %d kills, %d deaths, rank %d, hold %d"),
+			Player.playerID, *Player.platformID, *Player.playerTitle, Player.authorized ? TEXT("authorized") : TEXT("pending"),
+			*Player.playerKey, *Player.gamePlayerKey, Player.roundKills, Player.roundDeaths, Player.Rank, Player.BTCHold);
+	}
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+struct FLeetActivePlayer;
+struct FLeetActivePlayers;
+
+/**
+ * Active players of the server, indexed for constant time lookup by playerID, playerKey, platformID and gamePlayerKey.
+ *
+ * Players are heap allocated one by one, so the FLeetActivePlayer pointers handed out stay valid until the player
+ * is removed, no matter how many players join after them.  The indexed fields must only be changed through the
+ * registry (Set* / Update) or lookups will go stale.
+ *
+ * playerKeys are interned to small integer handles when they become known, kill lists are bitsets over those
+ * handles and only turned back into keys when results are submitted.  Handles outlive the player so kills of
+ * a player that already left can still be reported.
+ */
+class LEETCLIENTPLUGIN_API FLeetPlayerRegistry
+{
+public:
+
+	FLeetPlayerRegistry();
+	~FLeetPlayerRegistry();
+
+	/**
+	 * Adds a player to the registry
+	 *
+	 * @param Player initial state of the player, its playerID must not be registered yet
+	 *
+	 * @return stable pointer to the registered player, nullptr if the playerID is already taken
+	 */
+	FLeetActivePlayer* Add(const FLeetActivePlayer& Player);
+
+	/** Removes the player with the given playerID, invalidating pointers to it */
+	bool Remove(int32 PlayerID);
+
+	/** Removes every player */
+	void Empty();
+
+	FLeetActivePlayer* FindByPlayerId(int32 PlayerID) const;
+	FLeetActivePlayer* FindByPlayerKey(const FString& PlayerKey) const;
+	FLeetActivePlayer* FindByPlatformId(const FString& PlatformID) const;
+	FLeetActivePlayer* FindByGamePlayerKey(const FString& GamePlayerKey) const;
+
+	/** Changes the playerKey of a registered player, keeping the index in sync */
+	void SetPlayerKey(FLeetActivePlayer& Player, const FString& PlayerKey);
+
+	/** Changes the gamePlayerKey of a registered player, keeping the index in sync */
+	void SetGamePlayerKey(FLeetActivePlayer& Player, const FString& GamePlayerKey);
+
+	/** Replaces the whole state of a registered player, keeping every index in sync */
+	void Update(FLeetActivePlayer& Player, const FLeetActivePlayer& NewState);
+
+	/**
+	 * Adds the victim to the killer's kill list
+	 *
+	 * @return true if the victim was not in the list yet, false if it was or the victim has no playerKey yet
+	 */
+	bool AddKill(FLeetActivePlayer& Killer, const FLeetActivePlayer& Victim);
+
+	/** Appends the playerKeys of the player's victims */
+	void GetKilledKeys(const FLeetActivePlayer& Player, TArray<FString>& OutKeys) const;
+
+	/** @return the playerKey interned to the handle */
+	const FString& GetKeyForHandle(int32 KeyHandle) const;
+
+	/** @return number of registered players */
+	int32 Num() const;
+
+	/** @return the player at the given position, players are kept in the order they joined */
+	FLeetActivePlayer& GetPlayer(int32 Index) const;
+
+	/** Copies the registered players into the USTRUCT used for JSON serialization */
+	void Export(FLeetActivePlayers& OutPlayers) const;
+
+	/** Writes one line per registered player to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+
+	/** Adds the keyed fields of a player to the indices */
+	void Index(FLeetActivePlayer* Player);
+
+	/** Removes the keyed fields of a player from the indices */
+	void Unindex(FLeetActivePlayer* Player);
+
+	/** @return the handle of the playerKey, interning it first if needed */
+	int32 InternPlayerKey(const FString& PlayerKey);
+
+	/** Players in join order, individually allocated so their addresses never move */
+	TIndirectArray<FLeetActivePlayer> Players;
+
+	TMap<int32, FLeetActivePlayer*> ByPlayerId;
+	TMap<FString, FLeetActivePlayer*> ByPlayerKey;
+	TMap<FString, FLeetActivePlayer*> ByPlatformId;
+	TMap<FString, FLeetActivePlayer*> ByGamePlayerKey;
+
+	/** Interned playerKeys, indexed by handle */
+	TArray<FString> InternedKeys;
+	TMap<FString, int32> HandleByKey;
+
+	/** Not copyable, the indices point into the owned players */
+	FLeetPlayerRegistry(const FLeetPlayerRegistry&);
+	FLeetPlayerRegistry& operator=(const FLeetPlayerRegistry&);
+};
@@ -7,86 +7,136 @@
 // This is supposed to be last for some voodoo
 #include "LeetPlayerState.h"
 
+namespace
+{
+	/** The same line sent again within this many seconds is merged into the first one */
+	const double CHAT_REPEAT_WINDOW_SECONDS = 2.0;
+}
+
+ALeetPlayerState::ALeetPlayerState(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, ChatBurst(1.0f)
+	, ChatRefillPerSecond(1.0f)
+	, ChatTokens(1.0f)
+	, ChatLastRefillTime(0.0)
+	, LastChatMessageTime(0.0)
+	, NumChatMessagesDropped(0)
+	, NumChatMessagesMerged(0)
+{
+}
+
+void ALeetPlayerState::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Looked up once here so the per message check never has to
+	ULeetGameInstance* TheGameInstance = GetWorld() ? Cast<ULeetGameInstance>(GetWorld()->GetGameInstance()) : nullptr;
+	if (TheGameInstance)
+	{
+		ChatBurst = TheGameInstance->GetChatBurst();
+		ChatRefillPerSecond = TheGameInstance->GetChatRefillPerSecond();
+	}
+	ChatTokens = ChatBurst;
+	ChatLastRefillTime = FPlatformTime::Seconds();
+}
+
+bool ALeetPlayerState::ConsumeChatToken()
+{
+	const double Now = FPlatformTime::Seconds();
+	ChatTokens = FMath::Min(ChatBurst, ChatTokens + (float)(Now - ChatLastRefillTime) * ChatRefillPerSecond);
+	ChatLastRefillTime = Now;
+
+	if (ChatTokens < 1.0f)
+	{
+		return false;
+	}
+	ChatTokens -= 1.0f;
+	return true;
+}
 
 void ALeetPlayerState::BroadcastChatMessage_Implementation( const FText& ChatMessageIn)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation "));
+	// Spam is shed before it costs a string conversion or a lookup
+	if (!ConsumeChatToken())
+	{
+		NumChatMessagesDropped++;
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation - rate limited, %d dropped"), NumChatMessagesDropped);
+		return;
+	}
+
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation "));
+
+	FString ChatMessageInString = ChatMessageIn.ToString();
+
+	// Someone holding down enter gets their line once
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastChatMessageTime < CHAT_REPEAT_WINDOW_SECONDS && ChatMessageInString == LastChatMessage)
+	{
+		NumChatMessagesMerged++;
+		return;
+	}
+	LastChatMessage = ChatMessageInString;
+	LastChatMessageTime = Now;
 
 	// Use Game Instance because it does not get erased on level change
 	// Get the game instance and cast to our game instance.
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation - get game instance "));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation - get game instance "));
 	ULeetGameInstance* TheGameInstance = Cast<ULeetGameInstance>(GetWorld()->GetGameInstance());
 
 	// Get the activePlayer record
 	FLeetActivePlayer* playerRecord = TheGameInstance->getPlayerByPlayerId(PlayerId);
 
 	//Check to see if it was a / command, in which case we can process it here.
-	FString ChatMessageInString = ChatMessageIn.ToString();
-	if (ChatMessageInString.StartsWith("/"))
+	if (FLeetChatCommands::IsCommand(ChatMessageInString))
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation - Found slash command "));
-		if (ChatMessageInString.StartsWith("/balance"))
-		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation -  /balance  "));
-			FString commandResponseSender = "SYSTEM";
-			FText ChatSenderSYS = FText::FromString(commandResponseSender);
-			
-			FString playerBalance = FString::FromInt(playerRecord->BTCHold);
-			FString commandResponse = "Balance: " + playerBalance;
-
-			// old way
-			//FString playerBalance = FString::FromInt(TheGameInstance->getPlayerBalanceByPlayerID(PlayerId));
-
-			FText ChatMessageOut = FText::FromString(commandResponse);
-			ReceiveChatMessage(ChatSenderSYS, ChatMessageOut);
-			
-		}
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation - Found slash command "));
+
+		// Answered from what the server already knows, and only to the player who asked
+		FLeetChatCommandContext CommandContext(playerRecord, TheGameInstance->GetCachedServerLinks());
+		FString commandResponse;
+		FLeetChatCommands::Get().Execute(ChatMessageInString, CommandContext, commandResponse);
+		ClientReceiveChatMessage(TEXT("SYSTEM"), commandResponse);
 	}
 	else
 	{
 
 
-		//Send the message upstream to the LEET API
-		//TheGameInstance->OutgoingChat(PlayerId, ChatMessageIn);
+		//Send the message upstream to the LEET API, relayed in batches
+		TheGameInstance->OutgoingChat(PlayerId, ChatMessageIn);
 
-		UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation Looping over Player controllers "));
-		// Trying the chatacter controller iterator instead of playerarray
-		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+		// One multicast from the game state reaches every client, batched with whatever else was said this frame
+		ALeetGameState* TheGameState = Cast<ALeetGameState>(GetWorld()->GameState);
+		if (TheGameState)
 		{
-			// old way
-			/*
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation Casting to MyPlayerController "));
-			AMyPlayerController* Controller = Cast<AMyPlayerController>(*Iterator);
-			UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation Getting PlayerState "));
-			AMyPlayerState* pstate = Cast<AMyPlayerState>(Controller->PlayerState);
-			// Go through the activelist to grab our playerName
-			UMyGameInstance* TheGameInstance = Cast<UMyGameInstance>(GetWorld()->GetGameInstance());
-			FString thePlayerTitle = TheGameInstance->getPlayerTitleByPlayerID(PlayerId);
-			*/
-
-			FText thePlayerName = FText::FromString(playerRecord->playerTitle);
-			this->ReceiveChatMessage(thePlayerName, ChatMessageIn);
-		
+			// Players still activating have no record yet, they speak under their PlayerState name until then
+			const FString& SenderTitle = playerRecord ? playerRecord->playerTitle : PlayerName;
+			TheGameState->QueueChatLine(SenderTitle, ChatMessageInString);
 		}
 	}
 
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation Done. "));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] BroadcastChatMessage_Implementation Done. "));
 }
 
 bool ALeetPlayerState::BroadcastChatMessage_Validate(const FText& ChatMessageIn)
 {
-	UE_LOG(LogTemp, Log, TEXT("Validate"));
+	UE_LOG(LogLeet, Verbose, TEXT("Validate"));
 	return true;
 }
 
+void ALeetPlayerState::ClientReceiveChatMessage_Implementation(const FString& ChatSender, const FString& ChatMessage)
+{
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] ClientReceiveChatMessage_Implementation "));
+	OnTextDelegate.Broadcast(FText::FromString(ChatSender), FText::FromString(ChatMessage));
+}
+
 void ALeetPlayerState::ReceiveChatMessage_Implementation(const FText& ChatSender, const FText& ChatMessageD)
 {
 	// do stuff on client here
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] ReceiveChatMessage_Implementation "));
-	//UE_LOG(LogTemp, Log, TEXT("[LEET] [AMyPlayerState] ReceiveChatMessage_Implementation Broadcasting Delegate"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] ReceiveChatMessage_Implementation "));
+	//UE_LOG(LogLeet, Verbose, TEXT("[LEET] [AMyPlayerState] ReceiveChatMessage_Implementation Broadcasting Delegate"));
 	OnTextDelegate.Broadcast(ChatSender, ChatMessageD);
 
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] [ALeetPlayerState] ReceiveChatMessage_Implementation Done."));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] [ALeetPlayerState] ReceiveChatMessage_Implementation Done."));
 }
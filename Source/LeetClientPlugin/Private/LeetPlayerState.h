@@ -51,7 +51,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTextDelegate, FText, chatSender, F
 UCLASS()
 class LEETCLIENTPLUGIN_API ALeetPlayerState : public APlayerState
 {
-	GENERATED_BODY()
+	GENERATED_UCLASS_BODY()
 
 		FLeetInventory Inventory;
 	
@@ -65,10 +65,47 @@ public:
 	UFUNCTION(NetMulticast, Category = "LEET", Unreliable)
 		void ReceiveChatMessage(const FText& ChatSender, const FText& ChatMessage);
 
+	// Called by the server on the owning client only, for replies meant for this player
+	UFUNCTION(Client, Reliable)
+		void ClientReceiveChatMessage(const FString& ChatSender, const FString& ChatMessage);
+
 
 	UPROPERTY(BlueprintAssignable)
 	FTextDelegate OnTextDelegate;
 
 	FString platformId;
 
+	virtual void PostInitializeComponents() override;
+
+	/** Chat lines thrown away by the rate limiter, server only */
+	int32 GetNumChatMessagesDropped() const { return NumChatMessagesDropped; }
+
+	/** Chat lines folded into the previous identical one, server only */
+	int32 GetNumChatMessagesMerged() const { return NumChatMessagesMerged; }
+
+protected:
+
+	/**
+	 * Token bucket guarding BroadcastChatMessage, server only.  Each line takes a token, tokens come back at
+	 * ChatRefillPerSecond up to ChatBurst.
+	 *
+	 * @return true if the line may go through
+	 */
+	bool ConsumeChatToken();
+
+	/** Bucket size and refill rate, copied from the game instance when the player state is spawned */
+	float ChatBurst;
+	float ChatRefillPerSecond;
+
+	/** Tokens left and when they were last topped up, in FPlatformTime::Seconds */
+	float ChatTokens;
+	double ChatLastRefillTime;
+
+	/** Last line let through and when, a quick repeat of it is merged away */
+	FString LastChatMessage;
+	double LastChatMessageTime;
+
+	int32 NumChatMessagesDropped;
+	int32 NumChatMessagesMerged;
+
 };
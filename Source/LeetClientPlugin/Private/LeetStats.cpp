@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetStats.h"
+
+DEFINE_STAT(STAT_LeetBuildRequest);
+DEFINE_STAT(STAT_LeetJsonDecode);
+DEFINE_STAT(STAT_LeetRecordKill);
+DEFINE_STAT(STAT_LeetChatFanOut);
+DEFINE_STAT(STAT_LeetLanBeacon);
+DEFINE_STAT(STAT_LeetCompletionDispatch);
+DEFINE_STAT(STAT_LeetTransportTick);
+DEFINE_STAT(STAT_LeetQosPing);
+
+DEFINE_STAT(STAT_LeetRequestsInFlight);
+DEFINE_STAT(STAT_LeetRequestsQueued);
+DEFINE_STAT(STAT_LeetApiTasksPending);
+DEFINE_STAT(STAT_LeetCompletionQueueDepth);
+DEFINE_STAT(STAT_LeetChatRelayQueueDepth);
+DEFINE_STAT(STAT_LeetActivePlayers);
+DEFINE_STAT(STAT_LeetQosProbesInFlight);
+
+DEFINE_STAT(STAT_LeetDecodeMemory);
+DEFINE_STAT(STAT_LeetChatRelayMemory);
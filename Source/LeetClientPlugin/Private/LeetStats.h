@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+/**
+ * Stats of every Leet module, shown with "stat Leet" and captured by the profiler.
+ *
+ * Cycle counters cover the work done per request, per decode, per kill, per chat line, per LAN packet and per QoS ping tick.
+ * Dword counters are set each tick to the current depth of the Leet queues.
+ */
+DECLARE_STATS_GROUP(TEXT("Leet"), STATGROUP_Leet, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build request"), STAT_LeetBuildRequest, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("JSON decode"), STAT_LeetJsonDecode, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Record kill"), STAT_LeetRecordKill, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chat fan-out"), STAT_LeetChatFanOut, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LAN beacon"), STAT_LeetLanBeacon, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Completion dispatch"), STAT_LeetCompletionDispatch, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Transport tick"), STAT_LeetTransportTick, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("QoS ping"), STAT_LeetQosPing, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests in flight"), STAT_LeetRequestsInFlight, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests queued in transport"), STAT_LeetRequestsQueued, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("API tasks pending"), STAT_LeetApiTasksPending, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Completion queue depth"), STAT_LeetCompletionQueueDepth, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Chat relay queue depth"), STAT_LeetChatRelayQueueDepth, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active players"), STAT_LeetActivePlayers, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("QoS probes in flight"), STAT_LeetQosProbesInFlight, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Decode buffers"), STAT_LeetDecodeMemory, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Chat relay queue"), STAT_LeetChatRelayMemory, STATGROUP_Leet, LEETCLIENTPLUGIN_API);
@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LeetClientPluginPrivatePCH.h"
+#include "LeetTrace.h"
+
+FLeetTrace* FLeetTrace::Instance = nullptr;
+
+const TCHAR* FLeetTrace::JOIN_FLOW = TEXT("PlayerJoin");
+
+void FLeetTrace::Startup()
+{
+	check(IsInGameThread());
+	if (Instance == nullptr)
+	{
+		Instance = new FLeetTrace();
+	}
+}
+
+FLeetTrace& FLeetTrace::Get()
+{
+	// Traced from worker threads, so the recorder is never created here
+	check(Instance != nullptr);
+	return *Instance;
+}
+
+void FLeetTrace::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FLeetTrace::FLeetTrace()
+	: NextEvent(0)
+	, bWrapped(false)
+	, NumOverwritten(0)
+	, bEnabled(false)
+	, StartTime(0.0)
+{
+}
+
+void FLeetTrace::SetEnabled(bool bInEnabled, int32 InCapacity)
+{
+	FScopeLock Lock(&EventsLock);
+	if (bInEnabled)
+	{
+		Events.Reset();
+		Events.SetNum(FMath::Max(1, InCapacity));
+		NextEvent = 0;
+		bWrapped = false;
+		NumOverwritten = 0;
+		StartTime = FPlatformTime::Seconds();
+	}
+	bEnabled = bInEnabled;
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetTrace] SetEnabled %d, %d events"), bInEnabled, Events.Num());
+}
+
+void FLeetTrace::Begin(const TCHAR* Name, const FString& Arg)
+{
+	if (bEnabled)
+	{
+		AddEvent(Name, TEXT('B'), 0, Arg);
+	}
+}
+
+void FLeetTrace::End(const TCHAR* Name)
+{
+	if (bEnabled)
+	{
+		AddEvent(Name, TEXT('E'), 0, FString());
+	}
+}
+
+void FLeetTrace::AsyncBegin(const TCHAR* Name, uint64 Id, const FString& Arg)
+{
+	if (bEnabled)
+	{
+		AddEvent(Name, TEXT('b'), Id, Arg);
+	}
+}
+
+void FLeetTrace::AsyncEnd(const TCHAR* Name, uint64 Id)
+{
+	if (bEnabled)
+	{
+		AddEvent(Name, TEXT('e'), Id, FString());
+	}
+}
+
+void FLeetTrace::Flow(const TCHAR* Name, const FString& Key, TCHAR Phase)
+{
+	if (bEnabled)
+	{
+		AddEvent(Name, Phase, GetTypeHash(Key), Key);
+	}
+}
+
+void FLeetTrace::AddEvent(const TCHAR* Name, TCHAR Phase, uint64 Id, const FString& Arg)
+{
+	const double Now = FPlatformTime::Seconds();
+	const uint32 ThreadId = FPlatformTLS::GetCurrentThreadId();
+
+	FScopeLock Lock(&EventsLock);
+	if (!bEnabled)
+	{
+		return;
+	}
+	if (bWrapped)
+	{
+		NumOverwritten++;
+	}
+
+	FEvent& Event = Events[NextEvent];
+	Event.Name = Name;
+	Event.Phase = Phase;
+	Event.Timestamp = (Now - StartTime) * 1000000.0;
+	Event.ThreadId = ThreadId;
+	Event.Id = Id;
+	Event.Arg = Arg;
+
+	if (++NextEvent == Events.Num())
+	{
+		NextEvent = 0;
+		bWrapped = true;
+	}
+}
+
+int32 FLeetTrace::GetNumEvents() const
+{
+	FScopeLock Lock(&EventsLock);
+	return bWrapped ? Events.Num() : NextEvent;
+}
+
+void FLeetTrace::WriteChromeTrace(FString& Out) const
+{
+	FScopeLock Lock(&EventsLock);
+
+	const uint32 ProcessId = FPlatformProcess::GetCurrentProcessId();
+	const int32 NumEvents = bWrapped ? Events.Num() : NextEvent;
+	const int32 FirstEvent = bWrapped ? NextEvent : 0;
+
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Out);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("displayTimeUnit"), TEXT("ms"));
+	Writer->WriteArrayStart(TEXT("traceEvents"));
+	for (int32 EventIdx = 0; EventIdx < NumEvents; EventIdx++)
+	{
+		const FEvent& Event = Events[(FirstEvent + EventIdx) % Events.Num()];
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("name"), Event.Name);
+		Writer->WriteValue(TEXT("cat"), TEXT("leet"));
+		Writer->WriteValue(TEXT("ph"), FString::Chr(Event.Phase));
+		Writer->WriteValue(TEXT("ts"), Event.Timestamp);
+		Writer->WriteValue(TEXT("pid"), (int32)ProcessId);
+		Writer->WriteValue(TEXT("tid"), (int32)Event.ThreadId);
+		if (Event.Phase != TEXT('B') && Event.Phase != TEXT('E'))
+		{
+			Writer->WriteValue(TEXT("id"), FString::Printf(TEXT("0x%llx"), Event.Id));
+		}
+		if (Event.Phase == TEXT('f'))
+		{
+			// Bind to the enclosing slice rather than the next one to start
+			Writer->WriteValue(TEXT("bp"), TEXT("e"));
+		}
+		if (!Event.Arg.IsEmpty())
+		{
+			Writer->WriteObjectStart(TEXT("args"));
+			Writer->WriteValue(TEXT("key"), Event.Arg);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+}
+
+FString FLeetTrace::DumpToFile(const FString& Filename) const
+{
+	const FString TraceFilename = Filename.IsEmpty()
+		? FPaths::Combine(*FPaths::GameSavedDir(), TEXT("Leet"), *FString::Printf(TEXT("LeetTrace-%s.json"), *FDateTime::Now().ToString()))
+		: Filename;
+
+	FString Trace;
+	WriteChromeTrace(Trace);
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FLeetTrace] DumpToFile %s, %d events, %d overwritten"), *TraceFilename, GetNumEvents(), NumOverwritten);
+
+	AsyncTask(ENamedThreads::AnyThread, [TraceFilename, Trace]()
+	{
+		FFileHelper::SaveStringToFile(Trace, *TraceFilename);
+	});
+	return TraceFilename;
+}
@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Http.h"
+
+/**
+ * Records the lifecycle of Leet operations into a fixed size ring buffer and writes it out in the Chrome trace
+ * event format (chrome://tracing, Perfetto).
+ *
+ * Operations show up as begin/end slices on the thread that ran them, HTTP round trips as async slices keyed by
+ * request id, and the steps one player goes through while joining are tied together by a flow keyed by the
+ * player's platform id.  Capture is off by default, every call returns straight away until it is turned on.
+ * Safe to call from any thread.
+ */
+class LEETCLIENTPLUGIN_API FLeetTrace
+{
+public:
+
+	/** Default number of events kept, the oldest are overwritten once it is full */
+	static const int32 DEFAULT_CAPACITY = 65536;
+
+	/** Name of the flow joining the steps of a player's join */
+	static const TCHAR* JOIN_FLOW;
+
+	/** Creates the shared recorder.  Called on module startup, before any worker thread can trace */
+	static void Startup();
+
+	/** @return the recorder shared by every Leet module, safe to call from any thread between Startup and Shutdown */
+	static FLeetTrace& Get();
+
+	/** Destroys the shared recorder.  Called on module shutdown */
+	static void Shutdown();
+
+	/**
+	 * Turns capture on or off.  Turning it on clears the buffer
+	 *
+	 * @param bInEnabled whether to record events
+	 * @param InCapacity number of events kept
+	 */
+	void SetEnabled(bool bInEnabled, int32 InCapacity = DEFAULT_CAPACITY);
+
+	bool IsEnabled() const { return bEnabled; }
+
+	/** Opens a slice on the calling thread, Name must be a literal */
+	void Begin(const TCHAR* Name, const FString& Arg = FString());
+
+	/** Closes the slice last opened on the calling thread */
+	void End(const TCHAR* Name);
+
+	/** Opens an async slice, shown on its own track until the End with the same id */
+	void AsyncBegin(const TCHAR* Name, uint64 Id, const FString& Arg = FString());
+
+	/** Closes an async slice */
+	void AsyncEnd(const TCHAR* Name, uint64 Id);
+
+	/**
+	 * Adds a step to a flow, bound to the slice open on the calling thread
+	 *
+	 * @param Name flow name, every step of one flow uses the same
+	 * @param Key what the flow follows (a platform id), steps with the same key are linked
+	 * @param Phase 's' for the first step, 't' for the ones in between, 'f' for the last
+	 */
+	void Flow(const TCHAR* Name, const FString& Key, TCHAR Phase);
+
+	/** Writes the buffered events, oldest first, as a Chrome trace JSON object */
+	void WriteChromeTrace(FString& Out) const;
+
+	/**
+	 * Writes the buffered events to a file on a worker thread
+	 *
+	 * @param Filename file to write, empty picks a timestamped file in Saved/Leet
+	 * @return the file written to
+	 */
+	FString DumpToFile(const FString& Filename = FString()) const;
+
+	/** Number of events buffered, and dropped because the buffer was full */
+	int32 GetNumEvents() const;
+	int32 GetNumOverwritten() const { return NumOverwritten; }
+
+private:
+
+	/** One trace event */
+	struct FEvent
+	{
+		/** Literal, never freed */
+		const TCHAR* Name;
+		/** Chrome trace phase */
+		TCHAR Phase;
+		/** Microseconds since capture started */
+		double Timestamp;
+		uint32 ThreadId;
+		/** Async and flow id */
+		uint64 Id;
+		/** Shown in the event's args, player or URL */
+		FString Arg;
+	};
+
+	/** Hidden on purpose, use Get() */
+	FLeetTrace();
+
+	/** Stores an event, overwriting the oldest if the buffer is full */
+	void AddEvent(const TCHAR* Name, TCHAR Phase, uint64 Id, const FString& Arg);
+
+	/** Guards the buffer, events come from worker threads too */
+	mutable FCriticalSection EventsLock;
+
+	/** Ring buffer of events, NextEvent is the slot written next */
+	TArray<FEvent> Events;
+	int32 NextEvent;
+	bool bWrapped;
+	int32 NumOverwritten;
+
+	/** Capture on, read without the lock */
+	volatile bool bEnabled;
+
+	/** FPlatformTime::Seconds when capture started */
+	double StartTime;
+
+	/** The shared instance */
+	static FLeetTrace* Instance;
+};
+
+/** Opens a trace slice for the lifetime of the scope */
+class FLeetTraceScope
+{
+public:
+
+	FLeetTraceScope(const TCHAR* InName, const FString& Arg = FString())
+		: Name(FLeetTrace::Get().IsEnabled() ? InName : nullptr)
+	{
+		if (Name)
+		{
+			FLeetTrace::Get().Begin(Name, Arg);
+		}
+	}
+
+	/** Tags the slice with the request's URL, which is only built while capture is on */
+	FLeetTraceScope(const TCHAR* InName, const FHttpRequestPtr& Request)
+		: Name(FLeetTrace::Get().IsEnabled() ? InName : nullptr)
+	{
+		if (Name)
+		{
+			FLeetTrace::Get().Begin(Name, Request.IsValid() ? Request->GetURL() : FString());
+		}
+	}
+
+	~FLeetTraceScope()
+	{
+		if (Name)
+		{
+			FLeetTrace::Get().End(Name);
+		}
+	}
+
+private:
+
+	/** Null when capture was off at construction */
+	const TCHAR* Name;
+};
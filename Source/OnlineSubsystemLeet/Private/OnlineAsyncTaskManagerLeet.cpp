@@ -3,9 +3,164 @@
 #include "OnlineSubsystemLeetPrivatePCH.h"
 #include "OnlineAsyncTaskManagerLeet.h"
 #include "OnlineSubsystemLeet.h"
+#include "LeetHttpTransport.h"
+
+const int32 FOnlineAsyncTaskManagerLeet::DEFAULT_MAX_PARALLEL_HTTP_TASKS = 8;
+
+FOnlineAsyncTaskLeetHttp::FOnlineAsyncTaskLeetHttp(FOnlineSubsystemLeet* InSubsystem, FOnlineAsyncTaskManagerLeet* InManager, const TSharedRef<IHttpRequest>& InRequest, const FHttpRequestCompleteDelegate& InOnComplete, ELeetTaskPriority::Type InPriority)
+	: FOnlineAsyncTaskBasic(InSubsystem)
+	, Manager(InManager)
+	, Request(InRequest)
+	, OnComplete(InOnComplete)
+	, Priority(InPriority)
+	, State(MakeShareable(new FResponseState()))
+	, QueuedTime(FPlatformTime::Seconds())
+	, SentTime(QueuedTime)
+{
+}
+
+void FOnlineAsyncTaskLeetHttp::Send()
+{
+	SentTime = FPlatformTime::Seconds();
+
+	// Bound weakly, a task torn down with the subsystem just drops the late answer
+	if (!FLeetHttpTransport::Get().ProcessRequest(Request, FHttpRequestCompleteDelegate::CreateThreadSafeSP(State, &FResponseState::HandleRequestComplete)))
+	{
+		State->HandleRequestComplete(Request, nullptr, false);
+	}
+}
+
+FString FOnlineAsyncTaskLeetHttp::ToString() const
+{
+	return FString::Printf(TEXT("FOnlineAsyncTaskLeetHttp bWasSuccessful: %d Url: %s"), bWasSuccessful, *Request->GetURL());
+}
+
+void FOnlineAsyncTaskLeetHttp::Tick()
+{
+	if (State->Received.GetValue() != 0)
+	{
+		bIsComplete = true;
+		bWasSuccessful = State->bSucceeded;
+	}
+}
+
+void FOnlineAsyncTaskLeetHttp::Finalize()
+{
+	Manager->OnHttpTaskFinalized(this);
+	UE_LOG_ONLINE(Verbose, TEXT("%s queued %.1fms, out %.1fms"), *ToString(), GetQueuedSeconds() * 1000.0, GetSentSeconds() * 1000.0);
+}
+
+void FOnlineAsyncTaskLeetHttp::TriggerDelegates()
+{
+	OnComplete.ExecuteIfBound(Request, State->Response, State->bSucceeded);
+}
+
+FOnlineAsyncTaskManagerLeet::FOnlineAsyncTaskManagerLeet(class FOnlineSubsystemLeet* InOnlineSubsystem)
+	: LeetSubsystem(InOnlineSubsystem)
+	, NumHttpTasksInFlight(0)
+	, MaxParallelHttpTasks(DEFAULT_MAX_PARALLEL_HTTP_TASKS)
+	, NumHttpTasksCompleted(0)
+	, TotalHttpQueuedSeconds(0.0)
+{
+}
+
+FOnlineAsyncTaskManagerLeet::~FOnlineAsyncTaskManagerLeet()
+{
+	// The online thread is gone by now, whatever never made it to the out queue is dropped here
+	for (int32 PriorityIdx = 0; PriorityIdx < ELeetTaskPriority::Num; PriorityIdx++)
+	{
+		for (int32 TaskIdx = 0; TaskIdx < PendingHttpTasks[PriorityIdx].Num(); TaskIdx++)
+		{
+			delete PendingHttpTasks[PriorityIdx][TaskIdx];
+		}
+		PendingHttpTasks[PriorityIdx].Empty();
+	}
+
+	FScopeLock Lock(&SentHttpTasksLock);
+	for (int32 TaskIdx = 0; TaskIdx < SentHttpTasks.Num(); TaskIdx++)
+	{
+		delete SentHttpTasks[TaskIdx];
+	}
+	SentHttpTasks.Empty();
+}
+
+void FOnlineAsyncTaskManagerLeet::SetMaxParallelHttpTasks(int32 InMaxParallelHttpTasks)
+{
+	MaxParallelHttpTasks = FMath::Max(1, InMaxParallelHttpTasks);
+}
+
+bool FOnlineAsyncTaskManagerLeet::QueueHttpRequest(const TSharedRef<IHttpRequest>& Request, const FHttpRequestCompleteDelegate& OnComplete, ELeetTaskPriority::Type Priority)
+{
+	check(IsInGameThread());
+	PendingHttpTasks[Priority].Add(new FOnlineAsyncTaskLeetHttp(LeetSubsystem, this, Request, OnComplete, Priority));
+
+	// Don't wait for the next tick when there is room
+	StartPendingHttpTasks();
+	return true;
+}
+
+void FOnlineAsyncTaskManagerLeet::StartPendingHttpTasks()
+{
+	check(IsInGameThread());
+	for (int32 PriorityIdx = 0; PriorityIdx < ELeetTaskPriority::Num && NumHttpTasksInFlight < MaxParallelHttpTasks; PriorityIdx++)
+	{
+		TArray<FOnlineAsyncTaskLeetHttp*>& Pending = PendingHttpTasks[PriorityIdx];
+		int32 NumStarted = 0;
+		while (NumStarted < Pending.Num() && NumHttpTasksInFlight < MaxParallelHttpTasks)
+		{
+			FOnlineAsyncTaskLeetHttp* Task = Pending[NumStarted++];
+			NumHttpTasksInFlight++;
+			Task->Send();
+
+			FScopeLock Lock(&SentHttpTasksLock);
+			SentHttpTasks.Add(Task);
+		}
+		Pending.RemoveAt(0, NumStarted, false);
+	}
+	SET_DWORD_STAT(STAT_LeetApiTasksPending, GetNumPendingHttpTasks());
+}
+
+void FOnlineAsyncTaskManagerLeet::OnHttpTaskFinalized(FOnlineAsyncTaskLeetHttp* Task)
+{
+	check(IsInGameThread());
+	NumHttpTasksInFlight--;
+	NumHttpTasksCompleted++;
+	TotalHttpQueuedSeconds += Task->GetQueuedSeconds();
+}
+
+int32 FOnlineAsyncTaskManagerLeet::GetNumPendingHttpTasks() const
+{
+	int32 NumPending = 0;
+	for (int32 PriorityIdx = 0; PriorityIdx < ELeetTaskPriority::Num; PriorityIdx++)
+	{
+		NumPending += PendingHttpTasks[PriorityIdx].Num();
+	}
+	return NumPending;
+}
+
+void FOnlineAsyncTaskManagerLeet::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet API tasks: %d in flight (max %d), %d pending (%d high, %d normal, %d low), %d completed, %.1fms average wait"),
+		NumHttpTasksInFlight, MaxParallelHttpTasks, GetNumPendingHttpTasks(),
+		PendingHttpTasks[ELeetTaskPriority::High].Num(), PendingHttpTasks[ELeetTaskPriority::Normal].Num(), PendingHttpTasks[ELeetTaskPriority::Low].Num(),
+		NumHttpTasksCompleted, GetAverageHttpQueuedSeconds() * 1000.0);
+}
 
 void FOnlineAsyncTaskManagerLeet::OnlineTick()
 {
 	check(LeetSubsystem);
 	check(FPlatformTLS::GetCurrentThreadId() == OnlineThreadId || !FPlatformProcess::SupportsMultithreading());
+
+	// Everything that got its answer since the last pass moves to the out queue, GameTick finalizes them in one go
+	FScopeLock Lock(&SentHttpTasksLock);
+	for (int32 TaskIdx = SentHttpTasks.Num() - 1; TaskIdx >= 0; TaskIdx--)
+	{
+		FOnlineAsyncTaskLeetHttp* Task = SentHttpTasks[TaskIdx];
+		Task->Tick();
+		if (Task->IsDone())
+		{
+			SentHttpTasks.RemoveAtSwap(TaskIdx, 1, false);
+			AddToOutQueue(Task);
+		}
+	}
 }
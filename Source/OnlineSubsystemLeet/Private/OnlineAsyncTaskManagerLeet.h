@@ -3,28 +3,134 @@
 #pragma once
 
 #include "OnlineAsyncTaskManager.h"
+#include "LeetAsyncScheduler.h"
+
+class FOnlineAsyncTaskManagerLeet;
+
+/**
+ *	Async task for a single Leet API call
+ *
+ *	The request is sent and answered on the game thread, the online thread notices the answer in Tick and the task
+ *	is finalized together with everything else that completed since the last game tick.
+ */
+class FOnlineAsyncTaskLeetHttp : public FOnlineAsyncTaskBasic<FOnlineSubsystemLeet>
+{
+private:
+
+	/** What the transport writes to, outlives the task if the request is still out when the task is destroyed */
+	struct FResponseState
+	{
+		FHttpResponsePtr Response;
+		bool bSucceeded;
+		/** Set once Response is filled in, read by the online thread */
+		FThreadSafeCounter Received;
+
+		FResponseState()
+			: bSucceeded(false)
+		{
+		}
+
+		void HandleRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bInSucceeded)
+		{
+			Response = HttpResponse;
+			bSucceeded = bInSucceeded;
+			Received.Set(1);
+		}
+	};
+
+	FOnlineAsyncTaskManagerLeet* Manager;
+	TSharedRef<IHttpRequest> Request;
+	FHttpRequestCompleteDelegate OnComplete;
+	ELeetTaskPriority::Type Priority;
+	TSharedRef<FResponseState, ESPMode::ThreadSafe> State;
+
+	/** When the task was queued and when it was sent, in seconds */
+	double QueuedTime;
+	double SentTime;
+
+public:
+
+	FOnlineAsyncTaskLeetHttp(FOnlineSubsystemLeet* InSubsystem, FOnlineAsyncTaskManagerLeet* InManager, const TSharedRef<IHttpRequest>& InRequest, const FHttpRequestCompleteDelegate& InOnComplete, ELeetTaskPriority::Type InPriority);
+
+	/** Hands the request to the transport, game thread only.  A request the transport refuses completes right away */
+	void Send();
+
+	ELeetTaskPriority::Type GetPriority() const { return Priority; }
+
+	/** @return seconds spent waiting for a free slot, valid once sent */
+	double GetQueuedSeconds() const { return SentTime - QueuedTime; }
+
+	/** @return seconds since the request was sent */
+	double GetSentSeconds() const { return FPlatformTime::Seconds() - SentTime; }
+
+	// FOnlineAsyncTask
+	virtual FString ToString() const override;
+	virtual void Tick() override;
+	virtual void Finalize() override;
+	virtual void TriggerDelegates() override;
+};
 
 /**
  *	Leet version of the async task manager to register the various Leet callbacks with the engine
+ *
+ *	Also schedules the Leet API calls: at most MaxParallelHttpTasks are out at once, the rest wait by priority.
  */
-class FOnlineAsyncTaskManagerLeet : public FOnlineAsyncTaskManager
+class FOnlineAsyncTaskManagerLeet : public FOnlineAsyncTaskManager, public ILeetAsyncScheduler
 {
 protected:
 
 	/** Cached reference to the main online subsystem */
 	class FOnlineSubsystemLeet* LeetSubsystem;
 
+	/** Calls waiting for a free slot, one FIFO per priority.  Game thread only */
+	TArray<FOnlineAsyncTaskLeetHttp*> PendingHttpTasks[ELeetTaskPriority::Num];
+
+	/** Calls that were sent and are polled by the online thread */
+	TArray<FOnlineAsyncTaskLeetHttp*> SentHttpTasks;
+	FCriticalSection SentHttpTasksLock;
+
+	/** Calls sent and not finalized yet.  Game thread only */
+	int32 NumHttpTasksInFlight;
+
+	/** How many calls may be out at once */
+	int32 MaxParallelHttpTasks;
+
+	/** Totals since startup.  Game thread only */
+	int32 NumHttpTasksCompleted;
+	double TotalHttpQueuedSeconds;
+
 public:
 
-	FOnlineAsyncTaskManagerLeet(class FOnlineSubsystemLeet* InOnlineSubsystem)
-		: LeetSubsystem(InOnlineSubsystem)
-	{
-	}
+	static const int32 DEFAULT_MAX_PARALLEL_HTTP_TASKS;
 
-	~FOnlineAsyncTaskManagerLeet()
-	{
-	}
+	FOnlineAsyncTaskManagerLeet(class FOnlineSubsystemLeet* InOnlineSubsystem);
+	~FOnlineAsyncTaskManagerLeet();
+
+	/** Changes how many calls may be out at once, takes effect on the next game tick */
+	void SetMaxParallelHttpTasks(int32 InMaxParallelHttpTasks);
+
+	/** Sends queued calls while slots are free.  Game thread, called every tick after GameTick */
+	void StartPendingHttpTasks();
+
+	/** Releases the slot of a finished call.  Game thread, from the task's Finalize */
+	void OnHttpTaskFinalized(FOnlineAsyncTaskLeetHttp* Task);
+
+	int32 GetNumPendingHttpTasks() const;
+	int32 GetNumHttpTasksInFlight() const { return NumHttpTasksInFlight; }
+	int32 GetNumHttpTasksCompleted() const { return NumHttpTasksCompleted; }
+
+	/** @return average time calls waited for a slot, in seconds */
+	double GetAverageHttpQueuedSeconds() const { return NumHttpTasksCompleted > 0 ? TotalHttpQueuedSeconds / NumHttpTasksCompleted : 0.0; }
+
+	/** Writes the scheduling counters to the given output device.  Game thread */
+	void Dump(FOutputDevice& Ar) const;
 
 	// FOnlineAsyncTaskManager
 	virtual void OnlineTick() override;
+
+protected:
+
+	// ILeetAsyncScheduler
+	virtual bool QueueHttpRequest(const TSharedRef<IHttpRequest>& Request, const FHttpRequestCompleteDelegate& OnComplete, ELeetTaskPriority::Type Priority) override;
+	virtual int32 GetNumUnfinishedHttpRequests() const override { return GetNumPendingHttpTasks() + NumHttpTasksInFlight; }
 };
@@ -4,6 +4,8 @@
 #include "OnlineIdentityLeet.h"
 #include "IPAddress.h"
 #include "SocketSubsystem.h"
+#include "LeetHttpTransport.h"
+#include "LeetAsyncScheduler.h"
 
 bool FUserOnlineAccountLeet::GetAuthAttribute(const FString& AttrName, FString& OutAttrValue) const
 {
@@ -112,16 +114,13 @@ void FOnlineIdentityLeet::TickLogin(float DeltaTime)
 						AccessToken = AccessTokenOnly;
 					}
 					// kick off http request to get user info with the new token
-					TSharedRef<class IHttpRequest> HttpRequest = FHttpModule::Get().CreateRequest();
-					LoginUserRequests.Add(&HttpRequest.Get(), FPendingLoginUser(LocalUserNumPendingLogin, AccessToken));
-
 					FString MeUrl = TEXT("https://leetsandbox.appspot.com/me?access_token=`token");
 
-					HttpRequest->OnProcessRequestComplete().BindRaw(this, &FOnlineIdentityLeet::MeUser_HttpRequestComplete);
-					HttpRequest->SetURL(MeUrl.Replace(TEXT("`token"), *AccessToken, ESearchCase::IgnoreCase));
+					TSharedRef<class IHttpRequest> HttpRequest = FLeetHttpTransport::Get().CreateRequest(TEXT("GET"), MeUrl.Replace(TEXT("`token"), *AccessToken, ESearchCase::IgnoreCase));
+					LoginUserRequests.Add(&HttpRequest.Get(), FPendingLoginUser(LocalUserNumPendingLogin, AccessToken));
+
 					HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-					HttpRequest->SetVerb(TEXT("GET"));
-					HttpRequest->ProcessRequest();
+					ILeetAsyncScheduler::Schedule(HttpRequest, FHttpRequestCompleteDelegate::CreateRaw(this, &FOnlineIdentityLeet::MeUser_HttpRequestComplete));
 				}
 				else
 				{
@@ -0,0 +1,363 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#include "OnlineSubsystemLeetPrivatePCH.h"
+#include "OnlineQosPingerLeet.h"
+#include "OnlineSessionSettings.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "NboSerializerLeet.h"
+
+namespace
+{
+	/** First field of every probe, "LQOS" */
+	const uint32 QOS_PROBE_MAGIC = 0x4C514F53;
+
+	/** Magic, sequence number and nonce */
+	const int32 QOS_PROBE_SIZE = sizeof(uint32) + sizeof(uint32) + sizeof(uint64);
+
+	/** Longest the responder blocks on its socket before checking whether it should stop */
+	const FTimespan QOS_RESPONDER_WAIT = FTimespan::FromMilliseconds(100);
+}
+
+FOnlineQosPingerLeet::FTarget::FTarget(const FString& InKey, const TSharedRef<FInternetAddr>& InAddr)
+	: Key(InKey)
+	, Addr(InAddr)
+	, NumSent(0)
+	, BestPingMs(MAX_QUERY_PING)
+	, bInFlight(false)
+	, bDone(false)
+{
+}
+
+FOnlineQosPingerLeet::FOnlineQosPingerLeet()
+	: NumRemaining(0)
+	, NextTargetIdx(0)
+	, NextSequence(0)
+	, Nonce(0)
+	, NumProbesSent(0)
+	, NumReplies(0)
+	, NumLost(0)
+{
+}
+
+FOnlineQosPingerLeet::~FOnlineQosPingerLeet()
+{
+	CloseSockets();
+}
+
+void FOnlineQosPingerLeet::AddTarget(const FString& Key, const FInternetAddr& HostAddr, int32 QosPort)
+{
+	for (int32 TargetIdx = 0; TargetIdx < Targets.Num(); TargetIdx++)
+	{
+		if (Targets[TargetIdx].Key == Key && !Targets[TargetIdx].bDone)
+		{
+			return;
+		}
+	}
+
+	uint32 HostIp = 0;
+	HostAddr.GetIp(HostIp);
+	const int32 Port = QosPort > 0 ? QosPort : HostAddr.GetPort() + Settings.PortOffset;
+	Targets.Add(FTarget(Key, ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr(HostIp, Port)));
+	NumRemaining++;
+}
+
+void FOnlineQosPingerLeet::Cancel()
+{
+	Targets.Empty();
+	Probes.Empty();
+	PendingResults.Empty();
+	NumRemaining = 0;
+	NextTargetIdx = 0;
+	CloseSockets();
+	SET_DWORD_STAT(STAT_LeetQosProbesInFlight, 0);
+}
+
+void FOnlineQosPingerLeet::Tick()
+{
+	if (NumRemaining == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_LeetQosPing);
+	if (Sockets.Num() == 0 && !OpenSockets())
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FOnlineQosPingerLeet] Could not open a socket, %d servers left unpinged"), NumRemaining);
+		Cancel();
+		OnPingComplete.ExecuteIfBound();
+		return;
+	}
+
+	// Replies first, so their time is taken as early in the frame as possible
+	const double Now = FPlatformTime::Seconds();
+	ReceiveReplies(Now);
+	ExpireProbes(Now);
+	SendProbes(Now);
+
+	SET_DWORD_STAT(STAT_LeetQosProbesInFlight, Probes.Num());
+
+	const bool bFinished = NumRemaining == 0;
+	if (bFinished)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] [FOnlineQosPingerLeet] %d servers pinged"), Targets.Num());
+		Targets.Empty();
+		NextTargetIdx = 0;
+		CloseSockets();
+	}
+
+	// Reported last, the handlers may queue more servers
+	TArray<FResult> Results;
+	Exchange(Results, PendingResults);
+	for (int32 ResultIdx = 0; ResultIdx < Results.Num(); ResultIdx++)
+	{
+		OnPingResult.ExecuteIfBound(Results[ResultIdx].Key, Results[ResultIdx].PingMs);
+	}
+	if (bFinished)
+	{
+		OnPingComplete.ExecuteIfBound();
+	}
+}
+
+bool FOnlineQosPingerLeet::OpenSockets()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	FromAddr = SocketSubsystem->CreateInternetAddr();
+	Nonce = (uint64(FMath::Rand()) << 32) ^ uint64(FMath::Rand()) ^ uint64(FPlatformTime::Cycles());
+
+	const int32 NumSockets = FMath::Clamp(FMath::Min(Settings.MaxSockets, NumRemaining), 1, FMath::Max(Settings.MaxSockets, 1));
+	for (int32 SocketIdx = 0; SocketIdx < NumSockets; SocketIdx++)
+	{
+		FSocket* Socket = FUdpSocketBuilder(TEXT("LeetQosPing")).AsNonBlocking().Build();
+		if (Socket)
+		{
+			Sockets.Add(Socket);
+		}
+	}
+	return Sockets.Num() > 0;
+}
+
+void FOnlineQosPingerLeet::CloseSockets()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	for (int32 SocketIdx = 0; SocketIdx < Sockets.Num(); SocketIdx++)
+	{
+		Sockets[SocketIdx]->Close();
+		SocketSubsystem->DestroySocket(Sockets[SocketIdx]);
+	}
+	Sockets.Empty();
+}
+
+void FOnlineQosPingerLeet::SendProbes(double Now)
+{
+	const int32 MaxProbesInFlight = FMath::Max(Settings.MaxProbesInFlight, 1);
+	for (int32 NumVisited = 0; NumVisited < Targets.Num() && Probes.Num() < MaxProbesInFlight; NumVisited++)
+	{
+		const int32 TargetIdx = NextTargetIdx;
+		NextTargetIdx = (NextTargetIdx + 1) % Targets.Num();
+
+		FTarget& Target = Targets[TargetIdx];
+		if (Target.bDone || Target.bInFlight)
+		{
+			continue;
+		}
+
+		const uint32 Sequence = NextSequence++;
+		FNboSerializeToBufferLeet Packet(QOS_PROBE_SIZE);
+		Packet << QOS_PROBE_MAGIC << Sequence << Nonce;
+
+		FSocket* Socket = Sockets[Sequence % Sockets.Num()];
+		int32 BytesSent = 0;
+		Target.NumSent++;
+		if (Socket->SendTo(Packet.GetRawBuffer(0), Packet.GetByteCount(), BytesSent, *Target.Addr))
+		{
+			FProbe& Probe = Probes.Add(Sequence);
+			Probe.TargetIdx = TargetIdx;
+			Probe.SendTime = Now;
+			Target.bInFlight = true;
+			NumProbesSent++;
+		}
+		else
+		{
+			NumLost++;
+			FinishTargetIfDone(Target);
+		}
+	}
+}
+
+void FOnlineQosPingerLeet::ReceiveReplies(double Now)
+{
+	// Room for a bigger datagram, so one that is truncated to the probe size is not mistaken for a reply
+	uint8 Buffer[QOS_PROBE_SIZE * 2];
+	for (int32 SocketIdx = 0; SocketIdx < Sockets.Num(); SocketIdx++)
+	{
+		int32 BytesRead = 0;
+		while (Sockets[SocketIdx]->RecvFrom(Buffer, sizeof(Buffer), BytesRead, *FromAddr) && BytesRead > 0)
+		{
+			if (BytesRead != QOS_PROBE_SIZE)
+			{
+				continue;
+			}
+
+			FNboSerializeFromBufferLeet Packet(Buffer, BytesRead);
+			uint32 Magic = 0;
+			uint32 Sequence = 0;
+			uint64 ReplyNonce = 0;
+			Packet >> Magic >> Sequence >> ReplyNonce;
+
+			// Replies to probes that already timed out are dropped here too
+			const FProbe* Probe = Probes.Find(Sequence);
+			if (Magic != QOS_PROBE_MAGIC || ReplyNonce != Nonce || Probe == nullptr)
+			{
+				continue;
+			}
+
+			FTarget& Target = Targets[Probe->TargetIdx];
+			const int32 PingMs = FMath::Max(FMath::RoundToInt((Now - Probe->SendTime) * 1000.0), 1);
+			Probes.Remove(Sequence);
+			Target.bInFlight = false;
+			NumReplies++;
+
+			if (PingMs < Target.BestPingMs)
+			{
+				Target.BestPingMs = PingMs;
+				FResult& Result = *new (PendingResults) FResult();
+				Result.Key = Target.Key;
+				Result.PingMs = PingMs;
+			}
+			FinishTargetIfDone(Target);
+		}
+	}
+}
+
+void FOnlineQosPingerLeet::ExpireProbes(double Now)
+{
+	for (TMap<uint32, FProbe>::TIterator It(Probes); It; ++It)
+	{
+		if (Now - It->Value.SendTime >= Settings.Timeout)
+		{
+			FTarget& Target = Targets[It->Value.TargetIdx];
+			Target.bInFlight = false;
+			NumLost++;
+			It.RemoveCurrent();
+			FinishTargetIfDone(Target);
+		}
+	}
+}
+
+void FOnlineQosPingerLeet::FinishTargetIfDone(FTarget& Target)
+{
+	if (Target.bDone || Target.bInFlight || Target.NumSent < Settings.ProbesPerServer)
+	{
+		return;
+	}
+
+	Target.bDone = true;
+	NumRemaining--;
+
+	// Nothing came back, tell the caller the server is unreachable rather than leave it unknown
+	if (Target.BestPingMs == MAX_QUERY_PING)
+	{
+		FResult& Result = *new (PendingResults) FResult();
+		Result.Key = Target.Key;
+		Result.PingMs = MAX_QUERY_PING;
+	}
+}
+
+void FOnlineQosPingerLeet::Dump(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Leet QoS pinger: %d servers left, %d probes in flight on %d sockets, %u sent, %u answered, %u lost"),
+		NumRemaining, Probes.Num(), Sockets.Num(), NumProbesSent, NumReplies, NumLost);
+}
+
+FOnlineQosResponderLeet::FOnlineQosResponderLeet()
+	: Socket(nullptr)
+	, Thread(nullptr)
+	, Port(0)
+	, bStopping(false)
+{
+}
+
+FOnlineQosResponderLeet::~FOnlineQosResponderLeet()
+{
+	Shutdown();
+}
+
+bool FOnlineQosResponderLeet::Start(int32 InPort)
+{
+	Shutdown();
+
+	Socket = FUdpSocketBuilder(TEXT("LeetQosResponder")).AsNonBlocking().AsReusable().BoundToPort(InPort).Build();
+	if (Socket == nullptr)
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FOnlineQosResponderLeet] Could not bind port %d"), InPort);
+		return false;
+	}
+
+	Port = InPort;
+	bStopping = false;
+	Thread = FRunnableThread::Create(this, TEXT("LeetQosResponder"), 16 * 1024, TPri_AboveNormal);
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FOnlineQosResponderLeet] Answering QoS probes on port %d"), Port);
+	return true;
+}
+
+void FOnlineQosResponderLeet::Shutdown()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+uint32 FOnlineQosResponderLeet::Run()
+{
+	TSharedRef<FInternetAddr> FromAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	uint8 Buffer[QOS_PROBE_SIZE * 2];
+
+	while (!bStopping)
+	{
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, QOS_RESPONDER_WAIT))
+		{
+			continue;
+		}
+
+		int32 BytesRead = 0;
+		while (Socket->RecvFrom(Buffer, sizeof(Buffer), BytesRead, *FromAddr) && BytesRead > 0)
+		{
+			// Anything but a probe is ignored, and replies are never bigger than what came in
+			FNboSerializeFromBufferLeet Packet(Buffer, BytesRead);
+			uint32 Magic = 0;
+			Packet >> Magic;
+			if (BytesRead != QOS_PROBE_SIZE || Magic != QOS_PROBE_MAGIC)
+			{
+				continue;
+			}
+
+			int32 BytesSent = 0;
+			Socket->SendTo(Buffer, BytesRead, BytesSent, *FromAddr);
+			NumAnswered.Increment();
+		}
+	}
+	return 0;
+}
+
+void FOnlineQosResponderLeet::Dump(FOutputDevice& Ar) const
+{
+	if (IsRunning())
+	{
+		Ar.Logf(TEXT("Leet QoS responder: port %d, %d probes answered"), Port, NumAnswered.GetValue());
+	}
+	else
+	{
+		Ar.Logf(TEXT("Leet QoS responder: off"));
+	}
+}
@@ -0,0 +1,183 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "IPAddress.h"
+#include "HAL/Runnable.h"
+
+class FSocket;
+
+/** How servers are probed, read from LeetConfig.ini */
+struct FOnlineQosSettingsLeet
+{
+	/** QoS port of a server relative to its game port, used when the server list has no qos_port */
+	int32 PortOffset;
+	/** Sockets the pinger sends from, probes are spread over them */
+	int32 MaxSockets;
+	/** Probes outstanding at once over all servers */
+	int32 MaxProbesInFlight;
+	/** Probes sent to each server, the fastest reply is its ping */
+	int32 ProbesPerServer;
+	/** Time after which a probe counts as lost, in seconds */
+	float Timeout;
+
+	FOnlineQosSettingsLeet()
+		: PortOffset(100)
+		, MaxSockets(4)
+		, MaxProbesInFlight(64)
+		, ProbesPerServer(3)
+		, Timeout(1.0f)
+	{
+	}
+};
+
+/** Called each time the ping of a server improves, and with MAX_QUERY_PING once a server never answered */
+DECLARE_DELEGATE_TwoParams(FOnQosPingResultLeet, const FString& /*Key*/, int32 /*PingInMs*/);
+
+/** Called once every queued server has been probed */
+DECLARE_DELEGATE(FOnQosPingCompleteLeet);
+
+/**
+ * Measures round trip times to game servers with small UDP probes.
+ *
+ * Every queued server gets ProbesPerServer probes, one at a time, and the fastest reply is its ping.  Servers are
+ * probed concurrently up to MaxProbesInFlight, from at most MaxSockets sockets that are opened on demand and closed
+ * once everything is answered or timed out.  Results are reported as replies arrive, from Tick on the game thread,
+ * so a ping includes up to one frame of tick granularity.  Probes are answered by FOnlineQosResponderLeet.
+ */
+class FOnlineQosPingerLeet
+{
+public:
+
+	FOnlineQosPingerLeet();
+	~FOnlineQosPingerLeet();
+
+	void SetSettings(const FOnlineQosSettingsLeet& InSettings) { Settings = InSettings; }
+	const FOnlineQosSettingsLeet& GetSettings() const { return Settings; }
+
+	/**
+	 * Queues a server for probing, a server already queued is not probed twice
+	 *
+	 * @param Key identifies the server in the results
+	 * @param HostAddr game address of the server
+	 * @param QosPort port the server answers probes on, 0 for the game port plus PortOffset
+	 */
+	void AddTarget(const FString& Key, const FInternetAddr& HostAddr, int32 QosPort = 0);
+
+	/** Drops every queued server without reporting it */
+	void Cancel();
+
+	/** @return true while servers are left to probe */
+	bool IsBusy() const { return NumRemaining > 0; }
+
+	/** Sends due probes, reads replies and expires lost probes */
+	void Tick();
+
+	/** Writes the probe counters to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+	FOnQosPingResultLeet OnPingResult;
+	FOnQosPingCompleteLeet OnPingComplete;
+
+private:
+
+	struct FTarget
+	{
+		FString Key;
+		TSharedRef<FInternetAddr> Addr;
+		/** Probes sent so far */
+		int32 NumSent;
+		/** Fastest reply so far, MAX_QUERY_PING until one arrives */
+		int32 BestPingMs;
+		bool bInFlight;
+		bool bDone;
+
+		FTarget(const FString& InKey, const TSharedRef<FInternetAddr>& InAddr);
+	};
+
+	struct FResult
+	{
+		FString Key;
+		int32 PingMs;
+	};
+
+	struct FProbe
+	{
+		int32 TargetIdx;
+		/** In FPlatformTime::Seconds */
+		double SendTime;
+	};
+
+	bool OpenSockets();
+	void CloseSockets();
+	void SendProbes(double Now);
+	void ReceiveReplies(double Now);
+	void ExpireProbes(double Now);
+
+	/** Marks a target done once its last probe was answered or lost */
+	void FinishTargetIfDone(FTarget& Target);
+
+	FOnlineQosSettingsLeet Settings;
+
+	TArray<FTarget> Targets;
+	int32 NumRemaining;
+	/** Target the next round of sends starts at, so every server gets its turn */
+	int32 NextTargetIdx;
+
+	/** Outstanding probes by sequence number */
+	TMap<uint32, FProbe> Probes;
+	uint32 NextSequence;
+	/** Random per pinger, replies to someone else's probes are ignored */
+	uint64 Nonce;
+
+	TArray<FSocket*> Sockets;
+	TSharedPtr<FInternetAddr> FromAddr;
+
+	/** Results of this tick, reported once the tick is done with the targets */
+	TArray<FResult> PendingResults;
+
+	uint32 NumProbesSent;
+	uint32 NumReplies;
+	uint32 NumLost;
+};
+
+/**
+ * Answers the probes of FOnlineQosPingerLeet on a dedicated server.
+ *
+ * Runs on its own thread blocked on the socket, so the reply does not wait for the server tick.  Only well formed
+ * probes are echoed, back to the sender and at their own size.
+ */
+class FOnlineQosResponderLeet : public FRunnable
+{
+public:
+
+	FOnlineQosResponderLeet();
+	virtual ~FOnlineQosResponderLeet();
+
+	/** Binds the port and starts answering, @return false if the port could not be bound */
+	bool Start(int32 InPort);
+
+	/** Stops answering and closes the socket */
+	void Shutdown();
+
+	bool IsRunning() const { return Socket != nullptr; }
+
+	/** Writes the port and reply count to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+	// FRunnable
+
+	virtual uint32 Run() override;
+	virtual void Stop() override { bStopping = true; }
+
+private:
+
+	FSocket* Socket;
+	FRunnableThread* Thread;
+	int32 Port;
+
+	/** Set to end the responder thread */
+	volatile bool bStopping;
+
+	FThreadSafeCounter NumAnswered;
+};
@@ -0,0 +1,224 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#include "OnlineSubsystemLeetPrivatePCH.h"
+#include "OnlineServerListCacheLeet.h"
+#include "OnlineSessionInterfaceLeet.h"
+
+namespace
+{
+	/** Bumped whenever the layout of the cache file changes, older files are ignored */
+	const int32 SERVER_LIST_CACHE_VERSION = 3;
+}
+
+FOnlineServerListCacheLeet::FOnlineServerListCacheLeet()
+	: bCachedSinglePage(false)
+	, FetchTime(0)
+	, NumFreshHits(0)
+	, NumStaleHits(0)
+	, NumMisses(0)
+	, NumNotModified(0)
+	, NumDownloaded(0)
+{
+}
+
+void FOnlineServerListCacheLeet::SetSettings(const FOnlineServerListCacheSettingsLeet& InSettings)
+{
+	Settings = InSettings;
+	if (Settings.bPersist && CachedUrl.IsEmpty())
+	{
+		Load();
+	}
+}
+
+EServerListCacheLookupLeet::Type FOnlineServerListCacheLeet::Lookup(const FString& Url)
+{
+	if (ServerList.IsValid() && CachedUrl == Url)
+	{
+		const double Age = GetAge();
+		if (Age <= Settings.TimeToLive)
+		{
+			NumFreshHits++;
+			return EServerListCacheLookupLeet::Fresh;
+		}
+		if (Age <= Settings.TimeToLive + Settings.MaxStale)
+		{
+			NumStaleHits++;
+			return EServerListCacheLookupLeet::Stale;
+		}
+	}
+
+	NumMisses++;
+	return EServerListCacheLookupLeet::Miss;
+}
+
+void FOnlineServerListCacheLeet::AddConditionalHeaders(const FString& Url, IHttpRequest& Request) const
+{
+	// A 304 renews the cached list, so only ask for one when there is a decoded list to renew and the answer to
+	// this one request covers all of it
+	if (!ServerList.IsValid() || CachedUrl != Url || !bCachedSinglePage)
+	{
+		return;
+	}
+
+	if (!CachedETag.IsEmpty())
+	{
+		Request.SetHeader(TEXT("If-None-Match"), CachedETag);
+	}
+	if (!CachedLastModified.IsEmpty())
+	{
+		Request.SetHeader(TEXT("If-Modified-Since"), CachedLastModified);
+	}
+}
+
+void FOnlineServerListCacheLeet::Store(const FString& Url, const FString& ETag, const FString& LastModified, const FLeetServerListResult& InServerList, bool bSinglePage)
+{
+	if (!InServerList.bParsed)
+	{
+		return;
+	}
+
+	NumDownloaded++;
+	CachedUrl = Url;
+	CachedETag = ETag;
+	CachedLastModified = LastModified;
+	bCachedSinglePage = bSinglePage;
+	FetchTime = FDateTime::UtcNow();
+	ServerList = MakeShareable(new FLeetServerListResult(InServerList));
+
+	if (Settings.bPersist)
+	{
+		Save();
+	}
+}
+
+void FOnlineServerListCacheLeet::Revalidate(const FString& Url, const FHttpResponsePtr& HttpResponse)
+{
+	if (CachedUrl != Url)
+	{
+		return;
+	}
+
+	NumNotModified++;
+	FetchTime = FDateTime::UtcNow();
+
+	// A 304 may carry newer validators for the same list
+	const FString ETag = HttpResponse->GetHeader(TEXT("ETag"));
+	if (!ETag.IsEmpty())
+	{
+		CachedETag = ETag;
+	}
+	const FString LastModified = HttpResponse->GetHeader(TEXT("Last-Modified"));
+	if (!LastModified.IsEmpty())
+	{
+		CachedLastModified = LastModified;
+	}
+
+	if (Settings.bPersist)
+	{
+		Save();
+	}
+}
+
+void FOnlineServerListCacheLeet::Invalidate()
+{
+	CachedUrl.Empty();
+	CachedETag.Empty();
+	CachedLastModified.Empty();
+	bCachedSinglePage = false;
+	ServerList.Reset();
+	IFileManager::Get().Delete(*GetCacheFilename(), false, false, true);
+}
+
+void FOnlineServerListCacheLeet::Load()
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetCacheFilename(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(FileData);
+	int32 Version = 0;
+	Reader << Version;
+	if (Version != SERVER_LIST_CACHE_VERSION)
+	{
+		UE_LOG(LogLeet, Log, TEXT("[LEET] [FOnlineServerListCacheLeet] Ignoring server list cache of version %d"), Version);
+		return;
+	}
+
+	FString Url;
+	FString ETag;
+	FString LastModified;
+	bool bSinglePage = false;
+	int64 FetchTicks = 0;
+	TSharedRef<FLeetServerListResult, ESPMode::ThreadSafe> LoadedList = MakeShareable(new FLeetServerListResult());
+	Reader << Url << ETag << LastModified << bSinglePage << FetchTicks << LoadedList->Servers;
+	if (Reader.IsError() || Url.IsEmpty())
+	{
+		return;
+	}
+
+	UE_LOG(LogLeet, Log, TEXT("[LEET] [FOnlineServerListCacheLeet] Loaded %d servers of %s"), LoadedList->Servers.Num(), *Url);
+
+	LoadedList->bParsed = true;
+	CachedUrl = Url;
+	CachedETag = ETag;
+	CachedLastModified = LastModified;
+	bCachedSinglePage = bSinglePage;
+	FetchTime = FDateTime(FetchTicks);
+	ServerList = LoadedList;
+}
+
+void FOnlineServerListCacheLeet::Save() const
+{
+	if (!ServerList.IsValid())
+	{
+		return;
+	}
+
+	FString Url = CachedUrl;
+	FString ETag = CachedETag;
+	FString LastModified = CachedLastModified;
+	bool bSinglePage = bCachedSinglePage;
+	int64 FetchTicks = FetchTime.GetTicks();
+	TArray<FLeetServerEntry> Servers = ServerList->Servers;
+	int32 Version = SERVER_LIST_CACHE_VERSION;
+
+	// The decoded list is kept rather than the bodies, a paged list has one per page
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	Writer << Version << Url << ETag << LastModified << bSinglePage << FetchTicks << Servers;
+
+	const FString Filename = GetCacheFilename();
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+	if (!FFileHelper::SaveArrayToFile(FileData, *Filename))
+	{
+		UE_LOG(LogLeet, Warning, TEXT("[LEET] [FOnlineServerListCacheLeet] Could not write %s"), *Filename);
+	}
+}
+
+FString FOnlineServerListCacheLeet::GetCacheFilename()
+{
+	return FPaths::GameSavedDir() / TEXT("Leet") / TEXT("ServerListCache.bin");
+}
+
+double FOnlineServerListCacheLeet::GetAge() const
+{
+	return (FDateTime::UtcNow() - FetchTime).GetTotalSeconds();
+}
+
+void FOnlineServerListCacheLeet::Dump(FOutputDevice& Ar) const
+{
+	if (ServerList.IsValid())
+	{
+		Ar.Logf(TEXT("Leet server list cache: %d servers from %s%s, %.0fs old, ttl %.0fs, max stale %.0fs, etag %s, last modified %s"),
+			ServerList->Servers.Num(), *CachedUrl, bCachedSinglePage ? TEXT("") : TEXT(" (paged, not revalidated)"), GetAge(), Settings.TimeToLive, Settings.MaxStale,
+			CachedETag.IsEmpty() ? TEXT("none") : *CachedETag, CachedLastModified.IsEmpty() ? TEXT("none") : *CachedLastModified);
+	}
+	else
+	{
+		Ar.Logf(TEXT("Leet server list cache: empty, ttl %.0fs, max stale %.0fs"), Settings.TimeToLive, Settings.MaxStale);
+	}
+	Ar.Logf(TEXT("  %u fresh hits, %u stale hits, %u misses, %u not modified, %u downloaded%s"),
+		NumFreshHits, NumStaleHits, NumMisses, NumNotModified, NumDownloaded, Settings.bPersist ? TEXT(", persisted") : TEXT(""));
+}
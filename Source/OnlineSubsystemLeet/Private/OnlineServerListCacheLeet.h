@@ -0,0 +1,122 @@
+// Copyright 1998-2015 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Http.h"
+
+struct FLeetServerListResult;
+
+/** How long server lists are kept, read from LeetConfig.ini */
+struct FOnlineServerListCacheSettingsLeet
+{
+	/** Age up to which a list is used without asking the API, in seconds */
+	float TimeToLive;
+	/** Time past TimeToLive during which a list is still shown while it is revalidated, in seconds */
+	float MaxStale;
+	/** Keeps the last list in Saved/Leet, so the first search of a run has something to show */
+	bool bPersist;
+
+	FOnlineServerListCacheSettingsLeet()
+		: TimeToLive(30.0f)
+		, MaxStale(300.0f)
+		, bPersist(false)
+	{
+	}
+};
+
+/** How a cached server list may be used */
+namespace EServerListCacheLookupLeet
+{
+	enum Type
+	{
+		/** Nothing usable, the list has to be fetched */
+		Miss,
+		/** Usable right away, but due for a revalidation */
+		Stale,
+		/** Usable without asking the API */
+		Fresh
+	};
+}
+
+/**
+ * Keeps the last decoded /api/v2/game/<key>/servers/ list so searches don't download and parse it every time.
+ *
+ * Fresh lists are used as they are.  Stale lists are shown right away while a conditional GET revalidates them, and
+ * a 304 only renews the list instead of sending it again.  Lists past MaxStale are fetched again, still with the
+ * validators, so an unchanged list costs no body.  The list is keyed by the URL of its first page, so a different
+ * API, game key or filter misses.  A list that took more than one page is cached whole but never revalidated, an
+ * unchanged first page says nothing about the pages after it, so it is fetched again in full once it goes stale.
+ */
+class FOnlineServerListCacheLeet
+{
+public:
+
+	FOnlineServerListCacheLeet();
+
+	/** Applies the settings, and loads the persisted list if the cache persists and is still empty */
+	void SetSettings(const FOnlineServerListCacheSettingsLeet& InSettings);
+	const FOnlineServerListCacheSettingsLeet& GetSettings() const { return Settings; }
+
+	/** @return how the list cached for the URL may be used, counted as a hit or a miss */
+	EServerListCacheLookupLeet::Type Lookup(const FString& Url);
+
+	/** @return the cached list, invalid if there is none */
+	TSharedPtr<const FLeetServerListResult, ESPMode::ThreadSafe> GetServerList() const { return ServerList; }
+
+	/** Adds If-None-Match and If-Modified-Since for the list cached for the URL, if it came as a single page */
+	void AddConditionalHeaders(const FString& Url, IHttpRequest& Request) const;
+
+	/**
+	 * Replaces the cached list with a newly downloaded one
+	 *
+	 * @param Url of the first page of the list
+	 * @param ETag validator of the first page, may be empty
+	 * @param LastModified validator of the first page, may be empty
+	 * @param InServerList every page of the list, lists that did not parse are not cached
+	 * @param bSinglePage the list came in one page, so the validators of that page cover all of it
+	 */
+	void Store(const FString& Url, const FString& ETag, const FString& LastModified, const FLeetServerListResult& InServerList, bool bSinglePage);
+
+	/** Renews the cached list after the API answered 304, with the validators of the answer if it sent new ones */
+	void Revalidate(const FString& Url, const FHttpResponsePtr& HttpResponse);
+
+	/** Drops the cached list, from memory and disk */
+	void Invalidate();
+
+	uint32 GetNumHits() const { return NumFreshHits + NumStaleHits; }
+	uint32 GetNumMisses() const { return NumMisses; }
+
+	/** Writes the cached list's age, validators and the hit and miss counters to the given output device */
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+
+	/** Reads the list persisted by an earlier run */
+	void Load();
+
+	/** Writes the list and its validators to disk */
+	void Save() const;
+
+	/** @return Saved/Leet/ServerListCache.bin */
+	static FString GetCacheFilename();
+
+	/** @return age of the cached list in seconds */
+	double GetAge() const;
+
+	FOnlineServerListCacheSettingsLeet Settings;
+
+	FString CachedUrl;
+	FString CachedETag;
+	FString CachedLastModified;
+	/** The cached list came in one page, only then is it revalidated with a conditional GET */
+	bool bCachedSinglePage;
+	/** When the list was last downloaded or revalidated, in UTC so persisted lists age across runs */
+	FDateTime FetchTime;
+	TSharedPtr<const FLeetServerListResult, ESPMode::ThreadSafe> ServerList;
+
+	uint32 NumFreshHits;
+	uint32 NumStaleHits;
+	uint32 NumMisses;
+	uint32 NumNotModified;
+	uint32 NumDownloaded;
+};
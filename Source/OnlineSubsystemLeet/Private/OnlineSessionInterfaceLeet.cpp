@@ -9,6 +9,8 @@
 #include "SocketSubsystem.h"
 #include "LANBeacon.h"
 #include "NboSerializerLeet.h"
+#include "LeetHttpTransport.h"
+#include "LeetOnlineGameSettings.h"
 
 #include "VoiceInterface.h"
 
@@ -21,7 +23,7 @@ FOnlineSessionInfoLeet::FOnlineSessionInfoLeet() :
 
 void FOnlineSessionInfoLeet::Init(const FOnlineSubsystemLeet& Subsystem)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online SessionInfo INIT"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online SessionInfo INIT"));
 	// Read the IP from the system
 	bool bCanBindAll;
 	HostAddr = ISocketSubsystem::Get()->GetLocalHostAddr(*GLog, bCanBindAll);
@@ -183,7 +185,7 @@ public:
 
 bool FOnlineSessionLeet::CreateSession(int32 HostingPlayerNum, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::CreateSession"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] FOnlineSessionLeet::CreateSession"));
 	uint32 Result = E_FAIL;
 
 	// Check for an existing session
@@ -248,6 +250,7 @@ bool FOnlineSessionLeet::CreateSession(int32 HostingPlayerNum, FName SessionName
 			else
 			{
 				RegisterLocalPlayers(Session);
+				UpdateQosResponder();
 			}
 		}
 	}
@@ -259,7 +262,7 @@ bool FOnlineSessionLeet::CreateSession(int32 HostingPlayerNum, FName SessionName
 	/*
 	if (Result != ERROR_IO_PENDING)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Create: Result != ERROR_IO_PENDING"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] Online Session Create: Result != ERROR_IO_PENDING"));
 		TriggerOnCreateSessionCompleteDelegates(SessionName, (Result == ERROR_SUCCESS) ? true : false);
 	}
 	*/
@@ -342,9 +345,38 @@ uint32 FOnlineSessionLeet::UpdateLANStatus()
 	return Result;
 }
 
+void FOnlineSessionLeet::UpdateQosResponder()
+{
+	bool bHasOnlineSession = false;
+	{
+		FScopeLock ScopeLock(&SessionLock);
+		for (int32 SessionIdx = 0; SessionIdx < Sessions.Num(); SessionIdx++)
+		{
+			bHasOnlineSession |= !Sessions[SessionIdx].SessionSettings.bIsLANMatch;
+		}
+	}
+
+	if (LeetSubsystem->IsDedicated() && bHasOnlineSession)
+	{
+		if (!QosResponder.IsRunning())
+		{
+			// Clients find the responder relative to the game port advertised in the server list
+			const int32 GamePort = GetPortFromNetDriver(LeetSubsystem->GetInstanceName());
+			if (GamePort > 0)
+			{
+				QosResponder.Start(GamePort + QosPinger.GetSettings().PortOffset);
+			}
+		}
+	}
+	else if (QosResponder.IsRunning())
+	{
+		QosResponder.Shutdown();
+	}
+}
+
 bool FOnlineSessionLeet::StartSession(FName SessionName)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Start"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Session Start"));
 	uint32 Result = E_FAIL;
 	// Grab the session information by name
 	FNamedOnlineSession* Session = GetNamedSession(SessionName);
@@ -357,6 +389,9 @@ bool FOnlineSessionLeet::StartSession(FName SessionName)
 			// If this lan match has join in progress disabled, shut down the beacon
 			Result = UpdateLANStatus();
 			Session->SessionState = EOnlineSessionState::InProgress;
+
+			// The net driver listens by now, in case it did not yet when the session was created
+			UpdateQosResponder();
 		}
 		else
 		{
@@ -381,7 +416,7 @@ bool FOnlineSessionLeet::StartSession(FName SessionName)
 
 bool FOnlineSessionLeet::UpdateSession(FName SessionName, FOnlineSessionSettings& UpdatedSessionSettings, bool bShouldRefreshOnlineData)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Update"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Session Update"));
 	bool bWasSuccessful = true;
 
 	// Grab the session information by name
@@ -398,7 +433,7 @@ bool FOnlineSessionLeet::UpdateSession(FName SessionName, FOnlineSessionSettings
 
 bool FOnlineSessionLeet::EndSession(FName SessionName)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session End"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Session End"));
 	uint32 Result = E_FAIL;
 
 	// Grab the session information by name
@@ -450,6 +485,7 @@ bool FOnlineSessionLeet::DestroySession(FName SessionName, const FOnDestroySessi
 		RemoveNamedSession(Session->SessionName);
 
 		Result = UpdateLANStatus();
+		UpdateQosResponder();
 	}
 	else
 	{
@@ -493,7 +529,7 @@ bool FOnlineSessionLeet::CancelMatchmaking(const FUniqueNetId& SearchingPlayerId
 
 bool FOnlineSessionLeet::FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindSessions"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] FOnlineSessionLeet::FindSessions"));
 	uint32 Return = E_FAIL;
 	uint32 OnlineReturn = E_FAIL;
 
@@ -506,6 +542,12 @@ bool FOnlineSessionLeet::FindSessions(int32 SearchingPlayerNum, const TSharedRef
 		// Copy the search pointer so we can keep it around
 		CurrentSessionSearch = SearchSettings;
 
+		// Pings and changes of an earlier search would land in the wrong results
+		QosPinger.Cancel();
+		PendingSearchDelta = FLeetSearchResultsDelta();
+		PingedSessionSearch = SearchSettings;
+		bSearchAwaitingPings = false;
+
 		// remember the time at which we started search, as this will be used for a "good enough" ping estimation
 		SessionSearchStartInSeconds = FPlatformTime::Seconds();
 
@@ -531,231 +573,218 @@ bool FOnlineSessionLeet::FindSessions(int32 SearchingPlayerNum, const TSharedRef
 
 bool FOnlineSessionLeet::FindSessions(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Sessions Find"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Sessions Find"));
 	// This function doesn't use the SearchingPlayerNum parameter, so passing in anything is fine.
 	return FindSessions(0, SearchSettings);
 }
 
 bool FOnlineSessionLeet::FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId, const FUniqueNetId& FriendId, const FOnSingleSessionResultCompleteDelegate& CompletionDelegates)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Find by ID"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Find by ID"));
 	FOnlineSessionSearchResult EmptyResult;
 	CompletionDelegates.ExecuteIfBound(0, false, EmptyResult);
 	return true;
 }
 
+namespace
+{
+	/** Fields of a server list entry the search uses, the API leaves out the rest */
+	const TCHAR* SERVER_LIST_FIELDS = TEXT("key,session_id,title,session_host_address,qos_port");
+}
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetServerListResult& OutResult)
+{
+	const TArray<TSharedPtr<FJsonValue>>* ServersJson = nullptr;
+	if (!JsonObject.TryGetArrayField(TEXT("servers"), ServersJson))
+	{
+		return;
+	}
+	JsonObject.TryGetStringField(TEXT("next_cursor"), OutResult.NextCursor);
+
+	OutResult.Servers.Reserve(ServersJson->Num());
+	for (int32 ServerIdx = 0; ServerIdx < ServersJson->Num(); ServerIdx++)
+	{
+		TSharedPtr<FJsonObject> ServerJson = (*ServersJson)[ServerIdx]->AsObject();
+		if (!ServerJson.IsValid())
+		{
+			continue;
+		}
+
+		// Entries without a key can't be joined
+		FLeetServerEntry Server;
+		if (!ServerJson->TryGetStringField(TEXT("key"), Server.Key) || Server.Key.IsEmpty())
+		{
+			continue;
+		}
+
+		// Only the fields the search uses are read, an API that ignores the projection sends more
+		ServerJson->TryGetStringField(TEXT("title"), Server.Title);
+		ServerJson->TryGetStringField(TEXT("session_host_address"), Server.HostAddress);
+
+		// Parsed here, off the game thread, so the results only need the address built
+		FString IPAddress;
+		FString Port;
+		FIPv4Address HostIp;
+		if (Server.HostAddress.Split(TEXT(":"), &IPAddress, &Port) && FIPv4Address::Parse(IPAddress, HostIp))
+		{
+			Server.HostIp = HostIp.Value;
+			Server.HostPort = FCString::Atoi(*Port);
+		}
+
+		FString QosPort;
+		if (ServerJson->TryGetStringField(TEXT("qos_port"), QosPort))
+		{
+			Server.QosPort = FCString::Atoi(*QosPort);
+		}
+
+		// session_id isn't set on all servers yet, the key is unique as well
+		if (!ServerJson->TryGetStringField(TEXT("session_id"), Server.SessionId) || Server.SessionId.IsEmpty())
+		{
+			Server.SessionId = Server.Key;
+		}
+
+		OutResult.Servers.Add(Server);
+	}
+}
+
 uint32 FOnlineSessionLeet::FindOnlineSession()
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession"));
 	uint32 Return = ERROR_IO_PENDING;
 
+	// A new download, pages of the last one still on their way are dropped
+	const uint32 FetchId = ServerListFetch.FetchId + 1;
+	ServerListFetch = FServerListFetch();
+	ServerListFetch.FetchId = FetchId;
+	ServerListFetch.SearchSettings = CurrentSessionSearch;
+	// The API picks which servers make the cut, before any of them is pinged
+	ServerListFetch.MaxServers = CurrentSessionSearch->MaxSearchResults > 0 ? CurrentSessionSearch->MaxSearchResults : MAX_int32;
+	if (MaxServerListSize > 0)
+	{
+		ServerListFetch.MaxServers = FMath::Min(ServerListFetch.MaxServers, MaxServerListSize);
+	}
+	ServerListFetch.FirstPageUrl = BuildServerListUrl(*CurrentSessionSearch, FString(), FMath::Min(ServerListFetch.MaxServers, ServerListPageSize));
+
+	// A cached list shows up right away, and is enough on its own while it is fresh
+	const EServerListCacheLookupLeet::Type CacheLookup = ServerListCache.Lookup(ServerListFetch.FirstPageUrl);
+	if (CacheLookup != EServerListCacheLookupLeet::Miss)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession using the %s cached server list"), CacheLookup == EServerListCacheLookupLeet::Fresh ? TEXT("fresh") : TEXT("stale"));
+		ApplyServerList(*ServerListCache.GetServerList());
+		if (CacheLookup == EServerListCacheLookupLeet::Fresh)
+		{
+			return Return;
+		}
+	}
+
+	RequestServerListPage(ServerListFetch.FirstPageUrl, CacheLookup == EServerListCacheLookupLeet::Stale);
+
+	//FPendingSessionQuery
+	return Return;
+}
+
+FString FOnlineSessionLeet::BuildServerListUrl(const FOnlineSessionSearch& SearchSettings, const FString& Cursor, int32 Limit) const
+{
 	// looking at online subsystem facebook friends to get this
-	TSharedRef<class IHttpRequest> HttpRequest = FHttpModule::Get().CreateRequest();
 	FString GameKey = LeetSubsystem->GetGameKey();
 	FString APIURL = LeetSubsystem->GetAPIURL();
 	FString SessionQueryUrl = "http://" + APIURL + "/api/v2/game/" + GameKey + "/servers/";
+	SessionQueryUrl += FString::Printf(TEXT("?fields=%s&limit=%d"), SERVER_LIST_FIELDS, Limit);
 
-	HttpRequest->OnProcessRequestComplete().BindRaw(this, &FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete);
+	// The filters the API can apply, other query settings such as presence or streaming don't concern it
+	FString Keywords;
+	if (SearchSettings.QuerySettings.Get(SEARCH_KEYWORDS, Keywords) && !Keywords.IsEmpty())
+	{
+		SessionQueryUrl += TEXT("&keywords=") + FPlatformHttp::UrlEncode(Keywords);
+	}
+	bool bDedicatedOnly = false;
+	if (SearchSettings.QuerySettings.Get(SEARCH_DEDICATED_ONLY, bDedicatedOnly) && bDedicatedOnly)
+	{
+		SessionQueryUrl += TEXT("&dedicated_only=1");
+	}
+	bool bEmptyOnly = false;
+	if (SearchSettings.QuerySettings.Get(SEARCH_EMPTY_SERVERS_ONLY, bEmptyOnly) && bEmptyOnly)
+	{
+		SessionQueryUrl += TEXT("&empty_only=1");
+	}
 
-	HttpRequest->SetURL(SessionQueryUrl);
-	HttpRequest->SetHeader("User-Agent", "LEET_UE4_API_CLIENT/1.0");
-	HttpRequest->SetHeader("Content-Type", "application/x-www-form-urlencoded");
+	if (!Cursor.IsEmpty())
+	{
+		SessionQueryUrl += TEXT("&cursor=") + FPlatformHttp::UrlEncode(Cursor);
+	}
+	return SessionQueryUrl;
+}
+
+void FOnlineSessionLeet::RequestServerListPage(const FString& Url, bool bShowingCachedList)
+{
+	// Shares the keep-alive connection pool with the rest of the Leet API traffic
+	TSharedRef<class IHttpRequest> HttpRequest = FLeetHttpTransport::Get().CreateRequest(TEXT("GET"), Url);
 	HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-	HttpRequest->SetVerb(TEXT("GET"));
-	bool requestSuccess = HttpRequest->ProcessRequest();
 
-	//FPendingSessionQuery
-	return Return;
+	// Only a list that fit on its first page can be revalidated with it, the cache knows which kind it holds
+	if (Url == ServerListFetch.FirstPageUrl)
+	{
+		ServerListCache.AddConditionalHeaders(Url, *HttpRequest);
+	}
+	ServerListFetch.NumPages++;
+	ILeetAsyncScheduler::Schedule(HttpRequest, FHttpRequestCompleteDelegate::CreateRaw(this, &FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete, ServerListFetch.FetchId, bShowingCachedList));
 }
 
-void FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded)
+void FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, uint32 FetchId, bool bShowingCachedList)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete"));
 
-	bool bResult = false;
-	FString ResponseStr, ErrorStr;
+	if (FetchId != ServerListFetch.FetchId)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete dropping a page of an earlier search"));
+		return;
+	}
+
+	FString ErrorStr;
 
 	if (bSucceeded &&
 		HttpResponse.IsValid())
 	{
-		ResponseStr = HttpResponse->GetContentAsString();
-		if (EHttpResponseCodes::IsOk(HttpResponse->GetResponseCode()))
+		const FString Url = HttpRequest->GetURL();
+		if (HttpResponse->GetResponseCode() == EHttpResponseCodes::NotModified)
 		{
-			UE_LOG(LogOnline, Verbose, TEXT("Query sessions request complete. url=%s code=%d response=%s"),
-				*HttpRequest->GetURL(), HttpResponse->GetResponseCode(), *ResponseStr);
-
-			// Create the Json parser
-			TSharedPtr<FJsonObject> JsonObject;
-			TSharedRef<TJsonReader<> > JsonReader = TJsonReaderFactory<>::Create(ResponseStr);
+			UE_LOG(LogOnline, Verbose, TEXT("Query sessions request complete, not modified. url=%s"), *Url);
 
-			if (FJsonSerializer::Deserialize(JsonReader, JsonObject) &&
-				JsonObject.IsValid())
+			// The cached list still holds, the search only needs it if it isn't showing it yet
+			ServerListCache.Revalidate(Url, HttpResponse);
+			TSharedPtr<const FLeetServerListResult, ESPMode::ThreadSafe> CachedList = ServerListCache.GetServerList();
+			if (!bShowingCachedList && CachedList.IsValid())
 			{
-				UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete JSON valid"));
+				ApplyServerList(*CachedList);
+			}
+		}
+		else if (EHttpResponseCodes::IsOk(HttpResponse->GetResponseCode()))
+		{
+			UE_LOG(LogOnline, Verbose, TEXT("Query sessions request complete. url=%s code=%d bytes=%d"),
+				*Url, HttpResponse->GetResponseCode(), HttpResponse->GetContent().Num());
 
-				// Empty out the search results
-				FOnlineSessionSearch* SessionSearch = CurrentSessionSearch.Get();
-				SessionSearch->SearchResults.Empty();
+			// Validators are read here, the response stays on the game thread
+			if (Url == ServerListFetch.FirstPageUrl)
+			{
+				ServerListFetch.ETag = HttpResponse->GetHeader(TEXT("ETag"));
+				ServerListFetch.LastModified = HttpResponse->GetHeader(TEXT("Last-Modified"));
+			}
 
-				// Should have an array of id mappings
-				TArray<TSharedPtr<FJsonValue> > JsonServers = JsonObject->GetArrayField(TEXT("servers"));
-				for (TArray<TSharedPtr<FJsonValue> >::TConstIterator ServerIt(JsonServers); ServerIt; ++ServerIt)
+			// Large lists take a while to parse, that happens on a worker and only the result comes back here
+			TWeakPtr<FOnlineSessionLeet*, ESPMode::ThreadSafe> WeakSelf = SelfHandle;
+			FLeetApiDecoder::DecodeAsync<FLeetServerListResult>(HttpResponse, [WeakSelf, FetchId](const FLeetServerListResult& Result)
+			{
+				TSharedPtr<FOnlineSessionLeet*, ESPMode::ThreadSafe> Self = WeakSelf.Pin();
+				if (Self.IsValid())
 				{
-					UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete SERVER >> "));
-					FString ServerKeyStr;
-					TMap<FString, FString> Attributes;
-					TSharedPtr<FJsonObject> JsonServerEntry = (*ServerIt)->AsObject();
-					for (TMap<FString, TSharedPtr<FJsonValue > >::TConstIterator It(JsonServerEntry->Values); It; ++It)
-					{
-						// parse server attributes
-						if (It->Value.IsValid() &&
-							It->Value->Type == EJson::String)
-						{
-							FString ValueStr = It->Value->AsString();
-							UE_LOG(LogTemp, Log, TEXT("ValueStr: %s"), *ValueStr);
-							if (It->Key == TEXT("key"))
-							{
-								ServerKeyStr = ValueStr;
-							}
-							Attributes.Add(It->Key, ValueStr);
-						}
-					}
-					// only add if valid id
-					if (!ServerKeyStr.IsEmpty())
-					{
-						UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete Adding a session for this server "));
-
-						// Create an object that we'll copy the data to
-						//FOnlineSessionSettings NewServer;
-						// The wiki howto does it differently like this:
-						//TSharedPtr<class FOnlineSessionSettings> NewServer = MakeShareable(new FOnlineSessionSettings());
-
-						if (CurrentSessionSearch.IsValid())
-						{
-
-							// Set up the data we need out of json
-							FString session_host_address = Attributes["session_host_address"];
-							FString split_delimiter = ":";
-							FString IPAddress = TEXT("");
-							FString Port = TEXT("");
-							session_host_address.Split(split_delimiter, &IPAddress, &Port);
-							UE_LOG(LogTemp, Log, TEXT("IPAddress: %s"), *IPAddress);
-							UE_LOG(LogTemp, Log, TEXT("Port: %s"), *Port);
-							FIPv4Address ip;
-							FIPv4Address::Parse(IPAddress, ip);
-							const TCHAR* TheIpTChar = *IPAddress;
-							bool isValid = true;
-							int32 PortInt = FCString::Atoi(*Port);
-
-
-							// We currently have the json for a single server
-							// We want to stick it in a sesssion
-							// which ends up as a SearchResult (FOnlineSessionSearchResult)
-							// which gets stored in an array inside SearchSettings
-
-							// problem:  Unable to set the HostAddr.
-							// How does NULL subsystem do it?
-
-							// I've made a mess in here and still can't get it to work.
-
-
-
-							// OLD STUFF 
-
-							TSharedPtr<class FOnlineSessionSettings> NewSessionSettings = MakeShareable(new FOnlineSessionSettings());
-
-							// Add space in the search results array
-							FOnlineSessionSearchResult* NewResult = new (CurrentSessionSearch->SearchResults) FOnlineSessionSearchResult();
-							// this is not a correct ping, but better than nothing
-							//NewResult->PingInMs = static_cast<int32>((FPlatformTime::Seconds() - SessionSearchStartInSeconds) * 1000);
-
-							// I think this might be backwards...
-							// look at HostSession here:  https://wiki.unrealengine.com/How_To_Use_Sessions_In_C%2B%2B
-							// They construct the settings first, then pass it to construct the session. maybe the info goes in that way as well?
-
-							FOnlineSession* NewSession = &NewResult->Session;
-							UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete Session Created "));
-
-							
-
-							UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete 4 "));
-							//internetAddress->SetIp(ip.GetValue());
-							//UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete 5 "));
-							
-							UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete 6 "));
-
-
-							UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete Parsed IpAddress "));
-							
-							// THis is not set on all servers yet, keeping it muted for now
-							//FString session_id = Attributes["session_id"];
-
-							// coped over from OnlineSessionInterfaceNull 677
-							//FOnlineSessionInfoLeet* SessionInfo = (FOnlineSessionInfoLeet*)NewSession->SessionInfo.Get();
-							UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete Got SessionInfo "));
-
-
-							//uint32 HostIp = 0;
-							//SessionInfo->HostAddr->GetIp(HostIp); // will return in host order
-							//SessionInfo->HostAddr->SetIp(0x7f000001);	// 127.0.0.1
-							
-							//MakeShareable(&internetAddress);
-							// Crashes client
-							//bool setHostAddrSuccess = SessionInfo->SetHostAddr(internetAddress);
-
-							// Crashes Client
-							//SessionInfo->HostAddr = internetAddress;
-
-							//Crashes Client
-							//SessionInfo->HostAddr = ISocketSubsystem::Get()->CreateInternetAddr(ip.Value, PortInt);
-							
-							UE_LOG(LogTemp, Log, TEXT("[LEET] FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete Set HostAddress "));
-							//SessionInfo->SessionId = SearchSessionInfo->SessionId;
-
-							//FOnlineSessionInfoLeet* NewSessionInfo;
-							//NewSessionInfo->HostAddr = internetAddress;
-							//NewSession->SessionInfo-> = NewSessionInfo;
-							//
-
-							//FUniqueNetIdString* NewNetIdString = new FUniqueNetIdString;
-							//NewNetIdString->
-							//NewNetIdString.UniqueNetIdStr = session_id;
-							//NewSessionInfo->SetSessionId(NewNetIdString);
-
-							//TSharedRef < FInternetAddr > internetAddress = new FInternetAddr();
-							//NewSession->SessionInfo.
-							//bool hostSuccess = NewSession->SessionInfo ->SetHostAddr(internetAddress);
-
-							NewSession->SessionSettings.bIsDedicated = true;
-							NewSession->SessionSettings.bIsLANMatch = false;
-
-							// This adds the address to a custom field, which we don't really want.
-							// Leaving it for now for debug purposes.
-							FName key = "session_host_address";
-							NewSession->SessionSettings.Set(key, Attributes["session_host_address"]);
-
-
-							key = "serverKey";
-							NewSession->SessionSettings.Set(key, Attributes["key"]);
-							key = "serverTitle";
-							NewSession->SessionSettings.Set(key, Attributes["title"]);
-							// TODO add all of the custom leet server settings we care about.
-
-							// NOTE: we don't notify until the timeout happens
-						}
-						else
-						{
-							UE_LOG_ONLINE(Warning, TEXT("Failed to create new online game settings object"));
-						}
-					}
+					(*Self)->ApplyServerListPage(FetchId, Result);
 				}
-				bResult = true;
-			}
+			});
 		}
 		else
 		{
 			ErrorStr = FString::Printf(TEXT("Invalid response. code=%d error=%s"),
-				HttpResponse->GetResponseCode(), *ResponseStr);
+				HttpResponse->GetResponseCode(), *HttpResponse->GetContentAsString());
 		}
 	}
 	else
@@ -770,9 +799,226 @@ void FOnlineSessionLeet::FindOnlineSession_HttpRequestComplete(FHttpRequestPtr H
 
 }
 
+void FOnlineSessionLeet::ApplyServerListPage(uint32 FetchId, const FLeetServerListResult& Page)
+{
+	if (FetchId != ServerListFetch.FetchId)
+	{
+		return;
+	}
+	if (!Page.bParsed)
+	{
+		// The pages so far stay, but an incomplete list neither removes results nor gets cached
+		UE_LOG(LogOnline, Warning, TEXT("Query sessions request failed. Invalid JSON"));
+		return;
+	}
+
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] FOnlineSessionLeet::ApplyServerListPage %d servers, %s"), Page.Servers.Num(), Page.NextCursor.IsEmpty() ? TEXT("last page") : TEXT("more to come"));
+
+	// Servers that don't page send everything at once, only as many as the search wants are kept
+	FLeetServerListResult& ServerList = ServerListFetch.ServerList;
+	const int32 NumToKeep = FMath::Min(Page.Servers.Num(), ServerListFetch.MaxServers - ServerList.Servers.Num());
+	if (NumToKeep < Page.Servers.Num())
+	{
+		TArray<FLeetServerEntry> KeptServers(Page.Servers.GetData(), NumToKeep);
+		AddServers(KeptServers);
+		ServerList.Servers.Append(KeptServers);
+	}
+	else
+	{
+		AddServers(Page.Servers);
+		ServerList.Servers.Append(Page.Servers);
+	}
+
+	if (!Page.NextCursor.IsEmpty() && ServerList.Servers.Num() < ServerListFetch.MaxServers)
+	{
+		TSharedPtr<FOnlineSessionSearch> SearchSettings = ServerListFetch.SearchSettings.Pin();
+		if (SearchSettings.IsValid())
+		{
+			const int32 Limit = FMath::Min(ServerListFetch.MaxServers - ServerList.Servers.Num(), ServerListPageSize);
+			RequestServerListPage(BuildServerListUrl(*SearchSettings, Page.NextCursor, Limit), false);
+		}
+		return;
+	}
+
+	// The whole list is in, whatever the search shows beyond it has gone away
+	ServerList.bParsed = true;
+	RemoveUnlistedServers(ServerList);
+	ServerListCache.Store(ServerListFetch.FirstPageUrl, ServerListFetch.ETag, ServerListFetch.LastModified, ServerList, ServerListFetch.NumPages == 1);
+}
+
+void FOnlineSessionLeet::ApplyServerList(const FLeetServerListResult& Result)
+{
+	AddServers(Result.Servers);
+	RemoveUnlistedServers(Result);
+}
+
+void FOnlineSessionLeet::AddServers(const TArray<FLeetServerEntry>& Servers)
+{
+	if (!CurrentSessionSearch.IsValid())
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Failed to create new online game settings object"));
+		return;
+	}
+
+	// Servers the search has already are updated, so their results and pings stay where they are
+	TArray<FOnlineSessionSearchResult>& SearchResults = CurrentSessionSearch->SearchResults;
+	TMap<FString, int32> OnlineResultIdx;
+	for (int32 ResultIdx = 0; ResultIdx < SearchResults.Num(); ResultIdx++)
+	{
+		FString ServerKey;
+		if (!SearchResults[ResultIdx].Session.SessionSettings.bIsLANMatch && SearchResults[ResultIdx].Session.SessionSettings.Get(FName(TEXT("serverKey")), ServerKey))
+		{
+			OnlineResultIdx.Add(ServerKey, ResultIdx);
+		}
+	}
+
+	SearchResults.Reserve(SearchResults.Num() + Servers.Num());
+	for (int32 ServerIdx = 0; ServerIdx < Servers.Num(); ServerIdx++)
+	{
+		const FLeetServerEntry& Server = Servers[ServerIdx];
+
+		const int32* ExistingIdx = OnlineResultIdx.Find(Server.Key);
+		if (ExistingIdx)
+		{
+			// PingInMs is kept, the server was probed already
+			FillSearchResult(Server, SearchResults[*ExistingIdx]);
+			PendingSearchDelta.Update(Server.Key);
+		}
+		else
+		{
+			UE_LOG(LogLeet, Verbose, TEXT("[LEET] FOnlineSessionLeet::AddServers Adding a session for server %s"), *Server.Key);
+
+			// PingInMs stays MAX_QUERY_PING until the QoS probes answer
+			OnlineResultIdx.Add(Server.Key, SearchResults.Num());
+			FOnlineSessionSearchResult* NewResult = new (SearchResults) FOnlineSessionSearchResult();
+			FillSearchResult(Server, *NewResult);
+			PendingSearchDelta.Add(Server.Key);
+
+			const FOnlineSessionInfoLeet* SessionInfo = static_cast<const FOnlineSessionInfoLeet*>(NewResult->Session.SessionInfo.Get());
+			if (SessionInfo)
+			{
+				QosPinger.AddTarget(Server.Key, *SessionInfo->HostAddr, Server.QosPort);
+			}
+		}
+	}
+
+	// Streaming searches see the servers on the next tick, the others once the LAN timeout completes the search
+}
+
+void FOnlineSessionLeet::RemoveUnlistedServers(const FLeetServerListResult& Result)
+{
+	if (!CurrentSessionSearch.IsValid())
+	{
+		return;
+	}
+
+	TSet<FString> ListedKeys;
+	ListedKeys.Reserve(Result.Servers.Num());
+	for (int32 ServerIdx = 0; ServerIdx < Result.Servers.Num(); ServerIdx++)
+	{
+		ListedKeys.Add(Result.Servers[ServerIdx].Key);
+	}
+
+	// Servers that left the list since it was last applied, LAN results are left alone
+	TArray<FOnlineSessionSearchResult>& SearchResults = CurrentSessionSearch->SearchResults;
+	for (int32 ResultIdx = SearchResults.Num() - 1; ResultIdx >= 0; ResultIdx--)
+	{
+		FString ServerKey;
+		if (!SearchResults[ResultIdx].Session.SessionSettings.bIsLANMatch && SearchResults[ResultIdx].Session.SessionSettings.Get(FName(TEXT("serverKey")), ServerKey)
+			&& !ListedKeys.Contains(ServerKey))
+		{
+			SearchResults.RemoveAt(ResultIdx);
+			PendingSearchDelta.Remove(ServerKey);
+		}
+	}
+}
+
+void FOnlineSessionLeet::FillSearchResult(const FLeetServerEntry& Server, FOnlineSessionSearchResult& SearchResult)
+{
+	FOnlineSession& Session = SearchResult.Session;
+
+	// The address was parsed with the rest of the list, joining and connect strings read it from here
+	if (Server.HostPort > 0)
+	{
+		FOnlineSessionInfoLeet* NewSessionInfo = new FOnlineSessionInfoLeet();
+		NewSessionInfo->HostAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr(Server.HostIp, Server.HostPort);
+		NewSessionInfo->SessionId = FUniqueNetIdString(Server.SessionId);
+		Session.SessionInfo = MakeShareable(NewSessionInfo);
+	}
+	else
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] FOnlineSessionLeet::FillSearchResult no address for %s: %s"), *Server.Key, *Server.HostAddress);
+		Session.SessionInfo.Reset();
+	}
+
+	Session.SessionSettings.bIsDedicated = true;
+	Session.SessionSettings.bIsLANMatch = false;
+
+	// Kept as a setting for display and debugging, joining uses the session info
+	FName key = "session_host_address";
+	Session.SessionSettings.Set(key, Server.HostAddress);
+
+	key = "serverKey";
+	Session.SessionSettings.Set(key, Server.Key);
+	key = "serverTitle";
+	Session.SessionSettings.Set(key, Server.Title);
+	if (Server.QosPort > 0)
+	{
+		key = "qos_port";
+		Session.SessionSettings.Set(key, Server.QosPort);
+	}
+	// TODO add all of the custom leet server settings we care about.
+}
+
+void FOnlineSessionLeet::PublishSearchDelta()
+{
+	if (PendingSearchDelta.IsEmpty())
+	{
+		return;
+	}
+
+	FLeetSearchResultsDelta Delta = MoveTemp(PendingSearchDelta);
+	PendingSearchDelta = FLeetSearchResultsDelta();
+
+	TSharedPtr<FOnlineSessionSearch> SessionSearch = PingedSessionSearch.Pin();
+	FLeetOnlineSearchSettings* LeetSearch = SessionSearch.IsValid() ? FLeetOnlineSearchSettings::AsStreaming(*SessionSearch) : nullptr;
+	if (LeetSearch)
+	{
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] FOnlineSessionLeet::PublishSearchDelta %d added, %d updated, %d removed"), Delta.Added.Num(), Delta.Updated.Num(), Delta.Removed.Num());
+		LeetSearch->OnResultsChanged.Broadcast(Delta);
+	}
+}
+
+void FOnlineSessionLeet::DumpSearchResults(FOutputDevice& Ar) const
+{
+	ServerListCache.Dump(Ar);
+	QosPinger.Dump(Ar);
+	QosResponder.Dump(Ar);
+
+	// The current search is dropped once it completes, the pinged one is kept as long as the game holds it
+	TSharedPtr<FOnlineSessionSearch> SessionSearch = CurrentSessionSearch.IsValid() ? CurrentSessionSearch : PingedSessionSearch.Pin();
+	if (!SessionSearch.IsValid())
+	{
+		Ar.Logf(TEXT("Leet server list: no search"));
+		return;
+	}
+
+	Ar.Logf(TEXT("Leet server list: %s, %d results"), EOnlineAsyncTaskState::ToString(SessionSearch->SearchState), SessionSearch->SearchResults.Num());
+	for (int32 ResultIdx = 0; ResultIdx < SessionSearch->SearchResults.Num(); ResultIdx++)
+	{
+		const FOnlineSession& Session = SessionSearch->SearchResults[ResultIdx].Session;
+		FString ServerTitle;
+		FString HostAddress;
+		Session.SessionSettings.Get(FName(TEXT("serverTitle")), ServerTitle);
+		Session.SessionSettings.Get(FName(TEXT("session_host_address")), HostAddress);
+		Ar.Logf(TEXT("  %d: %s at %s, %dms, %d/%d open"), ResultIdx, *ServerTitle, *HostAddress, SessionSearch->SearchResults[ResultIdx].PingInMs,
+			Session.NumOpenPublicConnections, Session.SessionSettings.NumPublicConnections);
+	}
+}
+
 uint32 FOnlineSessionLeet::FindLANSession()
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Find LAN"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Session Find LAN"));
 	uint32 Return = ERROR_IO_PENDING;
 
 	// Recreate the unique identifier for this client
@@ -806,6 +1052,12 @@ bool FOnlineSessionLeet::CancelFindSessions()
 		Return = ERROR_SUCCESS;
 
 		FinalizeLANSearch();
+		QosPinger.Cancel();
+		PendingSearchDelta = FLeetSearchResultsDelta();
+		bSearchAwaitingPings = false;
+
+		// Pages still on their way are dropped
+		ServerListFetch.FetchId++;
 
 		CurrentSessionSearch->SearchState = EOnlineAsyncTaskState::Failed;
 		CurrentSessionSearch = NULL;
@@ -825,67 +1077,22 @@ bool FOnlineSessionLeet::CancelFindSessions()
 
 bool FOnlineSessionLeet::JoinSession(int32 PlayerNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Session Join"));
 	uint32 Return = E_FAIL;
 	FNamedOnlineSession* Session = GetNamedSession(SessionName);
 	// Don't join a session if already in one or hosting one
 	if (Session == NULL)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join 1"));
 		// Create a named session from the search result data
 		Session = AddNamedSession(SessionName, DesiredSession.Session);
 		Session->HostingPlayerNum = PlayerNum;
 
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join 2"));
-		// Create Internet or LAN match
+		// Online and LAN results both carry a resolved session info, JoinLANSession copies it into the joined session
 		FOnlineSessionInfoLeet* NewSessionInfo = new FOnlineSessionInfoLeet();
-		//Session->SessionInfo = MakeShareable(NewSessionInfo);  //moved this down
-
-		// Trying to setup our hostaddr here....  Since I cant get it working on session search
-		FName key = "session_host_address";
-		FString session_host_address = "";
-		FString split_delimiter = ":";
-		FString IPAddress = TEXT("");
-		FString Port = TEXT("");
-
-		Session->SessionSettings.Get(key, session_host_address);
-		session_host_address.Split(split_delimiter, &IPAddress, &Port);
-
-		
-
-		UE_LOG(LogTemp, Log, TEXT("IPAddress: %s"), *IPAddress);
-		UE_LOG(LogTemp, Log, TEXT("Port: %s"), *Port);
-		FIPv4Address ip;
-		FIPv4Address::Parse(IPAddress, ip);
-		const TCHAR* TheIpTChar = *IPAddress;
-		bool isValid = true;
-		int32 PortInt = FCString::Atoi(*Port);
-		NewSessionInfo->HostAddr = ISocketSubsystem::Get()->CreateInternetAddr(ip.Value, PortInt);
-
-		key = "session_id";
-		FString session_id = "";
-		Session->SessionSettings.Get(key, session_id);
-		const FString session_id_const = session_id;
-		FUniqueNetIdString *session_id_str = new FUniqueNetIdString(session_id_const);
-
-		NewSessionInfo->SetSessionId(session_id_str);
-
-		// This is resulting in an non-valid SessionInfo
-		// I think we need this unique string, but I cant set it.
-
 		Session->SessionInfo = MakeShareable(NewSessionInfo);
-		const TSharedPtr<FOnlineSessionInfo> const_session_info = Session->SessionInfo;
-
-		//////////////
 
+		Return = JoinLANSession(PlayerNum, Session, &DesiredSession.Session);
 
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join 3"));
-		// I'm not sure if we should do this, but it's working so I'm leaving it like this.
-		// it used to be:
-		//Return = JoinLANSession(PlayerNum, Session, &DesiredSession.Session);
-		Return = JoinLANSession(PlayerNum, Session, Session);
-
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join 4"));
 		// turn off advertising on Join, to avoid clients advertising it over LAN
 		Session->SessionSettings.bShouldAdvertise = false;
 
@@ -918,7 +1125,7 @@ bool FOnlineSessionLeet::JoinSession(int32 PlayerNum, FName SessionName, const F
 
 bool FOnlineSessionLeet::JoinSession(const FUniqueNetId& PlayerId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join 2"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Session Join 2"));
 	// Assuming player 0 should be OK here
 	return JoinSession(0, SessionName, DesiredSession);
 }
@@ -965,7 +1172,7 @@ bool FOnlineSessionLeet::SendSessionInviteToFriends(const FUniqueNetId& LocalUse
 
 uint32 FOnlineSessionLeet::JoinLANSession(int32 PlayerNum, FNamedOnlineSession* Session, const FOnlineSession* SearchSession)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join LAN"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Join LAN"));
 	check(Session != nullptr);
 
 	uint32 Result = E_FAIL;
@@ -973,20 +1180,20 @@ uint32 FOnlineSessionLeet::JoinLANSession(int32 PlayerNum, FNamedOnlineSession*
 
 	// Debug logging
 	if (Session->SessionInfo.IsValid()) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join LAN : Session->SessionInfo.IsValid()"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Join LAN : Session->SessionInfo.IsValid()"));
 	}
 	if (SearchSession != nullptr) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join LAN : SearchSession != nullptr"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Join LAN : SearchSession != nullptr"));
 	}
 	if (SearchSession->SessionInfo.IsValid()) {
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join LAN : SearchSession->SessionInfo.IsValid()"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Join LAN : SearchSession->SessionInfo.IsValid()"));
 	}
 
 	// Was testing to see what would happen, and "Fatal Error"
 	//if (Session->SessionInfo.IsValid() && SearchSession != nullptr)
-	if (Session->SessionInfo.IsValid() && SearchSession != nullptr && SearchSession->SessionInfo.IsValid())
+	if (Session->SessionInfo.IsValid() && SearchSession != nullptr && SearchSession->SessionInfo.IsValid() && SearchSession->SessionInfo->IsValid())
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Join LAN VALID"));
+		UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Join LAN VALID"));
 		// Copy the session info over
 		const FOnlineSessionInfoLeet* SearchSessionInfo = (const FOnlineSessionInfoLeet*)SearchSession->SessionInfo.Get();
 		FOnlineSessionInfoLeet* SessionInfo = (FOnlineSessionInfoLeet*)Session->SessionInfo.Get();
@@ -1004,13 +1211,57 @@ uint32 FOnlineSessionLeet::JoinLANSession(int32 PlayerNum, FNamedOnlineSession*
 
 bool FOnlineSessionLeet::PingSearchResults(const FOnlineSessionSearchResult& SearchResult)
 {
-	return false;
+	FString ServerKey;
+	int32 QosPort = 0;
+	SearchResult.Session.SessionSettings.Get(FName(TEXT("serverKey")), ServerKey);
+	SearchResult.Session.SessionSettings.Get(FName(TEXT("qos_port")), QosPort);
+
+	// Only results of the Leet server list can be probed, the result is written back into the search it came from
+	const FOnlineSessionInfoLeet* SessionInfo = static_cast<const FOnlineSessionInfoLeet*>(SearchResult.Session.SessionInfo.Get());
+	if (ServerKey.IsEmpty() || SessionInfo == nullptr || !SessionInfo->IsValid())
+	{
+		return false;
+	}
+
+	QosPinger.AddTarget(ServerKey, *SessionInfo->HostAddr, QosPort);
+	return true;
+}
+
+void FOnlineSessionLeet::OnQosPingResult(const FString& ServerKey, int32 PingInMs)
+{
+	TSharedPtr<FOnlineSessionSearch> SessionSearch = PingedSessionSearch.Pin();
+	if (SessionSearch.IsValid())
+	{
+		for (int32 ResultIdx = 0; ResultIdx < SessionSearch->SearchResults.Num(); ResultIdx++)
+		{
+			FOnlineSessionSearchResult& Result = SessionSearch->SearchResults[ResultIdx];
+			FString ResultKey;
+			if (Result.Session.SessionSettings.Get(FName(TEXT("serverKey")), ResultKey) && ResultKey == ServerKey)
+			{
+				Result.PingInMs = PingInMs;
+				PendingSearchDelta.Update(ServerKey);
+				break;
+			}
+		}
+	}
+
+	OnSearchResultPinged.Broadcast(ServerKey, PingInMs);
+}
+
+void FOnlineSessionLeet::OnQosPingComplete()
+{
+	if (bSearchAwaitingPings)
+	{
+		bSearchAwaitingPings = false;
+		FinishSessionSearch();
+	}
+	TriggerOnPingSearchResultsCompleteDelegates(true);
 }
 
 /** Get a resolved connection string from a session info */
 static bool GetConnectStringFromSessionInfo(TSharedPtr<FOnlineSessionInfoLeet>& SessionInfo, FString& ConnectInfo, int32 PortOverride = 0)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Get Connect String"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Get Connect String"));
 	bool bSuccess = false;
 	if (SessionInfo.IsValid())
 	{
@@ -1034,7 +1285,7 @@ static bool GetConnectStringFromSessionInfo(TSharedPtr<FOnlineSessionInfoLeet>&
 
 bool FOnlineSessionLeet::GetResolvedConnectString(FName SessionName, FString& ConnectInfo)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Get Resolved Connect String"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Get Resolved Connect String"));
 	bool bSuccess = false;
 	// Find the session
 	FNamedOnlineSession* Session = GetNamedSession(SessionName);
@@ -1059,7 +1310,7 @@ bool FOnlineSessionLeet::GetResolvedConnectString(FName SessionName, FString& Co
 
 bool FOnlineSessionLeet::GetResolvedConnectString(const class FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Get Resolved Connect String 2"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Get Resolved Connect String 2"));
 	bool bSuccess = false;
 	if (SearchResult.Session.SessionInfo.IsValid())
 	{
@@ -1089,7 +1340,7 @@ bool FOnlineSessionLeet::GetResolvedConnectString(const class FOnlineSessionSear
 
 FOnlineSessionSettings* FOnlineSessionLeet::GetSessionSettings(FName SessionName)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Get Session Settings"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Get Session Settings"));
 	FNamedOnlineSession* Session = GetNamedSession(SessionName);
 	if (Session)
 	{
@@ -1100,7 +1351,7 @@ FOnlineSessionSettings* FOnlineSessionLeet::GetSessionSettings(FName SessionName
 
 void FOnlineSessionLeet::RegisterLocalPlayers(FNamedOnlineSession* Session)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Register Local Players"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Register Local Players"));
 	if (!LeetSubsystem->IsDedicated())
 	{
 		IOnlineVoicePtr VoiceInt = LeetSubsystem->GetVoiceInterface();
@@ -1149,7 +1400,7 @@ void FOnlineSessionLeet::UnregisterVoice(const FUniqueNetId& PlayerId)
 
 bool FOnlineSessionLeet::RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Register Player"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Register Player"));
 	TArray< TSharedRef<const FUniqueNetId> > Players;
 	Players.Add(MakeShareable(new FUniqueNetIdString(PlayerId)));
 	return RegisterPlayers(SessionName, Players, bWasInvited);
@@ -1157,7 +1408,7 @@ bool FOnlineSessionLeet::RegisterPlayer(FName SessionName, const FUniqueNetId& P
 
 bool FOnlineSessionLeet::RegisterPlayers(FName SessionName, const TArray< TSharedRef<const FUniqueNetId> >& Players, bool bWasInvited)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Register Players"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Register Players"));
 	bool bSuccess = false;
 	FNamedOnlineSession* Session = GetNamedSession(SessionName);
 	if (Session)
@@ -1202,7 +1453,7 @@ bool FOnlineSessionLeet::RegisterPlayers(FName SessionName, const TArray< TShare
 
 bool FOnlineSessionLeet::UnregisterPlayer(FName SessionName, const FUniqueNetId& PlayerId)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session UNRegister Player"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session UNRegister Player"));
 	TArray< TSharedRef<const FUniqueNetId> > Players;
 	Players.Add(MakeShareable(new FUniqueNetIdString(PlayerId)));
 	return UnregisterPlayers(SessionName, Players);
@@ -1210,7 +1461,7 @@ bool FOnlineSessionLeet::UnregisterPlayer(FName SessionName, const FUniqueNetId&
 
 bool FOnlineSessionLeet::UnregisterPlayers(FName SessionName, const TArray< TSharedRef<const FUniqueNetId> >& Players)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session UNRegister Players"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session UNRegister Players"));
 	bool bSuccess = true;
 
 	// TODO: inform the gameinstance that the player has left
@@ -1259,16 +1510,21 @@ void FOnlineSessionLeet::Tick(float DeltaTime)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Session_Interface);
 	TickLanTasks(DeltaTime);
+	QosPinger.Tick();
+
+	// Everything that changed this frame goes out as one batch
+	PublishSearchDelta();
 }
 
 void FOnlineSessionLeet::TickLanTasks(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_LeetLanBeacon);
 	LANSessionManager.Tick(DeltaTime);
 }
 
 void FOnlineSessionLeet::AppendSessionToPacket(FNboSerializeToBufferLeet& Packet, FOnlineSession* Session)
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Session Append to Packet"));
+	UE_LOG(LogLeet, Verbose, TEXT("[LEET] Online Session Append to Packet"));
 	/** Owner of the session */
 	Packet << *StaticCastSharedPtr<const FUniqueNetIdString>(Session->OwningUserId)
 		<< Session->OwningUserName
@@ -1335,6 +1591,7 @@ void FOnlineSessionLeet::AppendSessionSettingsToPacket(FNboSerializeToBufferLeet
 
 void FOnlineSessionLeet::OnValidQueryPacketReceived(uint8* PacketData, int32 PacketLength, uint64 ClientNonce)
 {
+	SCOPE_CYCLE_COUNTER(STAT_LeetLanBeacon);
 	// Iterate through all registered sessions and respond for each one that can be joinable
 	FScopeLock ScopeLock(&SessionLock);
 	for (int32 SessionIndex = 0; SessionIndex < Sessions.Num(); SessionIndex++)
@@ -1466,12 +1723,15 @@ void FOnlineSessionLeet::ReadSettingsFromPacket(FNboSerializeFromBufferLeet& Pac
 
 void FOnlineSessionLeet::OnValidResponsePacketReceived(uint8* PacketData, int32 PacketLength)
 {
+	SCOPE_CYCLE_COUNTER(STAT_LeetLanBeacon);
 	// Create an object that we'll copy the data to
 	FOnlineSessionSettings NewServer;
 	if (CurrentSessionSearch.IsValid())
 	{
+		TArray<FOnlineSessionSearchResult>& SearchResults = CurrentSessionSearch->SearchResults;
+
 		// Add space in the search results array
-		FOnlineSessionSearchResult* NewResult = new (CurrentSessionSearch->SearchResults) FOnlineSessionSearchResult();
+		FOnlineSessionSearchResult* NewResult = new (SearchResults) FOnlineSessionSearchResult();
 		// this is not a correct ping, but better than nothing
 		NewResult->PingInMs = static_cast<int32>((FPlatformTime::Seconds() - SessionSearchStartInSeconds) * 1000);
 
@@ -1482,7 +1742,30 @@ void FOnlineSessionLeet::OnValidResponsePacketReceived(uint8* PacketData, int32
 
 		ReadSessionFromPacket(Packet, NewSession);
 
-		// NOTE: we don't notify until the timeout happens
+		// A host that answers twice, on several interfaces for one, replaces its earlier result, keys stay unique
+		const FString SessionKey = FLeetSearchResultsDelta::GetResultKey(*NewResult);
+		int32 ExistingIdx = INDEX_NONE;
+		for (int32 ResultIdx = 0; ResultIdx < SearchResults.Num() - 1 && !SessionKey.IsEmpty(); ResultIdx++)
+		{
+			if (FLeetSearchResultsDelta::GetResultKey(SearchResults[ResultIdx]) == SessionKey)
+			{
+				ExistingIdx = ResultIdx;
+				break;
+			}
+		}
+
+		if (ExistingIdx != INDEX_NONE)
+		{
+			SearchResults[ExistingIdx] = SearchResults.Last();
+			SearchResults.Pop();
+			PendingSearchDelta.Update(SessionKey);
+		}
+		else if (!SessionKey.IsEmpty())
+		{
+			PendingSearchDelta.Add(SessionKey);
+		}
+
+		// Streaming searches see the result on the next tick, the others once the timeout completes the search
 	}
 	else
 	{
@@ -1504,9 +1787,24 @@ void FOnlineSessionLeet::OnLANSearchTimeout()
 {
 	FinalizeLANSearch();
 
+	// Online results are only sorted once their pings are in, the pinger's own timeout bounds the wait
+	if (CurrentSessionSearch.IsValid() && QosPinger.IsBusy())
+	{
+		bSearchAwaitingPings = true;
+		return;
+	}
+
+	FinishSessionSearch();
+}
+
+void FOnlineSessionLeet::FinishSessionSearch()
+{
+	// The last changes go out before the completion, so streaming consumers are complete when it arrives
+	PublishSearchDelta();
+
 	if (CurrentSessionSearch.IsValid())
 	{
-		// Allow game code to sort the servers
+		// Groups the servers by ping in buckets of PingBucketSize, game code may sort differently
 		CurrentSessionSearch->SortSearchResults();
 		CurrentSessionSearch->SearchState = EOnlineAsyncTaskState::Done;
 
@@ -6,6 +6,53 @@
 #include "OnlineSubsystemLeetTypes.h"
 #include "OnlineSubsystemLeetPackage.h"
 #include "LANBeacon.h"
+#include "LeetApiDecoder.h"
+#include "OnlineQosPingerLeet.h"
+#include "OnlineServerListCacheLeet.h"
+#include "LeetOnlineGameSettings.h"
+
+/** One entry of /api/v2/game/<key>/servers/, only the fields the session search asks for */
+struct FLeetServerEntry
+{
+	FString Key;
+	/** session_id of the entry, the key for servers that don't report one */
+	FString SessionId;
+	/** title of the entry */
+	FString Title;
+	/** session_host_address as sent, for display */
+	FString HostAddress;
+	/** session_host_address parsed at decode time, in host order, HostPort is 0 if it could not be parsed */
+	uint32 HostIp;
+	int32 HostPort;
+	/** qos_port of the entry, 0 if it has none */
+	int32 QosPort;
+
+	FLeetServerEntry()
+		: HostIp(0)
+		, HostPort(0)
+		, QosPort(0)
+	{
+	}
+
+	/** Serializes the entry for the persisted server list cache */
+	friend FArchive& operator<<(FArchive& Ar, FLeetServerEntry& Entry)
+	{
+		return Ar << Entry.Key << Entry.SessionId << Entry.Title << Entry.HostAddress << Entry.HostIp << Entry.HostPort << Entry.QosPort;
+	}
+};
+
+/** One page of /api/v2/game/<key>/servers/, or a whole list once the pages are put together */
+struct FLeetServerListResult : public FLeetApiResult
+{
+	TArray<FLeetServerEntry> Servers;
+	/** next_cursor of the page, asks for the page after it, empty on the last page */
+	FString NextCursor;
+};
+
+void LeetDecodeApiResult(const FJsonObject& JsonObject, FLeetServerListResult& OutResult);
+
+/** Called as QoS replies come in, with the serverKey of the search result and its new PingInMs */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnLeetSearchResultPinged, const FString& /*ServerKey*/, int32 /*PingInMs*/);
 
 /**
  * Interface definition for the online services session services
@@ -25,13 +72,116 @@ private:
 	/** Hidden on purpose */
 	FOnlineSessionLeet() :
 		LeetSubsystem(NULL),
+		SelfHandle(MakeShareable(new FOnlineSessionLeet*(this))),
+		ServerListPageSize(DEFAULT_SERVER_LIST_PAGE_SIZE),
+		MaxServerListSize(0),
+		bSearchAwaitingPings(false),
 		CurrentSessionSearch(NULL)
 	{}
 
+	/** Points back at this interface, work finishing after it was destroyed holds a weak reference to tell */
+	TSharedRef<FOnlineSessionLeet*, ESPMode::ThreadSafe> SelfHandle;
+
 	/**
-	* Delegate called when a user /me request from facebook is complete
+	* Delegate called when a server list page request is complete
+	*
+	* @param FetchId download the page belongs to, pages of an earlier download are dropped
+	* @param bShowingCachedList the search already shows the cached list and this request revalidates it
 	*/
-	void FindOnlineSession_HttpRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded);
+	void FindOnlineSession_HttpRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bSucceeded, uint32 FetchId, bool bShowingCachedList);
+
+	/** Last server list, shown right away by searches while it is fresh or being revalidated */
+	FOnlineServerListCacheLeet ServerListCache;
+
+	/** Most servers asked for per page, read from LeetConfig.ini */
+	int32 ServerListPageSize;
+
+	/** Most servers listed by any search, read from LeetConfig.ini, 0 leaves it to MaxSearchResults of the search */
+	int32 MaxServerListSize;
+
+	/** Server list being downloaded page by page */
+	struct FServerListFetch
+	{
+		/** Counts downloads, answers carry the id of theirs */
+		uint32 FetchId;
+		/** Search the list is for, the filters of later pages come from it */
+		TWeakPtr<FOnlineSessionSearch> SearchSettings;
+		/** The list is cached under the URL of its first page */
+		FString FirstPageUrl;
+		/** Validators of the first page */
+		FString ETag;
+		FString LastModified;
+		/** Servers of the pages so far */
+		FLeetServerListResult ServerList;
+		/** MaxSearchResults of the search capped by MaxServerListSize, no more pages are asked for once reached */
+		int32 MaxServers;
+		/** Pages asked for so far */
+		int32 NumPages;
+
+		FServerListFetch()
+			: FetchId(0)
+			, MaxServers(0)
+			, NumPages(0)
+		{
+		}
+	};
+	FServerListFetch ServerListFetch;
+
+	/**
+	 * @return URL of a page of the server list, with the search's query settings as filters
+	 *
+	 * @param Cursor next_cursor of the page before, empty for the first page
+	 * @param Limit most servers on the page
+	 */
+	FString BuildServerListUrl(const FOnlineSessionSearch& SearchSettings, const FString& Cursor, int32 Limit) const;
+
+	/** Asks for a page of the current download */
+	void RequestServerListPage(const FString& Url, bool bShowingCachedList);
+
+	/** Adds a decoded page to the search and asks for the next, or completes the download on the last one */
+	void ApplyServerListPage(uint32 FetchId, const FLeetServerListResult& Page);
+
+	/** Fills the current search with a whole server list, a cached one */
+	void ApplyServerList(const FLeetServerListResult& Result);
+
+	/** Adds the servers to the current search, updating those it has already */
+	void AddServers(const TArray<FLeetServerEntry>& Servers);
+
+	/** Removes the online results of the current search that are not in the list */
+	void RemoveUnlistedServers(const FLeetServerListResult& Result);
+
+	/** Probes the servers of online search results, on clients */
+	FOnlineQosPingerLeet QosPinger;
+
+	/** Answers the probes of clients, on dedicated servers with an online session */
+	FOnlineQosResponderLeet QosResponder;
+
+	/** Search whose results the pinger fills in and changes are published to, kept after the search completed */
+	TWeakPtr<FOnlineSessionSearch> PingedSessionSearch;
+
+	/** Changes to the results since the last tick, published to streaming searches */
+	FLeetSearchResultsDelta PendingSearchDelta;
+
+	/** Fills a search result from an entry of the server list, PingInMs is left alone */
+	void FillSearchResult(const FLeetServerEntry& Server, FOnlineSessionSearchResult& SearchResult);
+
+	/** Hands the changes since the last call to the search, if it streams */
+	void PublishSearchDelta();
+
+	/** The LAN part of the search timed out while servers were still being pinged */
+	bool bSearchAwaitingPings;
+
+	/** Writes a QoS result into the search result of that server */
+	void OnQosPingResult(const FString& ServerKey, int32 PingInMs);
+
+	/** Completes a search that waited on its pings and reports the pings as complete */
+	void OnQosPingComplete();
+
+	/** Starts the QoS responder while this dedicated server has an online session, stops it after */
+	void UpdateQosResponder();
+
+	/** Sorts the results into ping buckets and reports the search as complete */
+	void FinishSessionSearch();
 
 	// not sure if we need this yet...  looking at the facebook subsystem....
 	//IHttpRequest* FPendingSessionQuery;
@@ -181,15 +331,46 @@ PACKAGE_SCOPE:
 
 	FOnlineSessionLeet(class FOnlineSubsystemLeet* InSubsystem) :
 		LeetSubsystem(InSubsystem),
+		SelfHandle(MakeShareable(new FOnlineSessionLeet*(this))),
+		ServerListPageSize(DEFAULT_SERVER_LIST_PAGE_SIZE),
+		MaxServerListSize(0),
+		bSearchAwaitingPings(false),
 		CurrentSessionSearch(NULL),
 		SessionSearchStartInSeconds(0)
-	{}
+	{
+		QosPinger.OnPingResult.BindRaw(this, &FOnlineSessionLeet::OnQosPingResult);
+		QosPinger.OnPingComplete.BindRaw(this, &FOnlineSessionLeet::OnQosPingComplete);
+	}
+
+	/** Applies the QoS settings read from LeetConfig.ini */
+	void SetQosSettings(const FOnlineQosSettingsLeet& InSettings) { QosPinger.SetSettings(InSettings); }
+
+	/** Servers asked for per server list page unless configured otherwise */
+	static const int32 DEFAULT_SERVER_LIST_PAGE_SIZE = 50;
+
+	/** Sets the most servers asked for per server list page */
+	void SetServerListPageSize(int32 InPageSize) { ServerListPageSize = FMath::Max(InPageSize, 1); }
+
+	/** Sets the most servers any search lists, 0 for no limit beyond MaxSearchResults of the search */
+	void SetMaxServerListSize(int32 InMaxServers) { MaxServerListSize = FMath::Max(InMaxServers, 0); }
+
+	/** Sets how long server lists are cached, loading the persisted list if enabled */
+	void SetServerListCacheSettings(const FOnlineServerListCacheSettingsLeet& InSettings) { ServerListCache.SetSettings(InSettings); }
+
+	/** Drops the cached server list, the next search downloads it */
+	void InvalidateServerListCache() { ServerListCache.Invalidate(); }
+
+	/** Fired each time a QoS reply improves the ping of a result of the current or last search */
+	FOnLeetSearchResultPinged OnSearchResultPinged;
 
 	/**
 	 * Session tick for various background tasks
 	 */
 	void Tick(float DeltaTime);
 
+	/** Writes the results of the current or last session search to the given output device */
+	void DumpSearchResults(FOutputDevice& Ar) const;
+
 	// IOnlineSession
 	class FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings) override
 	{
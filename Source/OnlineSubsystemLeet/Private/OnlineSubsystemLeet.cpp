@@ -10,6 +10,8 @@
 #include "OnlineIdentityLeet.h"
 #include "VoiceInterfaceImpl.h"
 #include "OnlineAchievementsInterfaceLeet.h"
+#include "LeetHttpTransport.h"
+#include "LeetConsoleCommands.h"
 
 IOnlineSessionPtr FOnlineSubsystemLeet::GetSessionInterface() const
 {
@@ -131,6 +133,8 @@ bool FOnlineSubsystemLeet::Tick(float DeltaTime)
 	if (OnlineAsyncTaskThreadRunnable)
 	{
 		OnlineAsyncTaskThreadRunnable->GameTick();
+		// Slots freed by the tasks just finalized go to the next queued calls
+		OnlineAsyncTaskThreadRunnable->StartPendingHttpTasks();
 	}
 
 	if (SessionInterface.IsValid())
@@ -153,49 +157,123 @@ bool FOnlineSubsystemLeet::Tick(float DeltaTime)
 
 bool FOnlineSubsystemLeet::Init()
 {
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Subsystem INIT"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Subsystem INIT"));
 	const bool bLeetInit = true;
+	int32 MaxParallelApiTasks = FOnlineAsyncTaskManagerLeet::DEFAULT_MAX_PARALLEL_HTTP_TASKS;
+	FOnlineQosSettingsLeet QosSettings;
+	FOnlineServerListCacheSettingsLeet ServerListCacheSettings;
+	int32 ServerListPageSize = FOnlineSessionLeet::DEFAULT_SERVER_LIST_PAGE_SIZE;
+	int32 MaxServerListSize = 0;
 
 	_configPath = FPaths::SourceConfigDir();
 	_configPath += TEXT("LeetConfig.ini");
 
-	UE_LOG(LogTemp, Log, TEXT("[LEET] Online Subsystem set up path"));
+	UE_LOG(LogLeet, Log, TEXT("[LEET] Online Subsystem set up path"));
 
 	if (FPaths::FileExists(_configPath))
 	{
-		UE_LOG(LogTemp, Log, TEXT("[LEET] Online Subsystem File Exists"));
+		UE_LOG(LogLeet, Log, TEXT("[LEET] Online Subsystem File Exists"));
 		FConfigSection* Configs = GConfig->GetSectionPrivate(TEXT("Leet.Client"), false, true, _configPath);
 		if (Configs)
 		{
-			UE_LOG(LogTemp, Log, TEXT("[LEET] Online Subsystem Configs Exist"));
+			UE_LOG(LogLeet, Log, TEXT("[LEET] Online Subsystem Configs Exist"));
 			FString test = *Configs->Find(TEXT("APIURL"));
 
 			APIURL = *Configs->Find(TEXT("APIURL"));
 			GameKey = *Configs->Find(TEXT("GameKey"));
 
+			const FString* MaxParallelApiTasksValue = Configs->Find(TEXT("MaxParallelApiTasks"));
+			if (MaxParallelApiTasksValue)
+			{
+				MaxParallelApiTasks = FCString::Atoi(**MaxParallelApiTasksValue);
+			}
+
+			// Optional, the defaults suit a server list of a few hundred entries
+			const FString* QosValue = Configs->Find(TEXT("QosPortOffset"));
+			if (QosValue)
+			{
+				QosSettings.PortOffset = FCString::Atoi(**QosValue);
+			}
+			QosValue = Configs->Find(TEXT("QosMaxSockets"));
+			if (QosValue)
+			{
+				QosSettings.MaxSockets = FMath::Max(FCString::Atoi(**QosValue), 1);
+			}
+			QosValue = Configs->Find(TEXT("QosMaxProbesInFlight"));
+			if (QosValue)
+			{
+				QosSettings.MaxProbesInFlight = FMath::Max(FCString::Atoi(**QosValue), 1);
+			}
+			QosValue = Configs->Find(TEXT("QosProbesPerServer"));
+			if (QosValue)
+			{
+				QosSettings.ProbesPerServer = FMath::Max(FCString::Atoi(**QosValue), 1);
+			}
+			QosValue = Configs->Find(TEXT("QosTimeout"));
+			if (QosValue)
+			{
+				QosSettings.Timeout = FMath::Max(FCString::Atof(**QosValue), 0.05f);
+			}
+
+			// Optional as well, a TTL of 0 revalidates the list on every search
+			const FString* CacheValue = Configs->Find(TEXT("ServerListCacheTTL"));
+			if (CacheValue)
+			{
+				ServerListCacheSettings.TimeToLive = FMath::Max(FCString::Atof(**CacheValue), 0.0f);
+			}
+			CacheValue = Configs->Find(TEXT("ServerListCacheMaxStale"));
+			if (CacheValue)
+			{
+				ServerListCacheSettings.MaxStale = FMath::Max(FCString::Atof(**CacheValue), 0.0f);
+			}
+			CacheValue = Configs->Find(TEXT("ServerListCachePersist"));
+			if (CacheValue)
+			{
+				ServerListCacheSettings.bPersist = FCString::ToBool(**CacheValue);
+			}
+			const FString* PageSizeValue = Configs->Find(TEXT("ServerListPageSize"));
+			if (PageSizeValue)
+			{
+				ServerListPageSize = FCString::Atoi(**PageSizeValue);
+			}
+			const FString* MaxServersValue = Configs->Find(TEXT("MaxServerListSize"));
+			if (MaxServersValue)
+			{
+				MaxServerListSize = FCString::Atoi(**MaxServersValue);
+			}
+
 		}
 		else
 		{
-			UE_LOG(LogTemp, Log, TEXT("Could not find Leet.Client in LeetConfig.ini"));
+			UE_LOG(LogLeet, Log, TEXT("Could not find Leet.Client in LeetConfig.ini"));
 		}
 	}
 	else
 	{
-		UE_LOG(LogTemp, Log, TEXT("Could not find LeetConfig.ini, must Initialize manually!"));
+		UE_LOG(LogLeet, Log, TEXT("Could not find LeetConfig.ini, must Initialize manually!"));
 	}
 
 	if (bLeetInit)
 	{
-
+		// Login tracks its /me requests by pointer, a retried copy would never be matched up
+		FLeetHttpTransport::Get().SetRetryPolicy(TEXT("/me*"), FLeetRetryPolicy(1, 0.0f, 0.0f));
 
 		// Create the online async task thread
 		OnlineAsyncTaskThreadRunnable = new FOnlineAsyncTaskManagerLeet(this);
 		check(OnlineAsyncTaskThreadRunnable);
+		OnlineAsyncTaskThreadRunnable->SetMaxParallelHttpTasks(MaxParallelApiTasks);
 		OnlineAsyncTaskThread = FRunnableThread::Create(OnlineAsyncTaskThreadRunnable, *FString::Printf(TEXT("OnlineAsyncTaskThreadLeet %s"), *InstanceName.ToString()), 128 * 1024, TPri_Normal);
 		check(OnlineAsyncTaskThread);
 		UE_LOG_ONLINE(Verbose, TEXT("Created thread (ID:%d)."), OnlineAsyncTaskThread->GetThreadID());
 
+		// Leet API calls made by the plugin run as tasks of this manager from now on
+		ILeetAsyncScheduler::Register(OnlineAsyncTaskThreadRunnable);
+
 		SessionInterface = MakeShareable(new FOnlineSessionLeet(this));
+		SessionInterface->SetQosSettings(QosSettings);
+		SessionInterface->SetServerListCacheSettings(ServerListCacheSettings);
+		SessionInterface->SetServerListPageSize(ServerListPageSize);
+		SessionInterface->SetMaxServerListSize(MaxServerListSize);
 		LeaderboardsInterface = MakeShareable(new FOnlineLeaderboardsLeet(this));
 		IdentityInterface = MakeShareable(new FOnlineIdentityLeet());
 		AchievementsInterface = MakeShareable(new FOnlineAchievementsLeet(this));
@@ -219,6 +297,11 @@ bool FOnlineSubsystemLeet::Shutdown()
 
 	FOnlineSubsystemImpl::Shutdown();
 
+	if (OnlineAsyncTaskThreadRunnable)
+	{
+		ILeetAsyncScheduler::Unregister(OnlineAsyncTaskThreadRunnable);
+	}
+
 	if (OnlineAsyncTaskThread)
 	{
 		// Destroy the online async task thread
@@ -263,7 +346,38 @@ FString FOnlineSubsystemLeet::GetAppId() const
 
 bool FOnlineSubsystemLeet::Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar)
 {
-	return false;
+	if (!FParse::Command(&Cmd, TEXT("LEET")))
+	{
+		return false;
+	}
+
+	// Subsystem side state first, the plugin handles the rest
+	const TCHAR* LeetCmd = Cmd;
+	if (FParse::Command(&LeetCmd, TEXT("SERVERS")))
+	{
+		if (SessionInterface.IsValid())
+		{
+			if (FParse::Command(&LeetCmd, TEXT("FLUSH")))
+			{
+				SessionInterface->InvalidateServerListCache();
+			}
+			SessionInterface->DumpSearchResults(Ar);
+		}
+		return true;
+	}
+	LeetCmd = Cmd;
+	if (FParse::Command(&LeetCmd, TEXT("REQUESTS")) && OnlineAsyncTaskThreadRunnable)
+	{
+		// API calls queue here before they reach the transport, dumped by the plugin below
+		OnlineAsyncTaskThreadRunnable->Dump(Ar);
+	}
+
+	if (!FLeetConsoleCommands::Exec(InWorld, Cmd, Ar))
+	{
+		Ar.Logf(TEXT("LEET SERVERS [FLUSH] - server list cache and results of the current or last session search"));
+		FLeetConsoleCommands::PrintHelp(Ar);
+	}
+	return true;
 }
 
 bool FOnlineSubsystemLeet::IsEnabled()
@@ -273,7 +387,9 @@ bool FOnlineSubsystemLeet::IsEnabled()
 
 FString FOnlineSubsystemLeet::GetAPIURL()
 {
-	return APIURL;
+	// A mock API started from the console takes over until it is stopped
+	const FString OverrideURL = FLeetConsoleCommands::GetAPIURLOverride();
+	return OverrideURL.IsEmpty() ? APIURL : OverrideURL;
 }
 FString FOnlineSubsystemLeet::GetGameKey()
 {
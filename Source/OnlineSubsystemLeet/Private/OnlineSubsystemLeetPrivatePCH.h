@@ -12,6 +12,8 @@
 //#include "OnlineSessionSettingsLeet.h"
 #include "Networking.h"
 #include "ModuleManager.h"
+#include "LeetLog.h"
+#include "LeetStats.h"
 
 #define INVALID_INDEX -1
 